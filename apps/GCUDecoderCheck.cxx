@@ -0,0 +1,368 @@
+/*
+ * GCUDecoderCheck.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+// Standard
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <csignal>
+#include <cstdlib>
+#include <cmath>
+#include <random>
+#include <vector>
+using namespace std;
+
+// ROOT
+
+// MEGAlib
+#include "MGlobal.h"
+#include "MString.h"
+
+// Nuclearizer
+#include "MBinaryFlightDataParser.h"
+#include "MBinaryFlightDataFileReader.h"
+#include "GCUHousekeepingParser.h"
+#include "GCUSettingsParser.h"
+
+// The generated parsers define these, but do not declare them in their headers
+void FreeAllocatedGCUHousekeepingPacket(struct GCUHousekeepingPacket* packet);
+void FreeAllocatedGCUSettingsPacket(struct GCUSettingsPacket* packet);
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Cross-checks the direct decoding of the GCU housekeeping and settings packets in
+//! MBinaryFlightDataParser against the generated GCUHousekeepingParser and GCUSettingsParser,
+//! on random packets and optionally on the packets of a binary flight data file
+class GCUDecoderCheck
+{
+public:
+  //! Default constructor
+  GCUDecoderCheck();
+  //! Default destructor
+  ~GCUDecoderCheck();
+
+  //! Parse the command line
+  bool ParseCommandLine(int argc, char** argv);
+  //! Analyze what eveer needs to be analyzed...
+  bool Analyze();
+  //! Interrupt the analysis
+  void Interrupt() { m_Interrupt = true; }
+
+private:
+  //! Compare the decoding of a GCU housekeeping packet - return false on a mismatch
+  bool CheckHousekeeping(const uint8_t* Packet, uint16_t Length);
+  //! Compare the decoding of a GCU settings packet - return false on a mismatch
+  bool CheckSettings(const uint8_t* Packet, uint16_t Length);
+
+  //! True, if the analysis needs to be interrupted
+  bool m_Interrupt;
+
+  //! The parser whose decoding is checked
+  MBinaryFlightDataParser m_Parser;
+
+  //! The number of random packets of each type
+  unsigned int m_NRandomPackets;
+  //! The seed of the random packets
+  unsigned int m_Seed;
+  //! An optional binary flight data file
+  MString m_FileName;
+
+  //! The number of compared packets
+  unsigned long m_NChecked;
+  //! The number of mismatches
+  unsigned long m_NMismatches;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Default constructor
+GCUDecoderCheck::GCUDecoderCheck() : m_Interrupt(false), m_NRandomPackets(100000), m_Seed(1), m_NChecked(0), m_NMismatches(0)
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Default destructor
+GCUDecoderCheck::~GCUDecoderCheck()
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Parse the command line
+bool GCUDecoderCheck::ParseCommandLine(int argc, char** argv)
+{
+  ostringstream Usage;
+  Usage<<endl;
+  Usage<<"  Usage: GCUDecoderCheck <options>"<<endl;
+  Usage<<"    General options:"<<endl;
+  Usage<<"         -n:   number of random packets of each type (default: 100000)"<<endl;
+  Usage<<"         -s:   seed of the random packets (default: 1)"<<endl;
+  Usage<<"         -f:   also check all GCU packets of this binary flight data file"<<endl;
+  Usage<<"         -h:   print this help"<<endl;
+  Usage<<endl;
+
+  string Option;
+
+  // Check for help
+  for (int i = 1; i < argc; i++) {
+    Option = argv[i];
+    if (Option == "-h" || Option == "--help" || Option == "?" || Option == "-?") {
+      cout<<Usage.str()<<endl;
+      return false;
+    }
+  }
+
+  // Now parse the command line options:
+  for (int i = 1; i < argc; i++) {
+    Option = argv[i];
+
+    // First check if each option has sufficient arguments:
+    // Single argument
+    if (Option == "-n" || Option == "-s" || Option == "-f") {
+      if (!((argc > i+1) &&
+            (argv[i+1][0] != '-' || isalpha(argv[i+1][1]) == 0))){
+        cout<<"Error: Option "<<argv[i][1]<<" needs a second argument!"<<endl;
+        cout<<Usage.str()<<endl;
+        return false;
+      }
+    }
+
+    // Then fulfill the options:
+    if (Option == "-n") {
+      m_NRandomPackets = atoi(argv[++i]);
+      cout<<"Accepting number of random packets: "<<m_NRandomPackets<<endl;
+    } else if (Option == "-s") {
+      m_Seed = atoi(argv[++i]);
+      cout<<"Accepting seed: "<<m_Seed<<endl;
+    } else if (Option == "-f") {
+      m_FileName = argv[++i];
+      cout<<"Accepting file name: "<<m_FileName<<endl;
+    } else {
+      cout<<"Error: Unknown option \""<<Option<<"\"!"<<endl;
+      cout<<Usage.str()<<endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Compare the decoding of a GCU housekeeping packet - return false on a mismatch
+bool GCUDecoderCheck::CheckHousekeeping(const uint8_t* Packet, uint16_t Length)
+{
+  uint8_t UnixTimeMSB = 0;
+  double ShieldCountRate = 0;
+  if (m_Parser.DecodeGCUHousekeeping(MBinaryFlightDataParser::packet(Packet, Length), UnixTimeMSB, ShieldCountRate) == false) {
+    // Too short for the direct decoding, and thus for the generated parser, too
+    return true;
+  }
+
+  // The generated parser reads all shield samples, thus it needs the full packet
+  uint8_t NumSamples = (Length > 342) ? Packet[342] : 0;
+  if (Length < 343 + 9*NumSamples) return true;
+
+  ++m_NChecked;
+
+  GCUHousekeepingPacket* Reference = ParseGCUHousekeepingPacket(Packet);
+
+  bool IsGood = true;
+  if (UnixTimeMSB != Reference->UnixTimeMSB) {
+    cout<<"Mismatch: GCU housekeeping Unix time MSB: "<<(int) UnixTimeMSB<<" instead of "<<(int) Reference->UnixTimeMSB<<endl;
+    IsGood = false;
+  }
+  if (NumSamples > 0) {
+    double ReferenceRate = static_cast<double>(Reference->NumCounts[0])/(static_cast<double>(Reference->TimeInterval[0])*1e-7);
+    if (ShieldCountRate != ReferenceRate && !(std::isnan(ShieldCountRate) && std::isnan(ReferenceRate))) {
+      cout<<"Mismatch: GCU housekeeping shield count rate: "<<ShieldCountRate<<" instead of "<<ReferenceRate<<endl;
+      IsGood = false;
+    }
+  } else if (ShieldCountRate != 0) {
+    cout<<"Mismatch: GCU housekeeping shield count rate without samples: "<<ShieldCountRate<<" instead of 0"<<endl;
+    IsGood = false;
+  }
+
+  FreeAllocatedGCUHousekeepingPacket(Reference);
+  free(Reference);
+
+  if (IsGood == false) ++m_NMismatches;
+
+  return IsGood;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Compare the decoding of a GCU settings packet - return false on a mismatch
+bool GCUDecoderCheck::CheckSettings(const uint8_t* Packet, uint16_t Length)
+{
+  if (m_Parser.DecodePreampTemperatures(MBinaryFlightDataParser::packet(Packet, Length)) == false) {
+    return true;
+  }
+
+  // The generated parser reads up to byte 199
+  if (Length < 200) return true;
+
+  ++m_NChecked;
+
+  GCUSettingsPacket* Reference = ParseGCUSettingsPacket(Packet);
+
+  // The order of the preamp temperatures: Det0 DC, Det0 AC, Det1 DC, Det1 AC, ...
+  uint16_t Expected[24] = {
+    Reference->RpiTemp_Brd2_Ch0, Reference->RpiTemp_Brd2_Ch3, Reference->RpiTemp_Brd0_Ch6, Reference->RpiTemp_Brd2_Ch2,
+    Reference->RpiTemp_Brd0_Ch7, Reference->RpiTemp_Brd2_Ch1, Reference->RpiTemp_Brd1_Ch6, Reference->RpiTemp_Brd2_Ch4,
+    Reference->RpiTemp_Brd1_Ch7, Reference->RpiTemp_Brd2_Ch5, Reference->RpiTemp_Brd2_Ch7, Reference->RpiTemp_Brd2_Ch6,
+    Reference->RpiTemp_Brd1_Ch5, Reference->RpiTemp_Brd1_Ch2, Reference->RpiTemp_Brd1_Ch4, Reference->RpiTemp_Brd1_Ch1,
+    Reference->RpiTemp_Brd1_Ch3, Reference->RpiTemp_Brd1_Ch0, Reference->RpiTemp_Brd0_Ch3, Reference->RpiTemp_Brd0_Ch0,
+    Reference->RpiTemp_Brd0_Ch4, Reference->RpiTemp_Brd0_Ch1, Reference->RpiTemp_Brd0_Ch5, Reference->RpiTemp_Brd0_Ch2
+  };
+
+  bool IsGood = true;
+  const vector<uint16_t>& PreampTemps = m_Parser.GetPreampTemperatures();
+  for (unsigned int i = 0; i < 24; ++i) {
+    if (PreampTemps[i] != Expected[i]) {
+      cout<<"Mismatch: GCU settings preamp temperature "<<i<<": "<<PreampTemps[i]<<" instead of "<<Expected[i]<<endl;
+      IsGood = false;
+    }
+  }
+
+  FreeAllocatedGCUSettingsPacket(Reference);
+  free(Reference);
+
+  if (IsGood == false) ++m_NMismatches;
+
+  return IsGood;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Do whatever analysis is necessary
+bool GCUDecoderCheck::Analyze()
+{
+  // Random packets: the header does not matter, the number of shield samples is kept within the packet
+  mt19937 Random(m_Seed);
+  uniform_int_distribution<int> Byte(0, 255);
+  vector<uint8_t> Packet(MBinaryFlightDataFileReader::c_MaxPacketLength);
+  uint8_t MaxSamples = (Packet.size() - 343)/9;
+
+  for (unsigned int n = 0; n < m_NRandomPackets && m_Interrupt == false; ++n) {
+    for (uint8_t& B: Packet) B = Byte(Random);
+    Packet[342] = Byte(Random) % (MaxSamples + 1);
+    CheckHousekeeping(Packet.data(), Packet.size());
+    CheckSettings(Packet.data(), Packet.size());
+  }
+  cout<<"Random packets: "<<m_NChecked<<" checked, "<<m_NMismatches<<" mismatches"<<endl;
+
+  // All GCU housekeeping and settings packets of a file
+  if (m_FileName != "") {
+    unsigned long NChecked = m_NChecked;
+    unsigned long NMismatches = m_NMismatches;
+
+    MBinaryFlightDataFileReader Reader;
+    if (Reader.Open(m_FileName) == false) {
+      return false;
+    }
+    while (m_Interrupt == false && Reader.Next() == true) {
+      uint8_t Type = Reader.GetPacket()[2] & 0x0f;
+      if (Type == 0x07) {
+        CheckHousekeeping(Reader.GetPacket(), Reader.GetLength());
+      } else if (Type == 0x0b) {
+        CheckSettings(Reader.GetPacket(), Reader.GetLength());
+      }
+    }
+    bool HasError = Reader.HasError();
+    Reader.Close();
+    if (HasError == true) {
+      cout<<"Error: Unable to read all of file "<<m_FileName<<endl;
+      return false;
+    }
+
+    cout<<"Packets of "<<m_FileName<<": "<<m_NChecked - NChecked<<" checked, "<<m_NMismatches - NMismatches<<" mismatches"<<endl;
+  }
+
+  return m_NMismatches == 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+GCUDecoderCheck* g_Prg = 0;
+int g_NInterruptCatches = 1;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Called when an interrupt signal is flagged
+//! All catched signals lead to a well defined exit of the program
+void CatchSignal(int a)
+{
+  if (g_Prg != 0 && g_NInterruptCatches-- > 0) {
+    cout<<"Catched signal Ctrl-C (ID="<<a<<"):"<<endl;
+    g_Prg->Interrupt();
+  } else {
+    abort();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Main program
+int main(int argc, char** argv)
+{
+  // Catch a user interupt for graceful shutdown
+  signal(SIGINT, CatchSignal);
+
+  // Initialize global MEGALIB variables, especially mgui, etc.
+  MGlobal::Initialize("GCUDecoderCheck", "cross-checks the GCU packet decoding against the generated parsers");
+
+  g_Prg = new GCUDecoderCheck();
+
+  if (g_Prg->ParseCommandLine(argc, argv) == false) {
+    cerr<<"Error during parsing of command line!"<<endl;
+    return -1;
+  }
+  if (g_Prg->Analyze() == false) {
+    cerr<<"Error during analysis!"<<endl;
+    return -2;
+  }
+
+  cout<<"Program exited normally!"<<endl;
+
+  return 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,241 @@
+/*
+ * HousekeepingToText.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+// Standard
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <sstream>
+#include <csignal>
+#include <cstdlib>
+using namespace std;
+
+// ROOT
+
+// MEGAlib
+#include "MGlobal.h"
+#include "MString.h"
+
+// Nuclearizer
+#include "MHousekeepingReader.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Converts a binary columnar housekeeping file (".hkb") into the text form (".hkp")
+class HousekeepingToText
+{
+public:
+  //! Default constructor
+  HousekeepingToText();
+  //! Default destructor
+  ~HousekeepingToText();
+
+  //! Parse the command line
+  bool ParseCommandLine(int argc, char** argv);
+  //! Analyze what eveer needs to be analyzed...
+  bool Analyze();
+  //! Interrupt the analysis
+  void Interrupt() { m_Interrupt = true; }
+
+private:
+  //! True, if the analysis needs to be interrupted
+  bool m_Interrupt;
+
+  //! The binary housekeeping file
+  MString m_InputFileName;
+  //! The text housekeeping file
+  MString m_OutputFileName;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Default constructor
+HousekeepingToText::HousekeepingToText() : m_Interrupt(false)
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Default destructor
+HousekeepingToText::~HousekeepingToText()
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Parse the command line
+bool HousekeepingToText::ParseCommandLine(int argc, char** argv)
+{
+  ostringstream Usage;
+  Usage<<endl;
+  Usage<<"  Usage: HousekeepingToText <options>"<<endl;
+  Usage<<"    General options:"<<endl;
+  Usage<<"         -i:   binary housekeeping file (.hkb)"<<endl;
+  Usage<<"         -o:   text housekeeping file (default: the input file with the suffix .hkp)"<<endl;
+  Usage<<"         -h:   print this help"<<endl;
+  Usage<<endl;
+
+  string Option;
+
+  // Check for help
+  for (int i = 1; i < argc; i++) {
+    Option = argv[i];
+    if (Option == "-h" || Option == "--help" || Option == "?" || Option == "-?") {
+      cout<<Usage.str()<<endl;
+      return false;
+    }
+  }
+
+  // Now parse the command line options:
+  for (int i = 1; i < argc; i++) {
+    Option = argv[i];
+
+    // First check if each option has sufficient arguments:
+    // Single argument
+    if (Option == "-i" || Option == "-o") {
+      if (!((argc > i+1) &&
+            (argv[i+1][0] != '-' || isalpha(argv[i+1][1]) == 0))){
+        cout<<"Error: Option "<<argv[i][1]<<" needs a second argument!"<<endl;
+        cout<<Usage.str()<<endl;
+        return false;
+      }
+    }
+
+    // Then fulfill the options:
+    if (Option == "-i") {
+      m_InputFileName = argv[++i];
+      cout<<"Accepting input file name: "<<m_InputFileName<<endl;
+    } else if (Option == "-o") {
+      m_OutputFileName = argv[++i];
+      cout<<"Accepting output file name: "<<m_OutputFileName<<endl;
+    } else {
+      cout<<"Error: Unknown option \""<<Option<<"\"!"<<endl;
+      cout<<Usage.str()<<endl;
+      return false;
+    }
+  }
+
+  if (m_InputFileName == "") {
+    cout<<"Error: You need to give an input file!"<<endl;
+    cout<<Usage.str()<<endl;
+    return false;
+  }
+
+  if (m_OutputFileName == "") {
+    m_OutputFileName = m_InputFileName;
+    if (m_OutputFileName.Last('.') != string::npos) {
+      m_OutputFileName.RemoveInPlace(m_OutputFileName.Last('.'), m_OutputFileName.Length() - m_OutputFileName.Last('.'));
+    }
+    m_OutputFileName += ".hkp";
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Do whatever analysis is necessary
+bool HousekeepingToText::Analyze()
+{
+  MHousekeepingReader Reader;
+  if (Reader.Open(m_InputFileName) == false) {
+    return false;
+  }
+
+  ofstream out;
+  out.open(m_OutputFileName.Data());
+  if (out.is_open() == false) {
+    cout<<"Error: Unable to open output file "<<m_OutputFileName<<endl;
+    return false;
+  }
+
+  unsigned long NRecords = 0;
+  while (m_Interrupt == false && Reader.ReadGroup() == true) {
+    Reader.WriteGroupText(out);
+    NRecords += Reader.GetAspects().size() + Reader.GetLivetimes().size() + Reader.GetGCUHousekeeping().size();
+  }
+  out.close();
+
+  cout<<"Converted "<<NRecords<<" housekeeping records into "<<m_OutputFileName<<endl;
+
+  return Reader.HasError() == false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+HousekeepingToText* g_Prg = 0;
+int g_NInterruptCatches = 1;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Called when an interrupt signal is flagged
+//! All catched signals lead to a well defined exit of the program
+void CatchSignal(int a)
+{
+  if (g_Prg != 0 && g_NInterruptCatches-- > 0) {
+    cout<<"Catched signal Ctrl-C (ID="<<a<<"):"<<endl;
+    g_Prg->Interrupt();
+  } else {
+    abort();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Main program
+int main(int argc, char** argv)
+{
+  // Catch a user interupt for graceful shutdown
+  signal(SIGINT, CatchSignal);
+
+  // Initialize global MEGALIB variables, especially mgui, etc.
+  MGlobal::Initialize("HousekeepingToText", "converts binary housekeeping files into text");
+
+  g_Prg = new HousekeepingToText();
+
+  if (g_Prg->ParseCommandLine(argc, argv) == false) {
+    cerr<<"Error during parsing of command line!"<<endl;
+    return -1;
+  }
+  if (g_Prg->Analyze() == false) {
+    cerr<<"Error during analysis!"<<endl;
+    return -2;
+  }
+
+  cout<<"Program exited normally!"<<endl;
+
+  return 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,587 @@
+/*
+ * ModuleBenchmark.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+// Standard
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <csignal>
+#include <cstdlib>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <new>
+using namespace std;
+
+// ROOT
+#include <TROOT.h>
+#include <TEnv.h>
+#include <TSystem.h>
+#include <TApplication.h>
+
+// MEGAlib
+#include "MGlobal.h"
+#include "MFile.h"
+#include "MString.h"
+#include "MTokenizer.h"
+#include "MSupervisor.h"
+#include "MDGeometryQuest.h"
+
+// Nuclearizer
+#include "MReadOutAssembly.h"
+#include "MObjectPool.h"
+#include "MSyntheticEventGenerator.h"
+#include "MModuleEnergyCalibrationUniversal.h"
+#include "MModuleCrosstalkCorrection.h"
+#include "MModuleStripPairingGreedy.h"
+#include "MModuleDepthCalibration2024.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! The number of calls to operator new - counts all allocations of the program
+atomic<unsigned long> g_NAllocations(0);
+
+
+void* operator new(size_t Size)
+{
+  ++g_NAllocations;
+  void* P = malloc(Size > 0 ? Size : 1);
+  if (P == nullptr) throw bad_alloc();
+  return P;
+}
+
+
+void* operator new[](size_t Size)
+{
+  ++g_NAllocations;
+  void* P = malloc(Size > 0 ? Size : 1);
+  if (P == nullptr) throw bad_alloc();
+  return P;
+}
+
+
+void operator delete(void* P) noexcept { free(P); }
+void operator delete[](void* P) noexcept { free(P); }
+void operator delete(void* P, size_t) noexcept { free(P); }
+void operator delete[](void* P, size_t) noexcept { free(P); }
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Drives the calibration modules one at a time with synthetic events and measures
+//! the time and the number of allocations per event as a function of the multiplicity
+class ModuleBenchmark
+{
+public:
+  //! Default constructor
+  ModuleBenchmark();
+  //! Default destructor
+  ~ModuleBenchmark();
+
+  //! Parse the command line
+  bool ParseCommandLine(int argc, char** argv);
+  //! Analyze what eveer needs to be analyzed...
+  bool Analyze();
+  //! Interrupt the analysis
+  void Interrupt() { m_Interrupt = true; }
+
+private:
+  //! Set up the modules - returns false if a requested module cannot be initialized
+  bool CreateModules();
+  //! Benchmark one module at one multiplicity, the prerequisites run untimed before
+  bool Benchmark(MModule* Module, const vector<MModule*>& Prerequisites, unsigned int Multiplicity,
+                 double& NanosecondsPerEvent, double& AllocationsPerEvent);
+  //! Parse a comma separated list of integers
+  vector<int> ParseList(const MString& List);
+
+  //! True, if the analysis needs to be interrupted
+  bool m_Interrupt;
+
+  //! The modules to benchmark
+  vector<MString> m_ModuleNames;
+  //! The number of timed events per measurement
+  unsigned int m_NEvents;
+  //! The multiplicities
+  vector<int> m_Multiplicities;
+  //! The detectors
+  vector<int> m_Detectors;
+  //! The number of strips per side
+  unsigned int m_NStrips;
+  //! The charge sharing probability
+  double m_ChargeSharing;
+  //! The event rate
+  double m_EventRate;
+  //! The seed
+  unsigned int m_Seed;
+
+  //! The energy calibration file
+  MString m_EnergyCalibrationFileName;
+  //! The cross-talk calibration file
+  MString m_CrosstalkFileName;
+  //! The geometry file
+  MString m_GeometryFileName;
+  //! The depth calibration coefficients file
+  MString m_DepthCoeffsFileName;
+  //! The depth calibration splines file
+  MString m_DepthSplinesFileName;
+  //! The depth calibration TAC calibration file
+  MString m_DepthTACCalFileName;
+
+  //! The event generator
+  MSyntheticEventGenerator m_Generator;
+  //! The geometry
+  MDGeometryQuest* m_Geometry;
+
+  //! The modules
+  MModuleEnergyCalibrationUniversal* m_EnergyCalibration;
+  MModuleCrosstalkCorrection* m_CrosstalkCorrection;
+  MModuleStripPairingGreedy* m_StripPairing;
+  MModuleDepthCalibration2024* m_DepthCalibration;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Default constructor
+ModuleBenchmark::ModuleBenchmark() : m_Interrupt(false)
+{
+  m_NEvents = 10000;
+  m_Multiplicities = { 1, 2, 3, 4, 6, 8 };
+  for (int d = 0; d < 12; ++d) m_Detectors.push_back(d);
+  m_NStrips = 37;
+  m_ChargeSharing = 0.1;
+  m_EventRate = 1000;
+  m_Seed = 20170912;
+
+  m_EnergyCalibrationFileName = "$(NUCLEARIZER)/resource/calibration/COSI20/Wanaka/ecal_Wanaka2020.ecal";
+  m_CrosstalkFileName = "$(NUCLEARIZER)/resource/calibration/COSI20/Wanaka/CrossTalkCorrection_Wanaka2020.txt";
+  m_GeometryFileName = "";
+  m_DepthCoeffsFileName = "";
+  m_DepthSplinesFileName = "";
+  m_DepthTACCalFileName = "";
+
+  m_Geometry = nullptr;
+  m_EnergyCalibration = nullptr;
+  m_CrosstalkCorrection = nullptr;
+  m_StripPairing = nullptr;
+  m_DepthCalibration = nullptr;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Default destructor
+ModuleBenchmark::~ModuleBenchmark()
+{
+  // The modules are owned by the supervisor
+  delete m_Geometry;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Parse the command line
+bool ModuleBenchmark::ParseCommandLine(int argc, char** argv)
+{
+  ostringstream Usage;
+  Usage<<endl;
+  Usage<<"  Usage: ModuleBenchmark <options>"<<endl;
+  Usage<<"    General options:"<<endl;
+  Usage<<"         -m:   module to benchmark: energy, crosstalk, pairing, depth (can be used multiple times, default: all but depth)"<<endl;
+  Usage<<"         -n:   number of timed events per measurement (default: 10000)"<<endl;
+  Usage<<"         -M:   comma separated list of multiplicities (default: 1,2,3,4,6,8)"<<endl;
+  Usage<<"         -s:   charge sharing probability per interaction and side (default: 0.1)"<<endl;
+  Usage<<"         -d:   comma separated list of detector IDs (default: 0,...,11)"<<endl;
+  Usage<<"         -t:   number of strips per side (default: 37)"<<endl;
+  Usage<<"         -r:   event rate in Hz (default: 1000)"<<endl;
+  Usage<<"         -S:   random seed"<<endl;
+  Usage<<"    Calibration options:"<<endl;
+  Usage<<"         -e:   energy calibration file (default: resource/calibration/COSI20/Wanaka/ecal_Wanaka2020.ecal)"<<endl;
+  Usage<<"         -x:   cross-talk calibration file (default: resource/calibration/COSI20/Wanaka/CrossTalkCorrection_Wanaka2020.txt)"<<endl;
+  Usage<<"         -g:   geometry file (needed for depth)"<<endl;
+  Usage<<"         -c:   depth calibration coefficients file (needed for depth)"<<endl;
+  Usage<<"         -p:   depth calibration splines file (needed for depth)"<<endl;
+  Usage<<"         -a:   depth calibration TAC calibration file"<<endl;
+  Usage<<"         -h:   print this help"<<endl;
+  Usage<<endl;
+
+  string Option;
+
+  // Check for help
+  for (int i = 1; i < argc; i++) {
+    Option = argv[i];
+    if (Option == "-h" || Option == "--help" || Option == "?" || Option == "-?") {
+      cout<<Usage.str()<<endl;
+      return false;
+    }
+  }
+
+  // Now parse the command line options:
+  for (int i = 1; i < argc; i++) {
+    Option = argv[i];
+
+    // First check if each option has sufficient arguments:
+    // Single argument
+    if (Option == "-m" || Option == "-n" || Option == "-M" || Option == "-s" || Option == "-d" ||
+        Option == "-t" || Option == "-r" || Option == "-S" || Option == "-e" || Option == "-x" ||
+        Option == "-g" || Option == "-c" || Option == "-p" || Option == "-a") {
+      if (!((argc > i+1) &&
+            (argv[i+1][0] != '-' || isalpha(argv[i+1][1]) == 0))){
+        cout<<"Error: Option "<<argv[i][1]<<" needs a second argument!"<<endl;
+        cout<<Usage.str()<<endl;
+        return false;
+      }
+    }
+
+    // Then fulfill the options:
+    if (Option == "-m") {
+      m_ModuleNames.push_back(argv[++i]);
+      cout<<"Accepting module: "<<m_ModuleNames.back()<<endl;
+    } else if (Option == "-n") {
+      m_NEvents = atoi(argv[++i]);
+      cout<<"Accepting number of events: "<<m_NEvents<<endl;
+    } else if (Option == "-M") {
+      m_Multiplicities = ParseList(argv[++i]);
+      cout<<"Accepting multiplicities: "<<argv[i]<<endl;
+    } else if (Option == "-s") {
+      m_ChargeSharing = atof(argv[++i]);
+      cout<<"Accepting charge sharing probability: "<<m_ChargeSharing<<endl;
+    } else if (Option == "-d") {
+      m_Detectors = ParseList(argv[++i]);
+      cout<<"Accepting detectors: "<<argv[i]<<endl;
+    } else if (Option == "-t") {
+      m_NStrips = atoi(argv[++i]);
+      cout<<"Accepting number of strips: "<<m_NStrips<<endl;
+    } else if (Option == "-r") {
+      m_EventRate = atof(argv[++i]);
+      cout<<"Accepting event rate: "<<m_EventRate<<endl;
+    } else if (Option == "-S") {
+      m_Seed = atoi(argv[++i]);
+      cout<<"Accepting seed: "<<m_Seed<<endl;
+    } else if (Option == "-e") {
+      m_EnergyCalibrationFileName = argv[++i];
+      cout<<"Accepting energy calibration file: "<<m_EnergyCalibrationFileName<<endl;
+    } else if (Option == "-x") {
+      m_CrosstalkFileName = argv[++i];
+      cout<<"Accepting cross-talk file: "<<m_CrosstalkFileName<<endl;
+    } else if (Option == "-g") {
+      m_GeometryFileName = argv[++i];
+      cout<<"Accepting geometry file: "<<m_GeometryFileName<<endl;
+    } else if (Option == "-c") {
+      m_DepthCoeffsFileName = argv[++i];
+      cout<<"Accepting depth coefficients file: "<<m_DepthCoeffsFileName<<endl;
+    } else if (Option == "-p") {
+      m_DepthSplinesFileName = argv[++i];
+      cout<<"Accepting depth splines file: "<<m_DepthSplinesFileName<<endl;
+    } else if (Option == "-a") {
+      m_DepthTACCalFileName = argv[++i];
+      cout<<"Accepting depth TAC calibration file: "<<m_DepthTACCalFileName<<endl;
+    } else {
+      cout<<"Error: Unknown option \""<<Option<<"\"!"<<endl;
+      cout<<Usage.str()<<endl;
+      return false;
+    }
+  }
+
+  if (m_ModuleNames.size() == 0) {
+    m_ModuleNames = { "energy", "crosstalk", "pairing" };
+  }
+  for (MString Name: m_ModuleNames) {
+    if (Name != "energy" && Name != "crosstalk" && Name != "pairing" && Name != "depth") {
+      cout<<"Error: Unknown module \""<<Name<<"\"!"<<endl;
+      cout<<Usage.str()<<endl;
+      return false;
+    }
+    if (Name == "depth" && (m_GeometryFileName == "" || m_DepthCoeffsFileName == "" || m_DepthSplinesFileName == "")) {
+      cout<<"Error: The depth calibration needs a geometry (-g), a coefficients file (-c), and a splines file (-p)!"<<endl;
+      return false;
+    }
+  }
+  if (m_Multiplicities.size() == 0 || m_Detectors.size() == 0 || m_NEvents == 0) {
+    cout<<"Error: Need at least one multiplicity, one detector, and one event!"<<endl;
+    return false;
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Parse a comma separated list of integers
+vector<int> ModuleBenchmark::ParseList(const MString& List)
+{
+  vector<int> Values;
+
+  MString Copy = List;
+  Copy.ReplaceAll(",", " ");
+  MTokenizer Tokenizer;
+  Tokenizer.Analyse(Copy);
+  for (unsigned int t = 0; t < Tokenizer.GetNTokens(); ++t) {
+    Values.push_back(Tokenizer.GetTokenAtAsInt(t));
+  }
+
+  return Values;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Set up the modules - returns false if a requested module cannot be initialized
+bool ModuleBenchmark::CreateModules()
+{
+  MSupervisor* S = MSupervisor::GetSupervisor();
+
+  if (m_GeometryFileName != "") {
+    MFile::ExpandFileName(m_GeometryFileName);
+    m_Geometry = new MDGeometryQuest();
+    if (m_Geometry->ScanSetupFile(m_GeometryFileName) == false) {
+      cout<<"Unable to load geometry: "<<m_GeometryFileName<<endl;
+      return false;
+    }
+  }
+
+  // The depth calibration looks up the energy calibration in the supervisor, thus always create it
+  MFile::ExpandFileName(m_EnergyCalibrationFileName);
+  m_EnergyCalibration = new MModuleEnergyCalibrationUniversal();
+  m_EnergyCalibration->SetFileName(m_EnergyCalibrationFileName);
+  m_EnergyCalibration->EnablePreampTempCorrection(false);
+  S->AddAvailableModule(m_EnergyCalibration);
+
+  m_CrosstalkCorrection = new MModuleCrosstalkCorrection();
+  MFile::ExpandFileName(m_CrosstalkFileName);
+  m_CrosstalkCorrection->SetFileName(m_CrosstalkFileName);
+  S->AddAvailableModule(m_CrosstalkCorrection);
+
+  m_StripPairing = new MModuleStripPairingGreedy();
+  S->AddAvailableModule(m_StripPairing);
+
+  m_DepthCalibration = new MModuleDepthCalibration2024();
+  MFile::ExpandFileName(m_DepthCoeffsFileName);
+  MFile::ExpandFileName(m_DepthSplinesFileName);
+  MFile::ExpandFileName(m_DepthTACCalFileName);
+  m_DepthCalibration->SetCoeffsFileName(m_DepthCoeffsFileName);
+  m_DepthCalibration->SetSplinesFileName(m_DepthSplinesFileName);
+  m_DepthCalibration->SetTACCalFileName(m_DepthTACCalFileName);
+  S->AddAvailableModule(m_DepthCalibration);
+
+  bool NeedsPairing = false;
+  bool NeedsDepth = false;
+  bool NeedsCrosstalk = false;
+  for (MString Name: m_ModuleNames) {
+    if (Name == "crosstalk") NeedsCrosstalk = true;
+    if (Name == "pairing" || Name == "depth") NeedsPairing = true;
+    if (Name == "depth") NeedsDepth = true;
+  }
+
+  if (m_EnergyCalibration->Initialize() == false) {
+    cout<<"Unable to initialize the energy calibration with "<<m_EnergyCalibrationFileName<<endl;
+    return false;
+  }
+  if (NeedsCrosstalk == true && m_CrosstalkCorrection->Initialize() == false) {
+    cout<<"Unable to initialize the cross-talk correction with "<<m_CrosstalkFileName<<endl;
+    return false;
+  }
+  if (NeedsPairing == true && m_StripPairing->Initialize() == false) {
+    cout<<"Unable to initialize the strip pairing"<<endl;
+    return false;
+  }
+  if (NeedsDepth == true) {
+    m_DepthCalibration->SetGeometry(m_Geometry);
+    if (m_DepthCalibration->Initialize() == false) {
+      cout<<"Unable to initialize the depth calibration"<<endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Benchmark one module at one multiplicity, the prerequisites run untimed before
+bool ModuleBenchmark::Benchmark(MModule* Module, const vector<MModule*>& Prerequisites, unsigned int Multiplicity,
+                                double& NanosecondsPerEvent, double& AllocationsPerEvent)
+{
+  m_Generator.SetMultiplicity(Multiplicity);
+
+  // One untimed warm-up round fills the object pools and the caches
+  unsigned int NWarmUp = max(100U, m_NEvents/10);
+
+  vector<MReadOutAssembly*> Events;
+  Events.reserve(m_NEvents);
+
+  for (unsigned int Round = 0; Round < 2; ++Round) {
+    unsigned int N = (Round == 0) ? NWarmUp : m_NEvents;
+
+    for (unsigned int e = 0; e < N; ++e) {
+      MReadOutAssembly* Event = MObjectPool<MReadOutAssembly>::Get();
+      m_Generator.Generate(Event);
+      for (MModule* P: Prerequisites) {
+        P->AnalyzeEvent(Event);
+      }
+      Events.push_back(Event);
+    }
+
+    unsigned long NAllocations = g_NAllocations;
+    chrono::steady_clock::time_point Start = chrono::steady_clock::now();
+    for (MReadOutAssembly* Event: Events) {
+      Module->AnalyzeEvent(Event);
+    }
+    chrono::steady_clock::time_point Stop = chrono::steady_clock::now();
+    NAllocations = g_NAllocations - NAllocations;
+
+    for (MReadOutAssembly* Event: Events) {
+      MObjectPool<MReadOutAssembly>::Release(Event);
+    }
+    Events.clear();
+
+    if (Round == 1) {
+      NanosecondsPerEvent = chrono::duration<double, nano>(Stop - Start).count()/N;
+      AllocationsPerEvent = double(NAllocations)/N;
+    }
+
+    if (m_Interrupt == true) return false;
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Do whatever analysis is necessary
+bool ModuleBenchmark::Analyze()
+{
+  if (m_Interrupt == true) return false;
+
+  if (CreateModules() == false) return false;
+
+  m_Generator.SetSeed(m_Seed);
+  m_Generator.SetDetectors(m_Detectors);
+  m_Generator.SetNStrips(m_NStrips);
+  m_Generator.SetChargeSharingProbability(m_ChargeSharing);
+  m_Generator.SetEventRate(m_EventRate);
+
+  cout<<endl;
+  cout<<"Module benchmark with "<<m_NEvents<<" events per measurement, charge sharing probability "<<m_ChargeSharing
+      <<", "<<m_Detectors.size()<<" detectors, "<<m_NStrips<<" strips per side"<<endl;
+  cout<<endl;
+  cout<<setw(12)<<left<<"Module"<<setw(14)<<right<<"Multiplicity"<<setw(14)<<"ns/event"<<setw(16)<<"allocs/event"
+      <<setw(14)<<"events/s"<<setw(20)<<"ns/event vs. first"<<endl;
+
+  for (MString Name: m_ModuleNames) {
+    MModule* Module = nullptr;
+    vector<MModule*> Prerequisites;
+    if (Name == "energy") {
+      Module = m_EnergyCalibration;
+    } else if (Name == "crosstalk") {
+      Module = m_CrosstalkCorrection;
+    } else if (Name == "pairing") {
+      Module = m_StripPairing;
+    } else if (Name == "depth") {
+      Module = m_DepthCalibration;
+      Prerequisites.push_back(m_StripPairing);
+    }
+
+    double FirstNanosecondsPerEvent = 0;
+    for (unsigned int m = 0; m < m_Multiplicities.size(); ++m) {
+      double NanosecondsPerEvent = 0;
+      double AllocationsPerEvent = 0;
+      if (Benchmark(Module, Prerequisites, m_Multiplicities[m], NanosecondsPerEvent, AllocationsPerEvent) == false) break;
+      if (m == 0) FirstNanosecondsPerEvent = NanosecondsPerEvent;
+
+      cout<<setw(12)<<left<<Name<<setw(14)<<right<<m_Multiplicities[m]
+          <<setw(14)<<fixed<<setprecision(1)<<NanosecondsPerEvent
+          <<setw(16)<<setprecision(2)<<AllocationsPerEvent
+          <<setw(14)<<setprecision(0)<<((NanosecondsPerEvent > 0) ? 1E9/NanosecondsPerEvent : 0)
+          <<setw(20)<<setprecision(2)<<((FirstNanosecondsPerEvent > 0) ? NanosecondsPerEvent/FirstNanosecondsPerEvent : 0)<<endl;
+    }
+  }
+  cout<<endl;
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+ModuleBenchmark* g_Prg = 0;
+int g_NInterruptCatches = 1;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Called when an interrupt signal is flagged
+//! All catched signals lead to a well defined exit of the program
+void CatchSignal(int a)
+{
+  if (g_Prg != 0 && g_NInterruptCatches-- > 0) {
+    cout<<"Catched signal Ctrl-C (ID="<<a<<"):"<<endl;
+    g_Prg->Interrupt();
+  } else {
+    abort();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Main program
+int main(int argc, char** argv)
+{
+  // Catch a user interupt for graceful shutdown
+  signal(SIGINT, CatchSignal);
+
+  // Initialize global MEGALIB variables, especially mgui, etc.
+  MGlobal::Initialize("ModuleBenchmark", "a benchmark of the nuclearizer modules");
+
+  TApplication ModuleBenchmarkApp("ModuleBenchmarkApp", 0, 0);
+
+  g_Prg = new ModuleBenchmark();
+
+  if (g_Prg->ParseCommandLine(argc, argv) == false) {
+    cerr<<"Error during parsing of command line!"<<endl;
+    return -1;
+  }
+  if (g_Prg->Analyze() == false) {
+    cerr<<"Error during analysis!"<<endl;
+    return -2;
+  }
+
+  cout<<"Program exited normally!"<<endl;
+
+  return 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,729 @@
+/*
+ * TelemetryReplayServer.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+// Standard
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <sstream>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <poll.h>
+using namespace std;
+
+// ROOT
+
+// MEGAlib
+#include "MGlobal.h"
+#include "MString.h"
+
+// Nuclearizer
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Serves a recorded binary flight data file over a local TCP socket to the balloon receiver
+//! (MModuleReceiverBalloon), using the handshake of the flight distributor:
+//! The receiver connects to the handshake port and sends "START:REQUEST:<stream ID>", the server
+//! answers "START:<address>:<data port>:<stream ID>:ACK" and streams the packets to the first
+//! connection on the data port. "STOP:<address>:<port>" is answered with "STOP:ACK" and ends the session.
+//!
+//! The packets are paced by the Unix time in their headers, scaled by the rate multiplier,
+//! optionally grouped into bursts, and optionally corrupted, to load-test receiver and parser.
+class TelemetryReplayServer
+{
+public:
+  //! Default constructor
+  TelemetryReplayServer();
+  //! Default destructor
+  ~TelemetryReplayServer();
+
+  //! Parse the command line
+  bool ParseCommandLine(int argc, char** argv);
+  //! Analyze what eveer needs to be analyzed...
+  bool Analyze();
+  //! Interrupt the analysis
+  void Interrupt() { m_Interrupt = true; }
+
+private:
+  //! Open a listening socket on the given port, return -1 on failure
+  int Listen(int Port);
+  //! Wait for a connection on the listening socket, return -1 on interrupt or failure
+  int Accept(int ListenSocket, bool StopOnSessionEnd);
+  //! Send all bytes - measures the time blocked in the socket, returns false if the connection broke
+  bool SendAll(int Socket, const uint8_t* Data, size_t Size);
+  //! The loop of the handshake thread: answer START and STOP requests
+  void HandshakeLoop(int ListenSocket);
+  //! Stream the file once through the data connection, return false if the session ended early
+  bool StreamFile(int Socket);
+  //! Send one packet including the injected corruption
+  bool SendPacket(int Socket, const uint8_t* Packet, size_t Size);
+  //! Wait until the packet with the given Unix time is due
+  void Pace(uint32_t UnixTime);
+  //! Print the statistics
+  void PrintStatistics(bool Final);
+
+  //! True, if the analysis needs to be interrupted
+  atomic<bool> m_Interrupt;
+
+  //! The recorded binary flight data file
+  MString m_FileName;
+  //! The address the server binds to and announces to the receiver
+  MString m_Address;
+  //! The handshake port
+  int m_HandshakePort;
+  //! The data port
+  int m_DataPort;
+  //! The rate multiplier - 0 for as fast as possible
+  double m_RateMultiplier;
+  //! The length of the burst and of the pause in between in ms - 0 for no bursts
+  double m_BurstOn;
+  double m_BurstOff;
+  //! How often the file is replayed
+  unsigned int m_NLoops;
+  //! The probability per packet to flip a bit
+  double m_FlipProbability;
+  //! The probability per packet to drop its tail
+  double m_DropProbability;
+  //! The probability per packet to insert garbage in front of it
+  double m_GarbageProbability;
+  //! The probability per packet to send it twice
+  double m_DuplicateProbability;
+  //! The random seed
+  unsigned int m_Seed;
+
+  //! The random number generator of the corruption
+  mt19937 m_Random;
+
+  //! The stream ID of the current session
+  MString m_StreamID;
+  //! True if a START request was acknowledged
+  atomic<bool> m_SessionStarted;
+  //! True if the session was stopped
+  atomic<bool> m_SessionStopped;
+
+  //! The time the streaming started
+  chrono::steady_clock::time_point m_Start;
+  //! The time of the last progress report
+  chrono::steady_clock::time_point m_LastReport;
+  //! The pacing: the first Unix time and the wall time it was sent at
+  bool m_HasPacingBase;
+  uint32_t m_PacingUnixTime;
+  chrono::steady_clock::time_point m_PacingStart;
+  uint32_t m_LastUnixTime;
+
+  //! The statistics
+  uint64_t m_NBytesSent;
+  uint64_t m_NPackets;
+  uint64_t m_NJunkBytes;
+  uint64_t m_NFlipped;
+  uint64_t m_NDropped;
+  uint64_t m_NGarbage;
+  uint64_t m_NDuplicated;
+  //! The time blocked in send - the backpressure of the receiver
+  double m_SendBlockedTime;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Default constructor
+TelemetryReplayServer::TelemetryReplayServer() : m_Interrupt(false), m_SessionStarted(false), m_SessionStopped(false)
+{
+  m_Address = "127.0.0.1";
+  m_HandshakePort = 21526;
+  m_DataPort = 21530;
+  m_RateMultiplier = 1;
+  m_BurstOn = 0;
+  m_BurstOff = 0;
+  m_NLoops = 1;
+  m_FlipProbability = 0;
+  m_DropProbability = 0;
+  m_GarbageProbability = 0;
+  m_DuplicateProbability = 0;
+  m_Seed = 0;
+  m_HasPacingBase = false;
+  m_PacingUnixTime = 0;
+  m_LastUnixTime = 0;
+  m_NBytesSent = 0;
+  m_NPackets = 0;
+  m_NJunkBytes = 0;
+  m_NFlipped = 0;
+  m_NDropped = 0;
+  m_NGarbage = 0;
+  m_NDuplicated = 0;
+  m_SendBlockedTime = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Default destructor
+TelemetryReplayServer::~TelemetryReplayServer()
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Parse the command line
+bool TelemetryReplayServer::ParseCommandLine(int argc, char** argv)
+{
+  ostringstream Usage;
+  Usage<<endl;
+  Usage<<"  Usage: TelemetryReplayServer <options>"<<endl;
+  Usage<<"    General options:"<<endl;
+  Usage<<"         -f:   recorded binary flight data file"<<endl;
+  Usage<<"         -a:   address to bind to and to announce to the receiver (default: 127.0.0.1)"<<endl;
+  Usage<<"         -p:   handshake port - the distributor port of the receiver (default: 21526)"<<endl;
+  Usage<<"         -d:   data port (default: 21530)"<<endl;
+  Usage<<"         -r:   rate multiplier with respect to the packet times, e.g. 1, 10, or max (default: 1)"<<endl;
+  Usage<<"         -b:   burst pattern <on ms>:<off ms> - nothing is sent during the off time (default: none)"<<endl;
+  Usage<<"         -l:   number of times the file is replayed (default: 1)"<<endl;
+  Usage<<"    Corruption options (probabilities per packet):"<<endl;
+  Usage<<"         -cf:  flip a random bit"<<endl;
+  Usage<<"         -cd:  drop a random part of the packet's tail"<<endl;
+  Usage<<"         -cg:  insert 1-64 random bytes in front of the packet"<<endl;
+  Usage<<"         -cp:  send the packet twice"<<endl;
+  Usage<<"         -s:   random seed of the corruption (default: 0)"<<endl;
+  Usage<<"         -h:   print this help"<<endl;
+  Usage<<endl;
+
+  string Option;
+
+  // Check for help
+  for (int i = 1; i < argc; i++) {
+    Option = argv[i];
+    if (Option == "-h" || Option == "--help" || Option == "?" || Option == "-?") {
+      cout<<Usage.str()<<endl;
+      return false;
+    }
+  }
+
+  // Now parse the command line options:
+  for (int i = 1; i < argc; i++) {
+    Option = argv[i];
+
+    // First check if each option has sufficient arguments:
+    // Single argument
+    if (Option == "-f" || Option == "-a" || Option == "-p" || Option == "-d" || Option == "-r" ||
+        Option == "-b" || Option == "-l" || Option == "-cf" || Option == "-cd" || Option == "-cg" ||
+        Option == "-cp" || Option == "-s") {
+      if (!((argc > i+1) &&
+            (argv[i+1][0] != '-' || isalpha(argv[i+1][1]) == 0))){
+        cout<<"Error: Option "<<argv[i][1]<<" needs a second argument!"<<endl;
+        cout<<Usage.str()<<endl;
+        return false;
+      }
+    }
+
+    // Then fulfill the options:
+    if (Option == "-f") {
+      m_FileName = argv[++i];
+      cout<<"Accepting file name: "<<m_FileName<<endl;
+    } else if (Option == "-a") {
+      m_Address = argv[++i];
+      cout<<"Accepting address: "<<m_Address<<endl;
+    } else if (Option == "-p") {
+      m_HandshakePort = atoi(argv[++i]);
+      cout<<"Accepting handshake port: "<<m_HandshakePort<<endl;
+    } else if (Option == "-d") {
+      m_DataPort = atoi(argv[++i]);
+      cout<<"Accepting data port: "<<m_DataPort<<endl;
+    } else if (Option == "-r") {
+      string Rate = argv[++i];
+      m_RateMultiplier = (Rate == "max") ? 0 : atof(Rate.c_str());
+      if (m_RateMultiplier < 0) {
+        cout<<"Error: The rate multiplier must be positive or \"max\"!"<<endl;
+        return false;
+      }
+      cout<<"Accepting rate multiplier: "<<Rate<<endl;
+    } else if (Option == "-b") {
+      string Burst = argv[++i];
+      size_t Colon = Burst.find(':');
+      if (Colon == string::npos) {
+        cout<<"Error: The burst pattern must be given as <on ms>:<off ms>!"<<endl;
+        return false;
+      }
+      m_BurstOn = atof(Burst.substr(0, Colon).c_str());
+      m_BurstOff = atof(Burst.substr(Colon+1).c_str());
+      if (m_BurstOn <= 0 || m_BurstOff < 0) {
+        cout<<"Error: The burst on time must be positive and the off time must not be negative!"<<endl;
+        return false;
+      }
+      cout<<"Accepting burst pattern: "<<m_BurstOn<<" ms on, "<<m_BurstOff<<" ms off"<<endl;
+    } else if (Option == "-l") {
+      m_NLoops = atoi(argv[++i]);
+      cout<<"Accepting number of loops: "<<m_NLoops<<endl;
+    } else if (Option == "-cf") {
+      m_FlipProbability = atof(argv[++i]);
+      cout<<"Accepting bit flip probability: "<<m_FlipProbability<<endl;
+    } else if (Option == "-cd") {
+      m_DropProbability = atof(argv[++i]);
+      cout<<"Accepting drop probability: "<<m_DropProbability<<endl;
+    } else if (Option == "-cg") {
+      m_GarbageProbability = atof(argv[++i]);
+      cout<<"Accepting garbage probability: "<<m_GarbageProbability<<endl;
+    } else if (Option == "-cp") {
+      m_DuplicateProbability = atof(argv[++i]);
+      cout<<"Accepting duplicate probability: "<<m_DuplicateProbability<<endl;
+    } else if (Option == "-s") {
+      m_Seed = atoi(argv[++i]);
+      cout<<"Accepting seed: "<<m_Seed<<endl;
+    } else {
+      cout<<"Error: Unknown option \""<<Option<<"\"!"<<endl;
+      cout<<Usage.str()<<endl;
+      return false;
+    }
+  }
+
+  if (m_FileName == "") {
+    cout<<"Error: You need to give a file to replay!"<<endl;
+    cout<<Usage.str()<<endl;
+    return false;
+  }
+
+  m_Random.seed(m_Seed);
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Do whatever analysis is necessary
+bool TelemetryReplayServer::Analyze()
+{
+  ifstream Test(m_FileName.Data(), ios::binary);
+  if (Test.is_open() == false) {
+    cout<<"Error: Unable to open file "<<m_FileName<<endl;
+    return false;
+  }
+  Test.close();
+
+  int HandshakeSocket = Listen(m_HandshakePort);
+  if (HandshakeSocket < 0) return false;
+  // Listen on the data port before the first ACK, so that the receiver can connect right away
+  int DataListenSocket = Listen(m_DataPort);
+  if (DataListenSocket < 0) {
+    close(HandshakeSocket);
+    return false;
+  }
+
+  cout<<"Waiting for the receiver on "<<m_Address<<":"<<m_HandshakePort<<endl;
+  thread Handshake(&TelemetryReplayServer::HandshakeLoop, this, HandshakeSocket);
+
+  while (m_SessionStarted == false && m_Interrupt == false) {
+    this_thread::sleep_for(chrono::milliseconds(100));
+  }
+
+  bool Success = true;
+  int DataSocket = Accept(DataListenSocket, true);
+  if (DataSocket >= 0) {
+    cout<<"Receiver connected to the data port - streaming "<<m_FileName<<endl;
+    int One = 1;
+    setsockopt(DataSocket, IPPROTO_TCP, TCP_NODELAY, &One, sizeof(One));
+
+    m_Start = chrono::steady_clock::now();
+    m_LastReport = m_Start;
+    for (unsigned int l = 0; l < m_NLoops && m_Interrupt == false && m_SessionStopped == false; ++l) {
+      // Each loop starts a new pacing period, since the packet times jump back
+      m_HasPacingBase = false;
+      if (StreamFile(DataSocket) == false) break;
+    }
+    PrintStatistics(true);
+
+    // Keep the connection open until the receiver stops the session, a closed connection looks like a broken link
+    if (m_Interrupt == false && m_SessionStopped == false) {
+      cout<<"Replay finished - waiting for the STOP request of the receiver (or Ctrl-C)"<<endl;
+    }
+    while (m_Interrupt == false && m_SessionStopped == false) {
+      this_thread::sleep_for(chrono::milliseconds(100));
+    }
+    close(DataSocket);
+  } else if (m_Interrupt == false) {
+    Success = false;
+  }
+
+  m_Interrupt = true;
+  Handshake.join();
+  close(DataListenSocket);
+  close(HandshakeSocket);
+
+  return Success;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Open a listening socket on the given port, return -1 on failure
+int TelemetryReplayServer::Listen(int Port)
+{
+  int Socket = socket(AF_INET, SOCK_STREAM, 0);
+  if (Socket < 0) {
+    cout<<"Error: Unable to create socket: "<<strerror(errno)<<endl;
+    return -1;
+  }
+  int One = 1;
+  setsockopt(Socket, SOL_SOCKET, SO_REUSEADDR, &One, sizeof(One));
+
+  sockaddr_in Address;
+  memset(&Address, 0, sizeof(Address));
+  Address.sin_family = AF_INET;
+  Address.sin_port = htons(Port);
+  if (inet_pton(AF_INET, m_Address.Data(), &Address.sin_addr) != 1) {
+    cout<<"Error: Not a numerical IPv4 address: "<<m_Address<<endl;
+    close(Socket);
+    return -1;
+  }
+  if (::bind(Socket, (sockaddr*) &Address, sizeof(Address)) != 0 || listen(Socket, 4) != 0) {
+    cout<<"Error: Unable to listen on "<<m_Address<<":"<<Port<<": "<<strerror(errno)<<endl;
+    close(Socket);
+    return -1;
+  }
+
+  return Socket;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Wait for a connection on the listening socket, return -1 on interrupt or failure
+int TelemetryReplayServer::Accept(int ListenSocket, bool StopOnSessionEnd)
+{
+  pollfd Poll;
+  Poll.fd = ListenSocket;
+  Poll.events = POLLIN;
+  while (m_Interrupt == false && (StopOnSessionEnd == false || m_SessionStopped == false)) {
+    int Ready = poll(&Poll, 1, 100);
+    if (Ready < 0 && errno != EINTR) {
+      cout<<"Error: Waiting for a connection failed: "<<strerror(errno)<<endl;
+      return -1;
+    }
+    if (Ready > 0) {
+      int Socket = accept(ListenSocket, nullptr, nullptr);
+      if (Socket >= 0) return Socket;
+    }
+  }
+
+  return -1;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! The loop of the handshake thread: answer START and STOP requests
+void TelemetryReplayServer::HandshakeLoop(int ListenSocket)
+{
+  while (m_Interrupt == false) {
+    int Socket = Accept(ListenSocket, false);
+    if (Socket < 0) break;
+
+    // The receiver sends the request in one go and waits for the answer
+    string Request;
+    pollfd Poll;
+    Poll.fd = Socket;
+    Poll.events = POLLIN;
+    for (int w = 0; w < 50 && m_Interrupt == false; ++w) {
+      if (poll(&Poll, 1, 100) > 0) {
+        char Buffer[256];
+        ssize_t N = recv(Socket, Buffer, sizeof(Buffer), 0);
+        if (N <= 0) break;
+        Request.append(Buffer, N);
+        if (Request.find("START:") == 0 && count(Request.begin(), Request.end(), ':') >= 2) break;
+        if (Request.find("STOP:") == 0 && count(Request.begin(), Request.end(), ':') >= 2) break;
+      }
+    }
+
+    ostringstream Answer;
+    if (Request.find("START:REQUEST:") == 0) {
+      m_StreamID = Request.substr(14);
+      Answer<<"START:"<<m_Address<<":"<<m_DataPort<<":"<<m_StreamID<<":ACK";
+      m_SessionStarted = true;
+    } else if (Request.find("STOP:") == 0) {
+      Answer<<"STOP:ACK";
+      m_SessionStopped = true;
+    } else {
+      // Only the receiver mode in which it requests the data connection is supported
+      Answer<<"ERROR:UNSUPPORTED";
+    }
+    cout<<"Handshake: received \""<<Request<<"\", answering \""<<Answer.str()<<"\""<<endl;
+    string A = Answer.str();
+    send(Socket, A.data(), A.size(), MSG_NOSIGNAL);
+
+    // Give the receiver time to read the answer before closing
+    this_thread::sleep_for(chrono::milliseconds(200));
+    close(Socket);
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Stream the file once through the data connection, return false if the session ended early
+bool TelemetryReplayServer::StreamFile(int Socket)
+{
+  ifstream In(m_FileName.Data(), ios::binary);
+  if (In.is_open() == false) {
+    cout<<"Error: Unable to open file "<<m_FileName<<endl;
+    return false;
+  }
+
+  // The packets start with the sync word 0xEB 0x90, the 16-bit length (including the header) is at byte 8
+  const size_t HeaderSize = 10;
+  const size_t MaxPacketLength = 1360;
+  const size_t ChunkSize = 1 << 20;
+
+  vector<uint8_t> Buffer;
+  size_t Begin = 0;
+  bool EndOfFile = false;
+  while (m_Interrupt == false && m_SessionStopped == false) {
+    // Refill
+    if (EndOfFile == false && Buffer.size() - Begin < MaxPacketLength) {
+      Buffer.erase(Buffer.begin(), Buffer.begin() + Begin);
+      Begin = 0;
+      size_t Size = Buffer.size();
+      Buffer.resize(Size + ChunkSize);
+      In.read((char*) &Buffer[Size], ChunkSize);
+      Buffer.resize(Size + In.gcount());
+      if (In.gcount() < (streamsize) ChunkSize) EndOfFile = true;
+    }
+    if (Begin == Buffer.size()) break;
+
+    size_t Available = Buffer.size() - Begin;
+    const uint8_t* P = &Buffer[Begin];
+    size_t Length = 0;
+    if (Available >= HeaderSize && P[0] == 0xeb && P[1] == 0x90) {
+      Length = ((size_t) P[8] << 8) | P[9];
+      if (Length < HeaderSize || Length > MaxPacketLength || Length > Available) Length = 0;
+    }
+
+    if (Length > 0) {
+      Pace(((uint32_t) P[3] << 16) | ((uint32_t) P[4] << 8) | P[5]);
+      if (SendPacket(Socket, P, Length) == false) return false;
+      Begin += Length;
+    } else {
+      // Bytes between packets are replayed as they were recorded
+      size_t Junk = 1;
+      while (Junk < Available && Buffer[Begin + Junk] != 0xeb) ++Junk;
+      if (SendAll(Socket, P, Junk) == false) return false;
+      m_NJunkBytes += Junk;
+      Begin += Junk;
+    }
+
+    if (chrono::duration<double>(chrono::steady_clock::now() - m_LastReport).count() > 5) {
+      PrintStatistics(false);
+      m_LastReport = chrono::steady_clock::now();
+    }
+  }
+
+  return m_Interrupt == false && m_SessionStopped == false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Send one packet including the injected corruption
+bool TelemetryReplayServer::SendPacket(int Socket, const uint8_t* Packet, size_t Size)
+{
+  uniform_real_distribution<double> Uniform(0.0, 1.0);
+  ++m_NPackets;
+
+  if (m_GarbageProbability > 0 && Uniform(m_Random) < m_GarbageProbability) {
+    vector<uint8_t> Garbage(1 + m_Random() % 64);
+    for (uint8_t& G: Garbage) G = m_Random() & 0xff;
+    if (SendAll(Socket, Garbage.data(), Garbage.size()) == false) return false;
+    ++m_NGarbage;
+  }
+
+  const uint8_t* Data = Packet;
+  vector<uint8_t> Copy;
+  if (m_FlipProbability > 0 && Uniform(m_Random) < m_FlipProbability) {
+    Copy.assign(Packet, Packet + Size);
+    Copy[m_Random() % Size] ^= (1 << (m_Random() % 8));
+    Data = Copy.data();
+    ++m_NFlipped;
+  }
+  if (m_DropProbability > 0 && Uniform(m_Random) < m_DropProbability) {
+    Size = m_Random() % Size;
+    ++m_NDropped;
+  }
+
+  if (SendAll(Socket, Data, Size) == false) return false;
+
+  if (m_DuplicateProbability > 0 && Uniform(m_Random) < m_DuplicateProbability) {
+    if (SendAll(Socket, Data, Size) == false) return false;
+    ++m_NDuplicated;
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Wait until the packet with the given Unix time is due
+void TelemetryReplayServer::Pace(uint32_t UnixTime)
+{
+  // The recording's Unix time has a resolution of one second and only 24 bits:
+  // start a new pacing period at the first packet, if the time jumps back, or if it jumps ahead by more than a minute
+  if (m_RateMultiplier > 0) {
+    if (m_HasPacingBase == false || UnixTime < m_LastUnixTime || UnixTime - m_LastUnixTime > 60) {
+      m_HasPacingBase = true;
+      m_PacingUnixTime = UnixTime;
+      m_PacingStart = chrono::steady_clock::now();
+    }
+    m_LastUnixTime = UnixTime;
+
+    chrono::steady_clock::time_point Due = m_PacingStart + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>((UnixTime - m_PacingUnixTime)/m_RateMultiplier));
+    while (m_Interrupt == false && m_SessionStopped == false && chrono::steady_clock::now() < Due) {
+      this_thread::sleep_for(min(chrono::steady_clock::duration(chrono::milliseconds(50)), Due - chrono::steady_clock::now()));
+    }
+  }
+
+  // Bursts: hold back the data during the off time - it is sent at the beginning of the next burst
+  if (m_BurstOn > 0 && m_BurstOff > 0) {
+    double Period = m_BurstOn + m_BurstOff;
+    double Phase = fmod(1000*chrono::duration<double>(chrono::steady_clock::now() - m_Start).count(), Period);
+    if (Phase >= m_BurstOn && m_Interrupt == false && m_SessionStopped == false) {
+      this_thread::sleep_for(chrono::duration<double, milli>(Period - Phase));
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Send all bytes - measures the time blocked in the socket, returns false if the connection broke
+bool TelemetryReplayServer::SendAll(int Socket, const uint8_t* Data, size_t Size)
+{
+  chrono::steady_clock::time_point Start = chrono::steady_clock::now();
+  while (Size > 0) {
+    ssize_t N = send(Socket, Data, Size, MSG_NOSIGNAL);
+    if (N < 0) {
+      if (errno == EINTR) continue;
+      cout<<"Error: The receiver closed the data connection: "<<strerror(errno)<<endl;
+      return false;
+    }
+    Data += N;
+    Size -= N;
+    m_NBytesSent += N;
+  }
+  m_SendBlockedTime += chrono::duration<double>(chrono::steady_clock::now() - Start).count();
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Print the statistics
+void TelemetryReplayServer::PrintStatistics(bool Final)
+{
+  double Elapsed = chrono::duration<double>(chrono::steady_clock::now() - m_Start).count();
+  if (Elapsed <= 0) Elapsed = 1E-9;
+
+  cout<<(Final == true ? "Replay summary: " : "Replay: ")<<m_NPackets<<" packets, "<<m_NBytesSent<<" bytes in "<<Elapsed<<" s ("
+      <<m_NBytesSent/Elapsed/1024/1024<<" MB/s, "<<m_NPackets/Elapsed<<" packets/s), blocked in send: "<<m_SendBlockedTime<<" s"<<endl;
+  if (Final == true) {
+    cout<<"  Junk bytes between packets in the recording: "<<m_NJunkBytes<<endl;
+    cout<<"  Injected: "<<m_NFlipped<<" bit flips, "<<m_NDropped<<" truncated packets, "<<m_NGarbage<<" garbage blocks, "<<m_NDuplicated<<" duplicates"<<endl;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+TelemetryReplayServer* g_Prg = 0;
+int g_NInterruptCatches = 1;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Called when an interrupt signal is flagged
+//! All catched signals lead to a well defined exit of the program
+void CatchSignal(int a)
+{
+  if (g_Prg != 0 && g_NInterruptCatches-- > 0) {
+    cout<<"Catched signal Ctrl-C (ID="<<a<<"):"<<endl;
+    g_Prg->Interrupt();
+  } else {
+    abort();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Main program
+int main(int argc, char** argv)
+{
+  // Catch a user interupt for graceful shutdown
+  signal(SIGINT, CatchSignal);
+
+  // Initialize global MEGALIB variables, especially mgui, etc.
+  MGlobal::Initialize("TelemetryReplayServer", "replays recorded flight data to the balloon receiver");
+
+  g_Prg = new TelemetryReplayServer();
+
+  if (g_Prg->ParseCommandLine(argc, argv) == false) {
+    cerr<<"Error during parsing of command line!"<<endl;
+    return -1;
+  }
+  if (g_Prg->Analyze() == false) {
+    cerr<<"Error during analysis!"<<endl;
+    return -2;
+  }
+
+  cout<<"Program exited normally!"<<endl;
+
+  return 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
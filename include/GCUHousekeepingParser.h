@@ -238,9 +238,9 @@ struct GCUHousekeepingPacket {
 };
 
 struct GCUHousekeepingPacket* MakeNewGCUHousekeepingPacket(void);
-struct GCUHousekeepingPacket* ParseGCUHousekeepingPacket(uint8_t* RawData);
-void ParseAllocatedGCUHousekeepingPacket(uint8_t* RawData, struct GCUHousekeepingPacket* packet);
-void ParseGCUHousekeepingPacketWrapper(uint8_t* RawData, void* packet_bytes);
+struct GCUHousekeepingPacket* ParseGCUHousekeepingPacket(const uint8_t* RawData);
+void ParseAllocatedGCUHousekeepingPacket(const uint8_t* RawData, struct GCUHousekeepingPacket* packet);
+void ParseGCUHousekeepingPacketWrapper(const uint8_t* RawData, void* packet_bytes);
 void printGCUHousekeepingPacket(struct GCUHousekeepingPacket* packet);
 
 #endif
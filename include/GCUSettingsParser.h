@@ -104,9 +104,9 @@ struct GCUSettingsPacket {
 };
 
 struct GCUSettingsPacket* MakeNewGCUSettingsPacket(void);
-struct GCUSettingsPacket* ParseGCUSettingsPacket(uint8_t* RawData);
-void ParseAllocatedGCUSettingsPacket(uint8_t* RawData, struct GCUSettingsPacket* packet);
-void ParseGCUSettingsPacketWrapper(uint8_t* RawData, void* packet_bytes);
+struct GCUSettingsPacket* ParseGCUSettingsPacket(const uint8_t* RawData);
+void ParseAllocatedGCUSettingsPacket(const uint8_t* RawData, struct GCUSettingsPacket* packet);
+void ParseGCUSettingsPacketWrapper(const uint8_t* RawData, void* packet_bytes);
 void printGCUSettingsPacket(struct GCUSettingsPacket* packet);
 
 #endif
@@ -28,5 +28,5 @@ struct LivetimePacket{
 };
  
 //declare functions
-void ParseLivetime(struct LivetimePacket* packet, uint8_t* RawData);
+void ParseLivetime(struct LivetimePacket* packet, const uint8_t* RawData);
 
@@ -18,6 +18,7 @@
 
 // standard libs
 #include <iostream>
+#include <chrono>
 using namespace std;
 
 // ROOT libs
@@ -27,6 +28,9 @@ using namespace std;
 #include "MGlobal.h"
 #include "MSupervisor.h"
 
+// Nuclearizer libs:
+#include "MModulePipeline.h"
+
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -44,8 +48,8 @@ class MAssembly
   //! this function is called by main()
   bool ParseCommandLine(int argc, char** argv);
   
-  //! Called when hit Control-C: Set the interrupt which will end the analysis in the supervisor
-  void SetInterrupt(bool Flag = true) { m_Supervisor->SetHardInterrupt(Flag); }
+  //! Called when hit Control-C: Set the interrupt which will end the analysis in the supervisor or the pipeline
+  void SetInterrupt(bool Flag = true) { m_Supervisor->SetHardInterrupt(Flag); if (m_Pipeline != nullptr) m_Pipeline->SetInterrupt(Flag); }
 
   // Module types:
   static const uint64_t c_EventLoader              = (1 << 0);  // = 1
@@ -81,6 +85,12 @@ class MAssembly
   
   // private methods:
  private:
+  //! Run the module chain of the supervisor with nuclearizer's own batch pipeline
+  bool AnalyzeWithPipeline();
+  //! Write the benchmark result of the pipeline as JSON file
+  bool WriteBenchmark();
+  //! Stream the benchmark result of the pipeline as JSON
+  void StreamBenchmark(ostream& out);
 
 
   // protected members:
@@ -98,6 +108,23 @@ class MAssembly
   //! The interrupt flag - the analysis will stop when this flag is set
   bool m_Interrupt;
 
+  //! The batch size of the pipeline - 0 for its default
+  unsigned int m_BatchSize;
+  //! The number of clones of each replicable module in the pipeline - 0 means no module threads
+  unsigned int m_NReplicas;
+  //! True if the modules run in their own threads
+  bool m_UseMultiThreading;
+  //! The file to which the pipeline writes its per-module statistics - empty for none
+  MString m_StatisticsFileName;
+  //! The configuration file of a benchmark run - empty if this is no benchmark
+  MString m_BenchmarkConfiguration;
+  //! The file to which the benchmark result is written - empty to derive it from the configuration
+  MString m_BenchmarkFileName;
+  //! The time at which this instance has been created - the start of the startup time measurement
+  chrono::steady_clock::time_point m_CreationTime;
+  //! The pipeline while it is running
+  MModulePipeline* m_Pipeline;
+
   
 #ifdef ___CLING___
  public:
@@ -0,0 +1,120 @@
+/*
+ * MBatchAnalyzer.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MBatchAnalyzer__
+#define __MBatchAnalyzer__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+#include "MModule.h"
+
+// Nuclearizer libs:
+#include "MReadOutAssembly.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Optional interface for modules which can analyze several events in one call.
+//! A module derives from MModule and from this class. The default AnalyzeEvents()
+//! just loops over AnalyzeEvent(), modules override it to keep their look-up tables,
+//! output buffers and GUI updates hot across a batch.
+//! Batches are handed out by MModulePipeline; the MEGAlib supervisor keeps calling
+//! AnalyzeEvent() one event at a time.
+//! A module which does not carry state from one event to the next can declare itself
+//! replicable, then the pipeline may run several clones of it in parallel.
+class MBatchAnalyzer
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MBatchAnalyzer() : m_IsReplica(false) {}
+  //! Default destructor
+  virtual ~MBatchAnalyzer() {}
+
+  //! Main data analysis routine for one event - implemented by the module
+  virtual bool AnalyzeEvent(MReadOutAssembly* Event) = 0;
+
+  //! Return true if independent clones of this module may analyze different events in parallel
+  virtual bool IsReplicable() const { return false; }
+  //! Add the counters of a finished replica of this module to this instance
+  //! Called by the pipeline before the replica is finalized, this instance is finalized afterwards
+  virtual void MergeReplica(MBatchAnalyzer* Replica) {}
+
+  //! Mark this instance as a replica - a replica leaves its summary to the original
+  void SetIsReplica(bool IsReplica) { m_IsReplica = IsReplica; }
+  //! Return true if this instance is a replica
+  bool IsReplica() const { return m_IsReplica; }
+
+  //! Analyze a batch of events - Results[i] is the return value of the analysis of Events[i]
+  virtual void AnalyzeEvents(vector<MReadOutAssembly*>& Events, vector<bool>& Results) {
+    Results.resize(Events.size());
+    for (unsigned int e = 0; e < Events.size(); ++e) {
+      Results[e] = AnalyzeEvent(Events[e]);
+    }
+  }
+
+  //! Return true if the module is replicable
+  static bool IsReplicable(MModule* Module) {
+    MBatchAnalyzer* Batch = dynamic_cast<MBatchAnalyzer*>(Module);
+    return (Batch != nullptr) ? Batch->IsReplicable() : false;
+  }
+
+  //! Mark the module as replica of the original and return true if it supports replicas
+  static bool SetIsReplica(MModule* Replica) {
+    MBatchAnalyzer* Batch = dynamic_cast<MBatchAnalyzer*>(Replica);
+    if (Batch == nullptr) return false;
+    Batch->SetIsReplica(true);
+    return true;
+  }
+
+  //! Add the counters of a finished replica to the original module
+  static void MergeReplica(MModule* Original, MModule* Replica) {
+    MBatchAnalyzer* O = dynamic_cast<MBatchAnalyzer*>(Original);
+    MBatchAnalyzer* R = dynamic_cast<MBatchAnalyzer*>(Replica);
+    if (O != nullptr && R != nullptr) O->MergeReplica(R);
+  }
+
+  //! Analyze a batch of events with any module: modules without batch support are called event by event
+  static void AnalyzeEvents(MModule* Module, vector<MReadOutAssembly*>& Events, vector<bool>& Results) {
+    MBatchAnalyzer* Batch = dynamic_cast<MBatchAnalyzer*>(Module);
+    if (Batch != nullptr) {
+      Batch->AnalyzeEvents(Events, Results);
+    } else {
+      Results.resize(Events.size());
+      for (unsigned int e = 0; e < Events.size(); ++e) {
+        Results[e] = Module->AnalyzeEvent(Events[e]);
+      }
+    }
+  }
+
+  // protected members:
+ protected:
+  //! True if this instance is a replica created by the pipeline
+  bool m_IsReplica;
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
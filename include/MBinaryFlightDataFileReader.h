@@ -0,0 +1,192 @@
+/*
+ * MBinaryFlightDataFileReader.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MBinaryFlightDataFileReader__
+#define __MBinaryFlightDataFileReader__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+#include "MString.h"
+
+// Nuclearizer libs:
+#include "MGzipBlockReader.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Reads an (uncompressed or gzip'ed) binary flight data file on a background thread and splits it into packets.
+//! The packets are handed over in batches through a small queue, thus several files can be read and framed
+//! concurrently while the caller merges them. Each packet comes with its byte offset and a clock for merging:
+//! the system clock of raw and Compton dataframes, and the clock of the preceding dataframe for all other packets.
+class MBinaryFlightDataFileReader
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MBinaryFlightDataFileReader();
+  //! Default destructor - closes the file
+  virtual ~MBinaryFlightDataFileReader();
+
+  //! Open the file and start the reading thread, return false on error
+  //! Only the packets within the byte region [Begin, End) of the uncompressed data stream are read
+  bool Open(const MString& FileName, uint64_t Begin = 0, uint64_t End = numeric_limits<uint64_t>::max());
+  //! Stop the reading thread and close the file
+  void Close();
+
+  //! Advance to the next packet - blocks until the reading thread has framed it
+  //! Return false at the end of the file
+  bool Next();
+  //! Return true if there is a current packet, i.e. the last call to Next() was successful
+  bool HasPacket() const { return m_Current != nullptr; }
+
+  //! Return the current packet
+  const uint8_t* GetPacket() const { return m_Current->Bytes.data() + m_Current->Packets[m_CurrentPacket].Position; }
+  //! Return the length of the current packet
+  uint16_t GetLength() const { return m_Current->Packets[m_CurrentPacket].Length; }
+  //! Return the byte offset of the current packet in the uncompressed data stream
+  uint64_t GetOffset() const { return m_Current->Packets[m_CurrentPacket].Offset; }
+  //! Return the merge clock of the current packet
+  uint64_t GetClock() const { return m_Current->Packets[m_CurrentPacket].Clock; }
+
+  //! Return true if reading failed (e.g. a truncated gzip'ed file)
+  bool HasError() const;
+
+  //! Return the 48-bit system clock of a raw or Compton dataframe, 0 for all other packets
+  static uint64_t GetDataframeClock(const uint8_t* Packet, uint16_t Length);
+  //! Return true if the packet header (at least 10 bytes) is plausible: the sync word, a length within bounds, and a packet type we decode
+  static bool IsPlausibleHeader(const uint8_t* Header);
+
+  //! The maximum length of a packet
+  static const uint16_t c_MaxPacketLength = 1360;
+
+
+  // protected methods:
+ protected:
+  //! The reading thread: read, frame, and queue the packets until the end of the region
+  void ReadLoop();
+
+  //! One packet within a batch
+  class packetinfo {
+   public:
+    //! The position of the packet in the bytes of the batch
+    size_t Position;
+    //! The length of the packet
+    uint16_t Length;
+    //! The byte offset of the packet in the uncompressed data stream
+    uint64_t Offset;
+    //! The merge clock of the packet
+    uint64_t Clock;
+  };
+
+  //! The packets handed over from the reading thread in one go
+  class batch {
+   public:
+    //! The bytes of all packets
+    vector<uint8_t> Bytes;
+    //! The packets
+    vector<packetinfo> Packets;
+  };
+
+  //! Queue a filled batch and return an empty one - blocks while all batches are in use, returns nullptr if stopped
+  batch* Exchange(batch* Filled);
+
+
+  // private methods:
+ private:
+  //! No copies of the thread and file handles
+  MBinaryFlightDataFileReader(const MBinaryFlightDataFileReader&) = delete;
+  MBinaryFlightDataFileReader& operator=(const MBinaryFlightDataFileReader&) = delete;
+
+
+
+  // protected members:
+ protected:
+  //! The file name
+  MString m_FileName;
+  //! The start of the region to read
+  uint64_t m_Begin;
+  //! The end of the region to read
+  uint64_t m_End;
+  //! True if the file is gzip'ed
+  bool m_IsZipped;
+  //! The uncompressed file
+  ifstream m_In;
+  //! The gzip'ed file
+  MGzipBlockReader m_ZipReader;
+  //! The reading thread
+  thread m_Thread;
+
+  //! All batches
+  vector<batch> m_Batches;
+  //! The filled batches in file order
+  deque<batch*> m_Filled;
+  //! The empty batches
+  vector<batch*> m_Empty;
+  //! The batch of the current packet (nullptr if there is none)
+  batch* m_Current;
+  //! The index of the current packet in the current batch
+  size_t m_CurrentPacket;
+
+  //! True if the reading thread queued its last batch
+  bool m_IsDone;
+  //! True if reading failed
+  bool m_HasError;
+  //! True if the reading thread should stop
+  bool m_Stop;
+
+  //! The mutex protecting the batch queues
+  mutable mutex m_Mutex;
+  //! Signals a freshly filled or a freshly emptied batch
+  condition_variable m_Condition;
+
+  //! The number of batches
+  static const unsigned int c_NBatches = 4;
+  //! A batch is handed over once it has this many bytes
+  static const size_t c_BatchSize = 1000000;
+  //! The size of the chunks read from uncompressed files
+  static const size_t c_ChunkSize = 1000000;
+
+
+  // private members:
+ private:
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MBinaryFlightDataFileReader, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
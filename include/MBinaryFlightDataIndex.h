@@ -0,0 +1,134 @@
+/*
+ * MBinaryFlightDataIndex.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MBinaryFlightDataIndex__
+#define __MBinaryFlightDataIndex__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+#include "MString.h"
+
+// Nuclearizer libs:
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! The packet index of a binary flight data file: byte offset, length, type, card cage, Unix time and clock of each packet.
+//! It is built once by scanning the file and stored as a compact sidecar file next to it ("<data file>.idx"),
+//! which allows to seek directly to the packets of a time range instead of parsing the whole file.
+class MBinaryFlightDataIndex
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MBinaryFlightDataIndex();
+  //! Default destructor
+  virtual ~MBinaryFlightDataIndex();
+
+  //! Return the name of the sidecar index file of the given data file
+  static MString GetIndexFileName(const MString& DataFileName) { return DataFileName + ".idx"; }
+
+  //! Read the sidecar index of the data file - build and write it if it does not exist or is outdated
+  bool Load(const MString& DataFileName);
+  //! Scan the (uncompressed or gzip'ed) data file and build the index
+  bool Build(const MString& DataFileName);
+  //! Write the index to a file
+  bool Write(const MString& FileName) const;
+  //! Read the index from a file - fails if the index was not built from a data file of the given size
+  bool Read(const MString& FileName, uint64_t DataFileSize);
+
+  //! Find the byte region [Begin, End) of the uncompressed data stream which contains all packets
+  //! with Unix times within [Start, Stop] - return false if there are no such packets
+  bool FindRegion(uint32_t Start, uint32_t Stop, uint64_t& Begin, uint64_t& End) const;
+
+  //! One indexed packet
+  class entry {
+   public:
+    //! The byte offset of the packet in the uncompressed data stream
+    uint64_t Offset;
+    //! The length of the packet
+    uint16_t Length;
+    //! The packet type
+    uint8_t Type;
+    //! The card cage of raw dataframes, c_NoCCId for all other packets
+    uint8_t CCId;
+    //! The Unix time of the packet
+    uint32_t UnixTime;
+    //! The 48-bit system clock of raw and Compton dataframes, 0 for all other packets
+    uint64_t Clock;
+  };
+
+  //! Return the number of indexed packets
+  size_t GetNEntries() const { return m_Entries.size(); }
+  //! Return the entry of packet i
+  const entry& GetEntry(size_t i) const { return m_Entries[i]; }
+
+  //! The card cage ID of packets which do not belong to a card cage
+  static const uint8_t c_NoCCId = 0xff;
+
+
+  // protected methods:
+ protected:
+  //! Add the packet at the given offset to the index
+  void AddPacket(const uint8_t* Packet, uint16_t Length, uint64_t Offset);
+  //! Return the size of the file on disk (0 if it does not exist)
+  static uint64_t GetFileSize(const MString& FileName);
+
+
+  // private methods:
+ private:
+
+
+
+  // protected members:
+ protected:
+  //! The indexed packets in file order
+  vector<entry> m_Entries;
+  //! The size of the indexed data file on disk
+  uint64_t m_DataFileSize;
+  //! The most significant byte of the Unix time - only known after the first GCU housekeeping packet
+  uint8_t m_UnixTimeMSB;
+  //! True if the most significant byte of the Unix time is known
+  bool m_HasUnixTimeMSB;
+
+  //! The size of one entry in the index file
+  static const unsigned int c_EntrySize = 22;
+
+
+  // private members:
+ private:
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MBinaryFlightDataIndex, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
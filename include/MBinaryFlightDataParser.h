@@ -20,6 +20,10 @@
 #include <list>
 #include <fstream>
 #include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 using namespace std;
 
 // ROOT libs:
@@ -34,6 +38,10 @@ using namespace std;
 #include "MReadOutAssembly.h"
 #include "MModuleEventSaver.h"
 #include "MTimeAndCoordinate.h"
+#include "MDuplicatePacketFilter.h"
+#include "MEventStreamMerger.h"
+#include "MHousekeepingWriter.h"
+#include "MBinaryFlightDataParserStatistics.h"
 
 // Forward declarations:
 
@@ -59,6 +67,10 @@ class MBinaryFlightDataParser
   MBinaryFlightDataParser();
   //! Default destructor
   virtual ~MBinaryFlightDataParser();
+
+  //! The nested classes used before their definition below
+  class decodejob;
+  class dataframe;
   
   //! Get the data selection mode
   MBinaryFlightDataParserDataModes GetDataSelectionMode() const { return m_DataSelectionMode; }
@@ -74,9 +86,31 @@ class MBinaryFlightDataParser
   void EnableCoincidenceMerging(bool X) {m_CoincidenceEnabled = X;}
   //! Get coincidence merging true/false
   bool GetCoincidenceMerging() const { return m_CoincidenceEnabled; }
+
+  //! Set the number of threads decoding dataframes (0: decode them in the parsing thread)
+  void SetNDecodeThreads(unsigned int NThreads);
+  //! Get the number of threads decoding dataframes
+  unsigned int GetNDecodeThreads() const { return m_NDecodeThreads; }
+
+  //! Set if the housekeeping is written as binary columnar file instead of text
+  void SetBinaryHousekeeping(bool Binary) { m_BinaryHousekeeping = Binary; }
+  //! Get if the housekeeping is written as binary columnar file instead of text
+  bool GetBinaryHousekeeping() const { return m_BinaryHousekeeping; }
+
+  //! Set the file to which the statistics are periodically written as JSON lines (empty: none)
+  void SetMetricsFileName(const MString& FileName) { m_MetricsFileName = FileName; }
+  //! Get the file to which the statistics are periodically written as JSON lines
+  MString GetMetricsFileName() const { return m_MetricsFileName; }
+  //! Set the interval in seconds between two entries in the metrics file
+  void SetMetricsInterval(double Interval) { m_MetricsInterval = Interval; }
+  //! Get the interval in seconds between two entries in the metrics file
+  double GetMetricsInterval() const { return m_MetricsInterval; }
  
   //! Parse some data, return true if the module is ready to analyze events
-  virtual bool ParseData(vector<uint8_t> Received) ;
+  virtual bool ParseData(const vector<uint8_t>& Received);
+  //! Parse Size bytes starting at Data, return true if the module is ready to analyze events
+  //! The data is only read during the call, thus it can be a view into a memory-mapped file
+  virtual bool ParseData(const uint8_t* Data, size_t Size);
   
   //! Initialize the module
   virtual bool Initialize();
@@ -93,6 +127,26 @@ class MBinaryFlightDataParser
   //! Get access to m_AspectReconstructor
   MAspectReconstruction* GetAspectReconstructor() const { return m_AspectReconstructor; }
 
+  //! Return a snapshot of the telemetry statistics
+  MBinaryFlightDataParserStatistics GetStatistics() const;
+  //! Return how often the input stream had to be resynchronized
+  uint64_t GetNResyncs() const { return m_Statistics.GetNResyncs(); }
+  //! Return the number of bytes skipped while resynchronizing
+  uint64_t GetNResyncSkippedBytes() const { return m_Statistics.GetNLostBytes(); }
+  //! Return the number of packets dropped as duplicates
+  uint64_t GetNDuplicatePackets() const { return m_PacketRecord.GetNHits(); }
+  //! Return the number of packets which passed the duplicate filter
+  uint64_t GetNUniquePackets() const { return m_PacketRecord.GetNMisses(); }
+  //! Return the number of events which arrived out of order within their card cage stream
+  uint64_t GetNLateEvents() const { return m_EventsBuf.GetNLateEvents(); }
+
+  //! Return true once a GCU housekeeping packet delivered the most significant byte of the Unix time
+  bool HasUnixTimeMSB() const { return m_HasGCUUnixTimeMSB; }
+  //! Return the most significant byte of the Unix time from the last GCU housekeeping packet
+  uint8_t GetUnixTimeMSB() const { return m_GCUUnixTimeMSB; }
+  //! Return the raw preamp temperatures from the last GCU settings packet (Det0 DC, Det0 AC, Det1 DC, ...)
+  const vector<uint16_t>& GetPreampTemperatures() const { return m_PreampTemps; }
+
   // protected methods:
  protected:
 
@@ -114,24 +168,25 @@ class MBinaryFlightDataParser
   bool m_CoincidenceEnabled;
   MModuleEventSaver* m_EventSaver;
 
-  //! internal event list - sorted but unmerged events
-  deque<MReadOutAssembly*> m_EventsBuf;//sorted, unmerged events
+  //! internal event list - sorted but unmerged events, one time-ordered stream per card cage
+  MEventStreamMerger m_EventsBuf;
   //! The internal event list - final merged events
   deque<MReadOutAssembly*> m_Events;
   //! If true ignore aspect information if not ready
   bool m_IgnoreAspect;
   //! Notify parser than we are done getting new data... this will result in some flushing
   bool m_IsDone;
-  uint32_t m_NumRawDataframes;
-  uint32_t m_NumComptonDataframes;
-  uint32_t m_NumAspectPackets;
-  uint32_t m_NumSettingsPackets;
-  uint32_t m_NumGCUHkpPackets;
-  uint32_t m_NumLivetimePackets;
-  uint32_t m_NumOtherPackets;  
+  //! The telemetry statistics: bytes, packets per type, parse errors and times, resyncs, events
+  MBinaryFlightDataParserStatistics m_Statistics;
  
   //! The housekeeping file name
   MString m_HousekeepingFileName;
+  //! True if the housekeeping is written as binary columnar file instead of text
+  bool m_BinaryHousekeeping;
+  //! The metrics file name - empty if no metrics are written
+  MString m_MetricsFileName;
+  //! The interval in seconds between two entries in the metrics file
+  double m_MetricsInterval;
   
   // private members:
  private:
@@ -146,12 +201,23 @@ class MBinaryFlightDataParser
   //added by AWL
   bool m_UseComptonDataframes;
   bool m_UseRawDataframes;
-  unsigned int MAX_TRIGS;
   unsigned long long m_EventTimeWindow;
   vector<uint64_t> LastTimestamps;
   uint64_t m_ComptonWindow;
-  vector<uint8_t> m_SBuf;//search buffer for the incoming TCP data stream
-  unsigned int dx; //index into search buffer
+  //! The search buffer for the incoming data stream: a ring buffer with a fixed capacity
+  vector<uint8_t> m_SBuf;
+  //! The stream position of the first not yet processed byte in the search buffer
+  uint64_t m_SBufBegin;
+  //! The stream position behind the last byte in the search buffer
+  uint64_t m_SBufEnd;
+  //! Packets wrapping around the end of the search buffer are copied here
+  vector<uint8_t> m_Stitch;
+  //! The capacity of the search buffer - a power of 2
+  static const size_t c_SBufCapacity = 1 << 22;
+  //! The maximum length of a packet
+  static const uint16_t c_MaxPacketLength = 1360;
+  //! The event stream of the Compton dataframes - streams 0 to 15 are the card cages
+  static const unsigned int c_ComptonStream = 16;
   unsigned int m_EventIDCounter;
   string m_LastDateTimeString;
   uint64_t m_LastCorrectedClk;
@@ -166,20 +232,93 @@ class MBinaryFlightDataParser
   MAspectPacket m_LastDSOPacket;
   uint32_t m_NumDSOReceived;
   uint64_t LastComptonTimestamp;
-  uint32_t m_NumComptonBytes;
-  uint32_t m_NumRawDataBytes;
-  uint32_t m_NumBytesReceived;
-  uint32_t m_LostBytes;
-  map<uint64_t,int> m_PacketRecord;
+  //! The filter for duplicate packets
+  MDuplicatePacketFilter m_PacketRecord;
+
+  //! The number of threads decoding dataframes (0: decode them in the parsing thread)
+  unsigned int m_NDecodeThreads;
+  //! The dataframe decoding threads
+  vector<thread> m_DecodeThreads;
+  //! The submitted dataframes of the current ParseData call in packet order
+  vector<decodejob*> m_DecodeJobs;
+  //! The index of the next submitted dataframe to decode
+  size_t m_NextDecodeJob;
+  //! Jobs for reuse
+  vector<decodejob*> m_FreeDecodeJobs;
+  //! The dataframe reused when decoding in the parsing thread
+  dataframe* m_Dataframe;
+  //! True if the decoding threads should stop
+  bool m_StopDecoding;
+  //! The mutex protecting the decoding jobs
+  mutex m_DecodeMutex;
+  //! Signals new jobs or the stop to the decoding threads
+  condition_variable m_DecodeCondition;
+  //! Signals a decoded dataframe
+  condition_variable m_DecodedCondition;
   vector<uint16_t> m_PreampTemps;
+  //! The most significant byte of the Unix time from the last GCU housekeeping packet
+  uint8_t m_GCUUnixTimeMSB;
+  //! True once a GCU housekeeping packet delivered the most significant byte of the Unix time
+  bool m_HasGCUUnixTimeMSB;
   
   //! The house-keeping file stream
   ofstream m_Housekeeping;
+  //! The binary house-keeping file
+  MHousekeepingWriter m_HousekeepingWriter;
+
+  //! The metrics file stream
+  ofstream m_Metrics;
+  //! The time the metrics file was opened
+  chrono::steady_clock::time_point m_MetricsStart;
+  //! The time of the last entry in the metrics file
+  chrono::steady_clock::time_point m_LastMetrics;
 
   int m_StripMap[8][10];
   int m_CCMap[12];
 
 public:
+  //! A read-only view of a packet - valid until the next packet is extracted
+  class packet{
+
+	  public:
+		  packet(const uint8_t* Data = nullptr, size_t Size = 0) : m_Data(Data), m_Size(Size) {}
+
+		  const uint8_t& operator[](size_t i) const { return m_Data[i]; }
+		  const uint8_t* data() const { return m_Data; }
+		  size_t size() const { return m_Size; }
+		  const uint8_t* begin() const { return m_Data; }
+		  const uint8_t* end() const { return m_Data + m_Size; }
+
+	  private:
+		  const uint8_t* m_Data;
+		  size_t m_Size;
+
+  };
+
+  //! A raw or Compton dataframe handed to the decoding threads
+  class decodejob{
+
+	  public:
+		  packet Packet;
+		  vector<uint8_t> Copy; //only used if the packet was stitched together
+		  uint8_t Type;
+		  vector<MReadOutAssembly*> Events;
+		  dataframe* Dataframe; //reused by all dataframes decoded in this job
+		  unsigned int Stream;
+		  bool HasError;
+		  bool IsDone;
+		  uint64_t DecodeTime; //ns spent in DecodeDataframe, in whichever thread decoded it
+
+  };
+
+  //! The maximum number of triggers of a raw event: 8 boards with 10 channels
+  static const unsigned int c_MaxTriggersPerEvent = 80;
+  //! The maximum number of events in a dataframe: an event takes at least 32 bytes in a raw
+  //! and at least 7 bytes in a 1360 byte Compton dataframe
+  static const unsigned int c_MaxEventsPerDataframe = 192;
+  //! The maximum number of triggers in a dataframe: each takes at least one byte
+  static const unsigned int c_MaxTriggersPerDataframe = 1360;
+
   class trigger{
 
 	  public:
@@ -208,8 +347,9 @@ public:
 		  uint8_t InternalCompton; 
 		  uint8_t Touchable; 
 
+		  //the triggers are stored in the trigger array of the dataframe
+		  uint32_t FirstTrigger;
 		  uint32_t NumTriggers;
-		  vector<trigger> Triggers;
 
 
 		  //below is stuff that only applies to compton events
@@ -236,28 +376,72 @@ public:
 		  uint8_t NumNoData;
 		  bool HasSysErr;
 
-		  uint32_t NumEvents; //the number of events which is <= 41
-		  vector<event> Events;
+		  uint32_t NumEvents; //the number of events which is <= 41 for raw dataframes
+		  event Events[c_MaxEventsPerDataframe];
+
+		  uint32_t NumTriggers; //the number of triggers of all events
+		  trigger Triggers[c_MaxTriggersPerDataframe];
 
 		  bool ParseError;
 
+		  //the dataframes are reused, thus reset them before decoding the next one
+		  void Reset() { NumEvents = 0; NumTriggers = 0; HasSysErr = false; ParseError = false; }
+
   };
 
   
  public:
-  int RawDataframe2Struct( vector<uint8_t> Buf, dataframe * DataOut);
-  bool ComptonDataframe2Struct( vector<uint8_t>& Buf, dataframe * DataOut); 
+  int RawDataframe2Struct( const packet& Buf, dataframe * DataOut);
+  bool ComptonDataframe2Struct( const packet& Buf, dataframe * DataOut); 
   bool ConvertToMReadOutAssemblys( dataframe * DataIn, vector<MReadOutAssembly*> * CEvents);
-  bool SortEventsBuf(void);
   bool FlushEventsBuf(void);
   bool CheckEventsBuf(void);
   MReadOutAssembly * MergeEvents( deque<MReadOutAssembly*> * EventList );
-  bool FindNextPacket( vector<uint8_t> & NextPacket, unsigned int * idx = NULL );
+  bool FindNextPacket( packet & NextPacket, uint64_t * Position = NULL );
   bool ResyncSBuf(void);
-  bool ProcessAspect( vector<uint8_t> & NextPacket );
-  bool ProcessAspect_works( vector<uint8_t> & NextPacket );
-  bool DecodeDSO( vector<uint8_t> & DSOString, MAspectPacket & DSO_Packet);
-  bool DecodeMag( vector<uint8_t> & MagString, MAspectPacket & Mag_Packet);
+  uint64_t FindSyncWord(uint64_t Position) const;
+  bool IsPlausibleHeader(uint64_t Position) const;
+  bool ProcessAspect( const packet & NextPacket );
+  bool ProcessAspect_works( const packet & NextPacket );
+  bool DecodeDSO( const packet & DSOString, MAspectPacket & DSO_Packet);
+  bool DecodeMag( const packet & MagString, MAspectPacket & Mag_Packet);
+  //! Decode the used fields of a GCU housekeeping packet: the most significant byte of the Unix time
+  //! and the shield count rate of the first sample - returns false if the packet is too short
+  bool DecodeGCUHousekeeping( const packet & Packet, uint8_t & UnixTimeMSB, double & ShieldCountRate ) const;
+  //! Decode the preamp temperatures of a GCU settings packet into m_PreampTemps - returns false if the packet is too short
+  bool DecodePreampTemperatures( const packet & Packet );
+
+  //! Return the byte at the given stream position in the search buffer
+  uint8_t SBufAt(uint64_t Position) const { return m_SBuf[Position & (c_SBufCapacity - 1)]; }
+  //! Return the number of not yet processed bytes in the search buffer
+  size_t GetSBufSize() const { return m_SBufEnd - m_SBufBegin; }
+  //! Append as much data to the search buffer as fits, return the number of appended bytes
+  size_t AppendToSBuf(const uint8_t* Data, size_t Size);
+
+  //! Return true if a text or binary housekeeping file is open
+  bool HasHousekeepingFile() const { return m_Housekeeping.is_open() == true || m_HousekeepingWriter.IsOpen() == true; }
+  //! Write a housekeeping record into the binary or the text housekeeping file
+  template<class Record> void WriteHousekeeping(const Record& R) {
+    if (m_HousekeepingWriter.IsOpen() == true) m_HousekeepingWriter.Add(R); else if (m_Housekeeping.is_open() == true) MHousekeepingBinary::WriteText(m_Housekeeping, R);
+  }
+
+  //! Append the statistics to the metrics file if the metrics interval has passed or if forced
+  void WriteMetrics(bool Force);
+
+  //! Add the events of one dataframe to the given stream of the time-sorted event buffer
+  void AddToEventsBuf(vector<MReadOutAssembly*>& NewEvents, unsigned int Stream);
+  //! Start the dataframe decoding threads
+  void StartDecodeThreads();
+  //! Stop the dataframe decoding threads and release all not yet collected events
+  void StopDecodeThreads();
+  //! Hand a raw or Compton dataframe to the decoding threads
+  void SubmitDataframe(const packet& Packet, uint8_t Type);
+  //! The loop of the decoding threads
+  void DecodeLoop();
+  //! Decode the dataframe of the job into read-out assemblies
+  void DecodeDataframe(decodejob* Job);
+  //! Wait for all submitted dataframes and add their events in packet order
+  void CollectDecodedDataframes();
 
 
   
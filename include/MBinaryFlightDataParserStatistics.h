@@ -0,0 +1,177 @@
+/*
+ * MBinaryFlightDataParserStatistics.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MBinaryFlightDataParserStatistics__
+#define __MBinaryFlightDataParserStatistics__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <cstdint>
+#include <ostream>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+#include "MString.h"
+
+// Nuclearizer libs:
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! The telemetry statistics of the binary flight data parser: bytes, packets and parse time per packet type,
+//! parse errors, resynchronizations, duplicates, emitted events, and the occupancy of the event merge window.
+//! All counters are 64 bit, thus they do not overflow during multi-GB runs.
+class MBinaryFlightDataParserStatistics
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MBinaryFlightDataParserStatistics();
+  //! Default destructor
+  virtual ~MBinaryFlightDataParserStatistics();
+
+  //! Reset all counters
+  void Clear();
+
+  //! Add received bytes
+  void AddBytesReceived(uint64_t Bytes) { m_NBytesReceived += Bytes; }
+  //! Add one packet of the given type with its size and the time it took to parse it
+  void AddPacket(uint8_t Type, uint64_t Bytes, uint64_t Nanoseconds);
+  //! Add parse time of a packet already counted, e.g. its decoding in another thread
+  void AddParseTime(uint8_t Type, uint64_t Nanoseconds) { m_ParseTime[Type & c_TypeMask] += Nanoseconds; }
+  //! Add a packet of the given type which could not be parsed
+  void AddParseError(uint8_t Type) { ++m_NParseErrors[Type & c_TypeMask]; }
+  //! Add one resynchronization of the input stream
+  void AddResync() { ++m_NResyncs; }
+  //! Add bytes which were skipped since they did not belong to any packet
+  void AddLostBytes(uint64_t Bytes) { m_NLostBytes += Bytes; }
+  //! Add events handed on to the pipeline
+  void AddEventsEmitted(uint64_t NEvents) { m_NEventsEmitted += NEvents; }
+  //! Add one sample of the number of events in the merge window
+  void AddMergeWindowOccupancy(uint64_t NEvents);
+
+  //! Set the number of duplicate packets
+  void SetNDuplicates(uint64_t NDuplicates) { m_NDuplicates = NDuplicates; }
+  //! Set the number of events which arrived out of order in their card cage stream
+  void SetNLateEvents(uint64_t NLateEvents) { m_NLateEvents = NLateEvents; }
+
+  //! Return the number of received bytes
+  uint64_t GetNBytesReceived() const { return m_NBytesReceived; }
+  //! Return the number of packets of the given type
+  uint64_t GetNPackets(uint8_t Type) const { return m_NPackets[Type & c_TypeMask]; }
+  //! Return the number of bytes in packets of the given type
+  uint64_t GetNPacketBytes(uint8_t Type) const { return m_NPacketBytes[Type & c_TypeMask]; }
+  //! Return the summed parse time of packets of the given type in ns - with decoding threads this is CPU time
+  uint64_t GetParseTime(uint8_t Type) const { return m_ParseTime[Type & c_TypeMask]; }
+  //! Return the number of packets of the given type which could not be parsed
+  uint64_t GetNParseErrors(uint8_t Type) const { return m_NParseErrors[Type & c_TypeMask]; }
+  //! Return the number of packets of all types
+  uint64_t GetNPackets() const;
+  //! Return the number of packets of all types which could not be parsed
+  uint64_t GetNParseErrors() const;
+  //! Return the number of packets of types the parser does not handle
+  uint64_t GetNOtherPackets() const;
+  //! Return the number of resynchronizations
+  uint64_t GetNResyncs() const { return m_NResyncs; }
+  //! Return the number of bytes which did not belong to any packet
+  uint64_t GetNLostBytes() const { return m_NLostBytes; }
+  //! Return the number of duplicate packets
+  uint64_t GetNDuplicates() const { return m_NDuplicates; }
+  //! Return the number of events which arrived out of order in their card cage stream
+  uint64_t GetNLateEvents() const { return m_NLateEvents; }
+  //! Return the number of events handed on to the pipeline
+  uint64_t GetNEventsEmitted() const { return m_NEventsEmitted; }
+  //! Return the mean number of events in the merge window
+  double GetMeanMergeWindowOccupancy() const { return (m_NMergeWindowSamples > 0) ? double(m_MergeWindowSum)/m_NMergeWindowSamples : 0.0; }
+  //! Return the maximum number of events in the merge window
+  uint64_t GetMaxMergeWindowOccupancy() const { return m_MergeWindowMax; }
+  //! Return the last number of events in the merge window
+  uint64_t GetMergeWindowOccupancy() const { return m_MergeWindowLast; }
+
+  //! Return the name of the packet type
+  static MString GetTypeName(uint8_t Type);
+  //! Return the number of packet types
+  static unsigned int GetNTypes() { return c_NTypes; }
+
+  //! Stream the statistics as one line of JSON with the given time stamp in seconds
+  void StreamJson(ostream& out, double Time) const;
+
+
+  // protected methods:
+ protected:
+
+  // private methods:
+ private:
+
+
+
+  // protected members:
+ protected:
+  //! The number of packet types - the type is the lower nibble of byte 2 of the header
+  static const unsigned int c_NTypes = 16;
+  //! The mask of the packet type
+  static const uint8_t c_TypeMask = 0x0f;
+
+  //! The number of received bytes
+  uint64_t m_NBytesReceived;
+  //! The number of packets per type
+  uint64_t m_NPackets[c_NTypes];
+  //! The number of bytes per type
+  uint64_t m_NPacketBytes[c_NTypes];
+  //! The parse time per type in ns
+  uint64_t m_ParseTime[c_NTypes];
+  //! The parse errors per type
+  uint64_t m_NParseErrors[c_NTypes];
+  //! The number of resynchronizations
+  uint64_t m_NResyncs;
+  //! The number of bytes which did not belong to any packet
+  uint64_t m_NLostBytes;
+  //! The number of duplicate packets
+  uint64_t m_NDuplicates;
+  //! The number of events out of order in their card cage stream
+  uint64_t m_NLateEvents;
+  //! The number of events handed on
+  uint64_t m_NEventsEmitted;
+
+  //! The number of merge window samples
+  uint64_t m_NMergeWindowSamples;
+  //! The summed merge window occupancy
+  uint64_t m_MergeWindowSum;
+  //! The maximum merge window occupancy
+  uint64_t m_MergeWindowMax;
+  //! The last merge window occupancy
+  uint64_t m_MergeWindowLast;
+
+
+  // private members:
+ private:
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MBinaryFlightDataParserStatistics, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
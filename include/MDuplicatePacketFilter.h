@@ -0,0 +1,111 @@
+/*
+ * MDuplicatePacketFilter.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MDuplicatePacketFilter__
+#define __MDuplicatePacketFilter__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+
+// Nuclearizer libs:
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Remembers the keys of the last N packets to filter duplicates, e.g. from redundant downlinks.
+//! The keys live in an open-addressing hash set (linear probing) of fixed size, and a ring of
+//! the keys in arrival order evicts the oldest one once N keys are stored. Thus a look-up is
+//! O(1) and nothing is allocated after construction.
+class MDuplicatePacketFilter
+{
+  // public interface:
+ public:
+  //! Default constructor - remembers the last Capacity keys
+  MDuplicatePacketFilter(unsigned int Capacity = 10000);
+  //! Default destructor
+  virtual ~MDuplicatePacketFilter();
+
+  //! Forget all keys and reset the counters
+  void Clear();
+
+  //! Return true if the key is among the remembered ones (a duplicate), otherwise remember it
+  bool IsDuplicate(uint64_t Key);
+
+  //! Return the number of duplicates found
+  uint64_t GetNHits() const { return m_NHits; }
+  //! Return the number of new keys
+  uint64_t GetNMisses() const { return m_NMisses; }
+
+
+  // protected methods:
+ protected:
+  //! Return the home slot of a stored value
+  size_t GetSlot(uint64_t Value) const { return (Value * 0x9E3779B97F4A7C15ULL) >> m_Shift; }
+  //! Remove a stored value from the hash table, keeping the probe sequences intact
+  void Remove(uint64_t Value);
+
+
+  // private methods:
+ private:
+
+
+
+  // protected members:
+ protected:
+  //! The hash table - the stored values are key + 1, thus 0 marks an empty slot
+  vector<uint64_t> m_Table;
+  //! The mask for the slot indices
+  size_t m_Mask;
+  //! The shift for the multiplicative hash
+  unsigned int m_Shift;
+
+  //! The remembered values in arrival order
+  vector<uint64_t> m_Order;
+  //! The position of the oldest value in m_Order
+  size_t m_Oldest;
+  //! The number of remembered values
+  size_t m_Size;
+
+  //! The number of duplicates
+  uint64_t m_NHits;
+  //! The number of new keys
+  uint64_t m_NMisses;
+
+
+  // private members:
+ private:
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MDuplicatePacketFilter, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,126 @@
+/*
+ * MEventStreamMerger.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MEventStreamMerger__
+#define __MEventStreamMerger__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+#include <deque>
+#include <cstdint>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+
+// Nuclearizer libs:
+#include "MReadOutAssembly.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Merges several nearly time-ordered event streams (e.g. one per card cage) into one time-ordered stream.
+//! Each stream is a queue sorted by clock value: events arriving in order are appended, late ones are
+//! sorted in from the back. A min-heap over the oldest event of each stream yields the globally
+//! oldest event in O(log k) for k streams, thus nothing is ever re-sorted as a whole.
+class MEventStreamMerger
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MEventStreamMerger(unsigned int NStreams = 17);
+  //! Default destructor - releases all events
+  virtual ~MEventStreamMerger();
+
+  //! Add an event to the given stream
+  void Add(MReadOutAssembly* Event, unsigned int Stream);
+
+  //! Return the oldest event of all streams without removing it (nullptr if there is none)
+  MReadOutAssembly* GetOldest() const { return (m_Heap.empty() == true) ? nullptr : m_Streams[m_Heap[0]].front(); }
+  //! Remove and return the oldest event of all streams (nullptr if there is none)
+  MReadOutAssembly* PopOldest();
+
+  //! Return the clock value of the newest event (only valid if there are events)
+  uint64_t GetNewestCL() const { return m_NewestCL; }
+
+  //! Return the number of events in all streams
+  size_t GetNEvents() const { return m_NEvents; }
+  //! Return true if there are no events
+  bool IsEmpty() const { return m_NEvents == 0; }
+
+  //! Release all events back to the object pool
+  void Clear();
+
+  //! Return the number of events which arrived later than their stream's newest event
+  uint64_t GetNLateEvents() const { return m_NLateEvents; }
+
+
+  // protected methods:
+ protected:
+  //! Return the heap key of a stream: the clock value of its oldest event
+  uint64_t GetKey(unsigned int Stream) const { return m_Streams[Stream].front()->GetCL(); }
+  //! Move the heap element at position i up until the heap is valid again
+  void SiftUp(size_t i);
+  //! Move the heap element at position i down until the heap is valid again
+  void SiftDown(size_t i);
+  //! Swap two heap elements
+  void Swap(size_t i, size_t j);
+
+
+  // private methods:
+ private:
+
+
+
+  // protected members:
+ protected:
+  //! Late events are sorted in by a linear search over this many events from the back, then by bisection
+  static const unsigned int c_InsertionWindow = 64;
+
+  //! The time-ordered event streams
+  vector<deque<MReadOutAssembly*>> m_Streams;
+  //! The min-heap of the non-empty streams
+  vector<unsigned int> m_Heap;
+  //! The position of each stream in the heap, -1 if the stream is empty
+  vector<int> m_HeapPosition;
+
+  //! The number of events in all streams
+  size_t m_NEvents;
+  //! The clock value of the newest event
+  uint64_t m_NewestCL;
+  //! The number of late events
+  uint64_t m_NLateEvents;
+
+
+  // private members:
+ private:
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MEventStreamMerger, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
@@ -16,6 +16,10 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 
+// Standard libs:
+#include <vector>
+using namespace std;
+
 // ROOT libs:
 #include <TROOT.h>
 #include <TVirtualX.h>
@@ -68,6 +72,8 @@ class MGUIExpoEnergyCalibration : public MGUIExpo
 
   //! Add data to the energy histogram
   void AddEnergy(double Energy);
+  //! Add many energies to the energy histogram with one lock
+  void AddEnergies(const vector<double>& Energies);
 
   // protected methods:
  protected:
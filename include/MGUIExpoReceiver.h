@@ -28,9 +28,11 @@
 // MEGAlib libs:
 #include "MGlobal.h"
 #include "MTime.h"
+#include "MTimer.h"
 #include "MGUIExpo.h"
 
 // Nuclearizer libs
+#include "MBinaryFlightDataParserStatistics.h"
 
 // Forward declarations:
 
@@ -62,24 +64,18 @@ class MGUIExpoReceiver : public MGUIExpo
   //! Set the time the last event was received
   void SetTimeReceived(MTime Time);
 
-  //! Set the amount of data received
-  void SetBytesReceived(long Bytes);
+  //! Set the current parser statistics - the rates are derived from the change between two updates
+  void SetStatistics(const MBinaryFlightDataParserStatistics& Statistics);
 
-  //! Set the number of raw data frames parsed
-  void SetRawFramesParsed(long Frames);
-
-  //! Set the number of Compton data frames parsed
-  void SetComptonFramesParsed(long Frames);
-
-  //! Set the number of aspect data frames parsed
-  void SetAspectFramesParsed(long Frames);
-
-  //! Set thenumber of other data frames parsed
-  void SetOtherFramesParsed(long Frames);
+  //! Set the state of the queue between receive thread and parser: current and largest occupancy,
+  //! capacity, how often it was full, and how long the receive thread waited in total in seconds
+  void SetReceiveQueue(uint64_t Size, uint64_t MaxSize, uint64_t Capacity, uint64_t NFull, double StallTime);
 
 
   // protected methods:
  protected:
+  //! Create one row of the matrix: a description and a label showing the value
+  TGLabel* CreateRow(TGCompositeFrame* Frame, const MString& Description);
 
 
   // protected members:
@@ -92,30 +88,45 @@ class MGUIExpoReceiver : public MGUIExpo
   //! The label showing the time received
   TGLabel* m_TimeLabel;
   
-  //! The total amount of data received
-  long m_BytesReceived;
-  //! The label showing the amount received
+  //! The current parser statistics
+  MBinaryFlightDataParserStatistics m_Statistics;
+  //! The parser statistics at the last update - the base of the rates
+  MBinaryFlightDataParserStatistics m_LastStatistics;
+  //! The time since the last update
+  MTimer m_UpdateTimer;
+
+  //! The number of blocks in the receive queue
+  uint64_t m_QueueSize;
+  //! The largest number of blocks in the receive queue
+  uint64_t m_QueueMaxSize;
+  //! The capacity of the receive queue
+  uint64_t m_QueueCapacity;
+  //! How often the receive queue was full
+  uint64_t m_QueueNFull;
+  //! How long the receive thread waited for a free slot in seconds
+  double m_QueueStallTime;
+
+  //! The label showing the amount of data received
   TGLabel* m_BytesReceivedLabel;
-  
-  //! The total number of raw data frames parsed
-  long m_RawFramesParsed;
-  //! The label showing the number of raw data frames parsed
-  TGLabel* m_RawFramesLabel;
-  
-  //! The total number of Compton data frames parsed
-  long m_ComptonFramesParsed;
-  //! The label showing the number of Compton data frames parsed
-  TGLabel* m_ComptonFramesLabel;
-  
-  //! The total number of aspect data frames parsed
-  long m_AspectFramesParsed;
-  //! The label showing the number of aspect data frames parsed
-  TGLabel* m_AspectFramesLabel;
-  
-  //! The total number of other data frames parsed
-  long m_OtherFramesParsed;
-  //! The label showing the number of other data frames parsed
-  TGLabel* m_OtherFramesLabel;
+  //! The label showing the state of the receive queue
+  TGLabel* m_ReceiveQueueLabel;
+  //! The label showing the bytes which did not belong to any packet and the number of resyncs
+  TGLabel* m_LostBytesLabel;
+  //! The label showing the number of duplicate packets
+  TGLabel* m_DuplicatesLabel;
+  //! The label showing the number of parse errors
+  TGLabel* m_ParseErrorsLabel;
+  //! The label showing the number of events handed on
+  TGLabel* m_EventsEmittedLabel;
+  //! The label showing the occupancy of the merge window
+  TGLabel* m_MergeWindowLabel;
+
+  //! The packet types with an own row
+  static const uint8_t c_PacketTypes[6];
+  //! The labels showing count, rate and parse time of the packet types with an own row
+  TGLabel* m_PacketLabels[6];
+  //! The label showing the number of packets of all other types
+  TGLabel* m_OtherPacketsLabel;
 
   
 #ifdef ___CLING___
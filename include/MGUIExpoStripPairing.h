@@ -16,6 +16,10 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 
+// Standard libs:
+#include <vector>
+using namespace std;
+
 // ROOT libs:
 #include <TROOT.h>
 #include <TVirtualX.h>
@@ -68,6 +72,8 @@ class MGUIExpoStripPairing : public MGUIExpo
 
   //! Add data to the energy histogram
   void AddEnergies(double pEnergy, double nEnergy);
+  //! Add many energy pairs to the energy histogram with one lock
+  void AddEnergies(const vector<double>& pEnergies, const vector<double>& nEnergies);
 
   // protected methods:
  protected:
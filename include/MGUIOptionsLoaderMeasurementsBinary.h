@@ -31,6 +31,7 @@
 #include "MGUIEFileSelector.h"
 #include "MGUIOptions.h"
 #include "MGUIERBList.h"
+#include "MGUIEEntry.h"
 
 // Nuclearizer libs:
 #include "MModule.h"
@@ -74,6 +75,18 @@ class MGUIOptionsLoaderMeasurementsBinary : public MGUIOptions
   MGUIERBList* m_DataMode;
   MGUIERBList* m_AspectMode;
   MGUIERBList* m_CoincidenceMode;
+  //! The number of dataframe decoding threads
+  MGUIEEntry* m_DecodeThreads;
+  //! The start of the time range to read
+  MGUIEEntry* m_StartTime;
+  //! The stop of the time range to read
+  MGUIEEntry* m_StopTime;
+  //! The warm-up time before the time range
+  MGUIEEntry* m_WarmUpTime;
+  //! Read the files of a file list concurrently
+  TGCheckButton* m_ReadFilesConcurrently;
+  //! Write the housekeeping as binary columnar file
+  TGCheckButton* m_BinaryHousekeeping;
 
 
 #ifdef ___CLING___
@@ -82,6 +82,10 @@ class MGUIOptionsReceiverBalloon : public MGUIOptions
 
   //! Select if we save the file to roa
   MGUIEFileSelector* m_FileSelector;
+  //! Select the metrics file
+  MGUIEFileSelector* m_MetricsFileSelector;
+  //! The interval between two metrics entries
+  MGUIEEntry* m_MetricsInterval;
   
   #ifdef ___CLING___
  public:
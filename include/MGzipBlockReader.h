@@ -0,0 +1,131 @@
+/*
+ * MGzipBlockReader.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MGzipBlockReader__
+#define __MGzipBlockReader__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+using namespace std;
+
+// ROOT libs:
+#include "zlib.h"
+
+// MEGAlib libs:
+#include "MGlobal.h"
+#include "MString.h"
+
+// Nuclearizer libs:
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Reads a gzip'ed file block-wise on a background thread.
+//! The inflate thread fills two blocks in turn with gzread, while the caller parses the
+//! other one, thus decompression and parsing overlap. A block handed out by Read() stays
+//! valid until the next call to Read() or Close().
+class MGzipBlockReader
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MGzipBlockReader();
+  //! Default destructor - closes the file
+  virtual ~MGzipBlockReader();
+
+  //! Open the file and start the inflate thread, return false on error
+  bool Open(const MString& FileName);
+  //! Stop the inflate thread and close the file
+  void Close();
+  //! Return true if a file is open
+  bool IsOpen() const { return m_File != NULL; }
+
+  //! Return the next decompressed block in Data and its size, 0 at the end of the file or on error
+  size_t Read(const uint8_t*& Data);
+
+  //! Return true if decompression failed (e.g. a truncated or corrupt file)
+  bool HasError() const;
+
+  //! The size of the decompressed blocks
+  static const size_t c_BlockSize = 1000000;
+
+
+  // protected methods:
+ protected:
+  //! The inflate thread: fill the free block until the end of the file
+  void Inflate();
+
+
+  // private methods:
+ private:
+  //! No copies of the thread and file handles
+  MGzipBlockReader(const MGzipBlockReader&) = delete;
+  MGzipBlockReader& operator=(const MGzipBlockReader&) = delete;
+
+
+
+  // protected members:
+ protected:
+  //! The zlib file handle
+  gzFile m_File;
+  //! The inflate thread
+  thread m_Thread;
+
+  //! The double buffer
+  vector<uint8_t> m_Blocks[2];
+  //! The number of bytes in the blocks
+  size_t m_BlockSizes[2];
+  //! The number of blocks filled by the inflate thread
+  unsigned long m_NProduced;
+  //! The number of blocks given back by the reader
+  unsigned long m_NConsumed;
+  //! True if a block is currently handed out to the reader
+  bool m_IsHandedOut;
+
+  //! True if the inflate thread reached the end of the file
+  bool m_IsEndOfFile;
+  //! True if decompression failed
+  bool m_HasError;
+  //! True if the inflate thread should stop
+  bool m_Stop;
+
+  //! The mutex protecting the block book keeping
+  mutable mutex m_Mutex;
+  //! Signals a freshly filled or a freshly freed block
+  condition_variable m_Condition;
+
+
+  // private members:
+ private:
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MGzipBlockReader, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
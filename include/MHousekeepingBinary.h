@@ -0,0 +1,176 @@
+/*
+ * MHousekeepingBinary.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MHousekeepingBinary__
+#define __MHousekeepingBinary__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+#include <cstdint>
+#include <ostream>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+#include "MString.h"
+
+// Nuclearizer libs:
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! The records and the file format of the binary columnar housekeeping files (".hkb"),
+//! the compact alternative to the text housekeeping files (".hkp").
+//!
+//! The file starts with an 8 byte magic followed by groups of column blocks. A group contains one block
+//! per record type with at least one record and ends with an end-of-group block. A block consists of
+//! the type (1 byte) and the number of records N (4 bytes) followed by the columns, each N
+//! little-endian values. Every record carries its sequence number in the file, which restores the
+//! original order of the records of the different types within a group.
+class MHousekeepingBinary
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MHousekeepingBinary();
+  //! Default destructor
+  virtual ~MHousekeepingBinary();
+
+  //! The aspect record ("ASP" in the text form)
+  class aspect {
+   public:
+    //! The sequence number of the record in the file
+    uint64_t Sequence;
+    //! The UTC time: seconds and nanoseconds
+    uint32_t Seconds;
+    uint32_t NanoSeconds;
+    //! 0 for GPS, 1 for magnetometer
+    int32_t Mode;
+    //! Galactic pointing of the x-axis
+    double GXLongitude;
+    double GXLatitude;
+    //! Galactic pointing of the z-axis
+    double GZLongitude;
+    double GZLatitude;
+    //! The coordinates
+    double Latitude;
+    double Longitude;
+    double Altitude;
+    //! The orientation
+    double Heading;
+    double Pitch;
+    double Roll;
+  };
+
+  //! The card cage livetime record ("LT" in the text form)
+  class livetime {
+   public:
+    //! The sequence number of the record in the file
+    uint64_t Sequence;
+    //! The full Unix time
+    uint32_t UnixTime;
+    //! The packet counter
+    uint16_t PacketCounter;
+    //! 1 if the card cage reported its livetime
+    uint8_t HasLivetime[12];
+    //! The livetime in units of 1/3051 s
+    uint16_t Livetime[12];
+  };
+
+  //! The GCU housekeeping record ("HKP" in the text form)
+  class gcuhousekeeping {
+   public:
+    //! The sequence number of the record in the file
+    uint64_t Sequence;
+    //! The full Unix time
+    uint32_t UnixTime;
+    //! The packet counter
+    uint16_t PacketCounter;
+    //! The shield count rate
+    double ShieldCountRate;
+  };
+
+  //! Write the record in the text form of the ".hkp" files
+  static void WriteText(ostream& out, const aspect& A);
+  //! Write the record in the text form of the ".hkp" files
+  static void WriteText(ostream& out, const livetime& L);
+  //! Write the record in the text form of the ".hkp" files
+  static void WriteText(ostream& out, const gcuhousekeeping& G);
+
+  //! Return the aspect records of the current group
+  const vector<aspect>& GetAspects() const { return m_Aspects; }
+  //! Return the livetime records of the current group
+  const vector<livetime>& GetLivetimes() const { return m_Livetimes; }
+  //! Return the GCU housekeeping records of the current group
+  const vector<gcuhousekeeping>& GetGCUHousekeeping() const { return m_GCUHousekeeping; }
+
+
+  // protected methods:
+ protected:
+  //! Return the number of bytes of N records of the given block type in the file - 0 if the type is unknown
+  static uint64_t GetBlockSize(uint8_t Type, uint64_t N);
+
+
+  // private methods:
+ private:
+
+
+
+  // protected members:
+ protected:
+  //! The aspect records of the current group
+  vector<aspect> m_Aspects;
+  //! The livetime records of the current group
+  vector<livetime> m_Livetimes;
+  //! The GCU housekeeping records of the current group
+  vector<gcuhousekeeping> m_GCUHousekeeping;
+
+  //! The magic at the beginning of the file
+  static const char c_Magic[8];
+
+  //! The block types
+  static const uint8_t c_EndOfGroup = 0;
+  static const uint8_t c_Aspect = 1;
+  static const uint8_t c_Livetime = 2;
+  static const uint8_t c_GCUHousekeeping = 3;
+
+  //! The size of a block header: type and number of records
+  static const unsigned int c_BlockHeaderSize = 5;
+  //! The size of one record of each type in the file
+  static const unsigned int c_AspectSize = 8 + 4 + 4 + 4 + 10*8;
+  static const unsigned int c_LivetimeSize = 8 + 4 + 2 + 12*1 + 12*2;
+  static const unsigned int c_GCUHousekeepingSize = 8 + 4 + 2 + 8;
+
+
+  // private members:
+ private:
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MHousekeepingBinary, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
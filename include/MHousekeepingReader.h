@@ -0,0 +1,111 @@
+/*
+ * MHousekeepingReader.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MHousekeepingReader__
+#define __MHousekeepingReader__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+#include <fstream>
+#include <ostream>
+#include <cstdint>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+#include "MString.h"
+
+// Nuclearizer libs:
+#include "MHousekeepingBinary.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Reads a binary columnar housekeeping file group by group.
+//! After each ReadGroup() the records of the group are available via GetAspects(), GetLivetimes()
+//! and GetGCUHousekeeping(), and WriteGroupText() writes them in the text form of the ".hkp" files.
+class MHousekeepingReader : public MHousekeepingBinary
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MHousekeepingReader();
+  //! Default destructor
+  virtual ~MHousekeepingReader();
+
+  //! Open the file and check its magic
+  bool Open(const MString& FileName);
+  //! Close the file
+  void Close();
+
+  //! Read the next group of records - returns false at the end of the file or on error
+  bool ReadGroup();
+  //! Return true if the file is corrupt or truncated
+  bool HasError() const { return m_HasError; }
+
+  //! Write the records of the current group in their original order in the text form of the ".hkp" files
+  void WriteGroupText(ostream& out) const;
+
+
+  // protected methods:
+ protected:
+  //! Read and decode one column block with N records of the given type
+  bool ReadBlock(uint8_t Type, uint64_t N);
+  //! Return the next NBytes bytes of the block buffer as little-endian value
+  uint64_t Get(unsigned int NBytes);
+  //! Return the next 8 bytes of the block buffer as little-endian double
+  double GetDouble();
+
+
+  // private methods:
+ private:
+
+
+
+  // protected members:
+ protected:
+  //! The input file
+  ifstream m_In;
+  //! The bytes of the current block
+  vector<uint8_t> m_Bytes;
+  //! The read position in the current block
+  size_t m_Position;
+  //! True if the file is corrupt or truncated
+  bool m_HasError;
+
+  //! The maximum number of records per block accepted when reading
+  static const uint64_t c_MaxBlockRecords = 1 << 24;
+
+
+  // private members:
+ private:
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MHousekeepingReader, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,112 @@
+/*
+ * MHousekeepingWriter.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MHousekeepingWriter__
+#define __MHousekeepingWriter__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+#include <fstream>
+#include <cstdint>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+#include "MString.h"
+
+// Nuclearizer libs:
+#include "MHousekeepingBinary.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Writes housekeeping records into a binary columnar housekeeping file.
+//! The records are collected in memory and written as one group of column blocks
+//! once c_GroupSize records have been added, thus the file is touched only rarely.
+class MHousekeepingWriter : public MHousekeepingBinary
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MHousekeepingWriter();
+  //! Default destructor - closes the file
+  virtual ~MHousekeepingWriter();
+
+  //! Open the file for writing - an already open file is closed first
+  bool Open(const MString& FileName);
+  //! Return true if the file is open
+  bool IsOpen() const { return m_Out.is_open(); }
+  //! Write all not yet written records and close the file
+  void Close();
+
+  //! Add an aspect record - its sequence number is set by the writer
+  void Add(const aspect& A);
+  //! Add a livetime record - its sequence number is set by the writer
+  void Add(const livetime& L);
+  //! Add a GCU housekeeping record - its sequence number is set by the writer
+  void Add(const gcuhousekeeping& G);
+
+  //! Write all collected records as one group
+  bool Flush();
+
+
+  // protected methods:
+ protected:
+  //! Flush if enough records have been collected
+  void FlushIfFull();
+  //! Append the lowest NBytes bytes of the value little-endian to the output buffer
+  void Put(uint64_t Value, unsigned int NBytes);
+  //! Append a double little-endian to the output buffer
+  void PutDouble(double Value);
+
+
+  // private methods:
+ private:
+
+
+
+  // protected members:
+ protected:
+  //! The output file
+  ofstream m_Out;
+  //! The output buffer of one group
+  vector<uint8_t> m_Bytes;
+  //! The number of records added since opening the file
+  uint64_t m_NRecords;
+
+  //! The number of records per group
+  static const unsigned int c_GroupSize = 4096;
+
+
+  // private members:
+ private:
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MHousekeepingWriter, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
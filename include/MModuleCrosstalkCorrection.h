@@ -24,6 +24,7 @@
 // MEGAlib libs:
 #include "MGlobal.h"
 #include "MModule.h"
+#include "MBatchAnalyzer.h"
 
 
 // Forward declarations:
@@ -32,7 +33,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 
-class MModuleCrosstalkCorrection : public MModule
+class MModuleCrosstalkCorrection : public MModule, public MBatchAnalyzer
 {
   // public interface:
  public:
@@ -56,6 +57,8 @@ class MModuleCrosstalkCorrection : public MModule
 
   //! Main data analysis routine, which updates the event to a new level 
   virtual bool AnalyzeEvent(MReadOutAssembly* Event);
+  //! This module carries no state between events and can be replicated
+  virtual bool IsReplicable() const { return true; }
 
   //! Show the options GUI
   virtual void ShowOptionsGUI();
@@ -74,8 +77,8 @@ class MModuleCrosstalkCorrection : public MModule
 
   // private methods:
  private:
-  // Method to make the cross-talk correction on a vector of strip hits
-  virtual void CorrectCrosstalk(vector<MStripHit*> StripHits, int det, unsigned int side);
+  // Method to make the cross-talk correction on the strip hits [Begin, End) of one detector side
+  virtual void CorrectCrosstalk(MStripHitArrays& A, unsigned int Begin, unsigned int End, int det, unsigned int side);
 
 
   // protected members:
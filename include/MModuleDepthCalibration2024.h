@@ -27,6 +27,7 @@
 // MEGAlib libs:
 #include "MGlobal.h"
 #include "MModule.h"
+#include "MBatchAnalyzer.h"
 #include "MModuleEnergyCalibrationUniversal.h"
 #include "MDStrip3D.h"
 #include "MDShapeBRIK.h"
@@ -37,7 +38,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 
-class MModuleDepthCalibration2024 : public MModule
+class MModuleDepthCalibration2024 : public MModule, public MBatchAnalyzer
 {
   // public interface:
  public:
@@ -54,6 +55,10 @@ class MModuleDepthCalibration2024 : public MModule
 
   //! Main data analysis routine, which updates the event to a new level 
   virtual bool AnalyzeEvent(MReadOutAssembly* Event);
+  //! This module carries no state between events and can be replicated
+  virtual bool IsReplicable() const { return true; }
+  //! Add the hit counters of a replica
+  virtual void MergeReplica(MBatchAnalyzer* Replica);
 
   //! Show the options GUI
   virtual void ShowOptionsGUI();
@@ -93,11 +98,11 @@ class MModuleDepthCalibration2024 : public MModule
   //! Returns the strip with most energy from vector Strips, also gives back the energy fraction
   MStripHit* GetDominantStrip(std::vector<MStripHit*>& Strips, double& EnergyFraction);
   //! Retrieve the appropriate Depth values given the DetID
-	vector<double> GetDepth(int DetID);
+	const vector<double>& GetDepth(int DetID);
   //! Retrieve the appropriate CTD values given the DetID and Grade
-  vector<double> GetCTD(int DetID, int Grade);
+  const vector<double>& GetCTD(int DetID, int Grade);
   //! Normal distribution
-  vector<double> norm_pdf(vector<double> x, double mu, double sigma);
+  vector<double> norm_pdf(const vector<double>& x, double mu, double sigma);
 	//! Adds a Depth-to-CTD relation
 	bool AddDepthCTD(vector<double> depthvec, vector<vector<double>> ctdarr, int DetID, unordered_map<int, vector<double>>& DepthGrid, unordered_map<int,vector<vector<double>>>& CTDMap);
   //! Determine the Grade (geometry of charge sharing) of the Hit
@@ -29,6 +29,7 @@
 #include "MModule.h"
 #include "MCalibratorEnergy.h"
 #include "MGUIExpoEnergyCalibration.h"
+#include "MBatchAnalyzer.h"
 
 // Forward declarations:
 
@@ -36,7 +37,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 //! A universal energy calibrator
-class MModuleEnergyCalibrationUniversal : public MModule
+class MModuleEnergyCalibrationUniversal : public MModule, public MBatchAnalyzer
 {
   // public interface:
  public:
@@ -69,6 +70,10 @@ class MModuleEnergyCalibrationUniversal : public MModule
 
   //! Main data analysis routine, which updates the event to a new level 
   virtual bool AnalyzeEvent(MReadOutAssembly* Event);
+  //! Analyze a batch of events - the energy histogram of the expo is updated once per batch
+  virtual void AnalyzeEvents(vector<MReadOutAssembly*>& Events, vector<bool>& Results);
+  //! This module carries no state between events and can be replicated
+  virtual bool IsReplicable() const { return true; }
 
   //! Show the options GUI
   virtual void ShowOptionsGUI();
@@ -105,7 +110,8 @@ class MModuleEnergyCalibrationUniversal : public MModule
 
   // private methods:
  private:
-
+  //! Calibrate one event, the energies for the expo are appended to m_ExpoEnergies
+  bool Calibrate(MReadOutAssembly* Event);
 
 
   // protected members:
@@ -115,6 +121,8 @@ class MModuleEnergyCalibrationUniversal : public MModule
  private:
   //! A GUI to display the final energy histogram
   MGUIExpoEnergyCalibration* m_ExpoEnergyCalibration;
+  //! The energies waiting to be added to the expo
+  vector<double> m_ExpoEnergies;
    
   //! Calibrators arranged by detectors
   //vector<vector<MCalibratorEnergy*> > m_Calibrators;
@@ -27,6 +27,7 @@
 // MEGAlib libs:
 #include "MGlobal.h"
 #include "MModule.h"
+#include "MBatchAnalyzer.h"
 #include "MVector.h"
 
 // Forward declarations:
@@ -35,7 +36,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 
-class MModuleEventFilter : public MModule
+class MModuleEventFilter : public MModule, public MBatchAnalyzer
 {
   // public interface:
  public:
@@ -55,6 +56,8 @@ class MModuleEventFilter : public MModule
 
   //! Main data analysis routine, which updates the event to a new level 
   virtual bool AnalyzeEvent(MReadOutAssembly* Event);
+  //! This module carries no state between events and can be replicated
+  virtual bool IsReplicable() const { return true; }
 
   //! Show the options GUI
   virtual void ShowOptionsGUI();
@@ -18,6 +18,7 @@
 
 // Standard libs:
 #include <fstream>
+#include <sstream>
 using namespace std;
 
 // ROOT libs:
@@ -29,6 +30,7 @@ using namespace std;
 
 // Nuclearizer libs:
 #include "MModule.h"
+#include "MBatchAnalyzer.h"
 
 // Forward declarations:
 
@@ -36,7 +38,7 @@ using namespace std;
 ////////////////////////////////////////////////////////////////////////////////
 
 
-class MModuleEventSaver : public MModule
+class MModuleEventSaver : public MModule, public MBatchAnalyzer
 {
   // public interface:
  public:
@@ -91,6 +93,8 @@ class MModuleEventSaver : public MModule
 
   //! Main data analysis routine, which updates the event to a new level 
   virtual bool AnalyzeEvent(MReadOutAssembly* Event);
+  //! Analyze a batch of events - the whole batch is written to disk with one write
+  virtual void AnalyzeEvents(vector<MReadOutAssembly*>& Events, vector<bool>& Results);
 
   //! Show the options GUI
   virtual void ShowOptionsGUI();
@@ -110,6 +114,10 @@ class MModuleEventSaver : public MModule
  protected:
   //! Start a new sub-file
   bool StartSubFile();
+  //! Stream one event into the write buffer
+  bool StreamEvent(MReadOutAssembly* Event);
+  //! Write the content of the write buffer to the current file
+  void FlushBuffer();
    
   //!
   void WriteHeader();
@@ -137,6 +145,8 @@ class MModuleEventSaver : public MModule
  private:
   //! The operation mode
   unsigned int m_Mode;
+  //! The buffer collecting the streamed events until they are written
+  ostringstream m_Buffer;
   //! The file name
   MString m_FileName;
   //! The internal filename with tags etc.
@@ -22,7 +22,6 @@
 using namespace std;
 
 // ROOT libs:
-#include "zlib.h"
 
 // MEGAlib libs:
 #include "MGlobal.h"
@@ -30,6 +29,9 @@ using namespace std;
 // Nuclearizer libs
 #include "MModule.h"
 #include "MBinaryFlightDataParser.h"
+#include "MGzipBlockReader.h"
+#include "MBinaryFlightDataIndex.h"
+#include "MBinaryFlightDataFileReader.h"
 #include "MGUIExpoAspectViewer.h"
 
 // Forward declarations:
@@ -55,6 +57,24 @@ class MModuleLoaderMeasurementsBinary : public MModule, public MBinaryFlightData
   MString GetFileName() const { return m_FileName; }
   //! Set the file name
   void SetFileName(const MString& Name) { m_FileName = Name; }
+
+  //! Set the start of the time range to read as Unix time (0: from the beginning)
+  void SetStartTime(unsigned int StartTime) { m_StartTime = StartTime; }
+  //! Get the start of the time range to read as Unix time (0: from the beginning)
+  unsigned int GetStartTime() const { return m_StartTime; }
+  //! Set the stop of the time range to read as Unix time (0: to the end)
+  void SetStopTime(unsigned int StopTime) { m_StopTime = StopTime; }
+  //! Get the stop of the time range to read as Unix time (0: to the end)
+  unsigned int GetStopTime() const { return m_StopTime; }
+  //! Set the time in seconds read before the time range to build up the aspect and coincidence state
+  void SetWarmUpTime(unsigned int WarmUpTime) { m_WarmUpTime = WarmUpTime; }
+  //! Get the time in seconds read before the time range to build up the aspect and coincidence state
+  unsigned int GetWarmUpTime() const { return m_WarmUpTime; }
+
+  //! Set if the files of a file list are read concurrently and merged by clock, instead of one after the other
+  void SetReadFilesConcurrently(bool Concurrently) { m_ReadFilesConcurrently = Concurrently; }
+  //! Return true if the files of a file list are read concurrently and merged by clock
+  bool GetReadFilesConcurrently() const { return m_ReadFilesConcurrently; }
  
   //! Return if the module is ready to analyze events
   virtual bool IsReady();
@@ -88,6 +108,33 @@ class MModuleLoaderMeasurementsBinary : public MModule, public MBinaryFlightData
 
   //! Open next file, return false on error
   bool OpenNextFile();
+  //! Open all files at once, each with its own reading thread, return false on error
+  bool OpenAllFiles();
+  //! Return the next chunk of packets of all files, merged by clock, in Data, and its size (0 if all files are exhausted)
+  size_t ReadMergedChunk(const uint8_t*& Data);
+  //! Close all files opened with OpenAllFiles()
+  void CloseAllFiles();
+  //! Memory-map the given uncompressed file, return false if this is not possible
+  bool MapFile(const MString& FileName);
+  //! Release the memory mapping of the current file (if there is any)
+  void UnmapFile();
+  //! Return the next chunk of the currently open file in Data, and its size (0 if the file is exhausted)
+  //! Data points either into the memory mapping or into m_ReadBuffer and is valid until the next call
+  //! Only the part of the file within the read region (see SeekTimeRange()) is returned
+  size_t ReadNextChunk(const uint8_t*& Data);
+  //! Return the next chunk of the currently open file like ReadNextChunk(), but ignoring the read region
+  size_t ReadChunk(const uint8_t*& Data);
+
+  //! Return true if only a time range of the data is read
+  bool HasTimeRange() const { return m_StartTime > 0 || m_StopTime > 0; }
+  //! Restrict the read region of the currently open file to the time range (plus warm-up) using the packet index
+  //! Return false if the file has no data within the time range
+  bool SeekTimeRange();
+  //! Find the byte region [Begin, End) of the file with the data of the time range (plus warm-up) using the packet index
+  //! Return false if the file has no data within the time range
+  bool FindReadRegion(const MString& FileName, uint64_t& Begin, uint64_t& End);
+  //! Return true if the Unix time of an event (only the lower 24 bits, as in the packet headers) is within the time range
+  bool IsInTimeRange(unsigned long long TI) const;
   
   // private methods:
  private:
@@ -108,8 +155,40 @@ class MModuleLoaderMeasurementsBinary : public MModule, public MBinaryFlightData
   bool m_IsZipped;
   //! The current binary data stream uncompressed
   ifstream m_In;
-  //! The basic file stream for zlib
-  gzFile m_ZipFile;
+  //! The reader decompressing gzip'ed files on a background thread
+  MGzipBlockReader m_ZipReader;
+  //! True if the current file is memory-mapped
+  bool m_IsMapped;
+  //! The start of the memory-mapped file
+  const uint8_t* m_MappedData;
+  //! The size of the memory-mapped file
+  size_t m_MappedSize;
+  //! The position of the next chunk in the memory-mapped file
+  size_t m_MappedPosition;
+  //! The position up to which the mapped pages have been released
+  size_t m_MappedReleased;
+  //! The read buffer for the not mappable uncompressed files
+  vector<uint8_t> m_ReadBuffer;
+  //! The size of the chunks handed to the parser
+  static const size_t c_ChunkSize = 1000000;
+  //! The start of the read region in the uncompressed data stream of the current file
+  uint64_t m_ReadBegin;
+  //! The end of the read region in the uncompressed data stream of the current file
+  uint64_t m_ReadEnd;
+  //! The position of the next chunk in the uncompressed data stream of the current file
+  uint64_t m_ReadPosition;
+  //! The start of the time range to read as Unix time (0: from the beginning)
+  unsigned int m_StartTime;
+  //! The stop of the time range to read as Unix time (0: to the end)
+  unsigned int m_StopTime;
+  //! The time in seconds read before the time range to build up the aspect and coincidence state
+  unsigned int m_WarmUpTime;
+  //! True if the files of a file list are read concurrently and merged by clock
+  bool m_ReadFilesConcurrently;
+  //! The readers of all files if they are read concurrently
+  vector<MBinaryFlightDataFileReader*> m_FileReaders;
+  //! The chunk of merged packets handed to the parser
+  vector<uint8_t> m_MergedPackets;
   //! A list of all binary data files
   vector<MString> m_BinaryFileNames;
   //! The currently open binary file name (-1 none is open)
@@ -0,0 +1,168 @@
+/*
+ * MModulePipeline.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MModulePipeline__
+#define __MModulePipeline__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+#include <atomic>
+#include <chrono>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+#include "MModule.h"
+
+// Nuclearizer libs:
+#include "MReadOutAssembly.h"
+#include "MModuleStatistics.h"
+#include "MPipelineStatistics.h"
+
+// Forward declarations:
+class MDGeometryQuest;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Runs a chain of modules without the GUI, handing the events from module to module in batches.
+//! The first module is the event loader. Each batch is passed through the modules via
+//! MBatchAnalyzer::AnalyzeEvents(), thus modules which implement the batch interface
+//! see a whole batch per call. Events for which a module returns false are dropped.
+//! With replicas enabled, every module after the loader runs in its own thread, and modules
+//! which are replicable run as several clones in parallel. The batches are numbered by the
+//! loader and each stage hands them on in this order, thus the event order is kept.
+//! All module calls are timed, see GetStatistics().
+class MModulePipeline
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MModulePipeline();
+  //! Default destructor
+  virtual ~MModulePipeline();
+
+  //! Add a module to the end of the chain - the pipeline does not take ownership
+  void AddModule(MModule* Module) { m_Modules.push_back(Module); }
+  //! Return the number of modules
+  unsigned int GetNModules() const { return m_Modules.size(); }
+
+  //! Set the number of events per batch
+  void SetBatchSize(unsigned int BatchSize) { m_BatchSize = (BatchSize > 0) ? BatchSize : 1; }
+  //! Return the number of events per batch
+  unsigned int GetBatchSize() const { return m_BatchSize; }
+
+  //! Set the number of clones of each replicable module - 0 runs all modules in the calling thread
+  void SetNReplicas(unsigned int NReplicas) { m_NReplicas = NReplicas; }
+  //! Return the number of clones of each replicable module
+  unsigned int GetNReplicas() const { return m_NReplicas; }
+
+  //! Set the maximum number of batches a stage may hold back to restore their order
+  void SetReorderSize(unsigned int ReorderSize) { m_ReorderSize = ReorderSize; }
+  //! Return the maximum number of batches a stage may hold back to restore their order
+  unsigned int GetReorderSize() const { return m_ReorderSize; }
+
+  //! Set the geometry which is handed to all modules and their clones - the pipeline does not take ownership
+  void SetGeometry(MDGeometryQuest* Geometry) { m_Geometry = Geometry; }
+
+  //! Set the file to which the statistics summary is written after the modules are finalized - empty for none
+  void SetStatisticsFileName(const MString& FileName) { m_StatisticsFileName = FileName; }
+  //! Return the run-time statistics of all modules - can be read while the analysis is running
+  const MPipelineStatistics& GetStatistics() const { return m_Statistics; }
+
+  //! Set the interrupt flag - the analysis ends after the current batch
+  void SetInterrupt(bool Flag = true) { m_Interrupt = Flag; }
+
+  //! Initialize all modules, run the analysis until the loader is finished, and finalize all modules
+  bool Analyze();
+
+  //! Return the number of events which came out of the loader
+  unsigned long GetNLoadedEvents() const { return m_NLoadedEvents; }
+  //! Return the number of events which passed all modules
+  unsigned long GetNAnalyzedEvents() const { return m_NAnalyzedEvents; }
+
+
+  // protected methods:
+ protected:
+  //! Fill the batch from the loader - returns false if the loader is finished
+  bool LoadBatch(vector<MReadOutAssembly*>& Batch);
+  //! Pass the batch through module m, dropping the events the module rejects
+  void AnalyzeBatch(unsigned int m, vector<MReadOutAssembly*>& Batch);
+
+  //! Run the loop with all modules in the calling thread
+  void AnalyzeSequential();
+  //! Run the loop with one stage thread per module and clones of the replicable modules
+  bool AnalyzeParallel();
+  //! Create a clone of the module with the same configuration
+  MModule* CreateReplica(MModule* Module);
+
+  // private methods:
+ private:
+
+
+
+  // protected members:
+ protected:
+  //! The modules of the chain, the first one is the loader
+  vector<MModule*> m_Modules;
+  //! The number of events per batch
+  unsigned int m_BatchSize;
+  //! The number of clones of each replicable module
+  unsigned int m_NReplicas;
+  //! The maximum number of batches a stage may hold back to restore their order
+  unsigned int m_ReorderSize;
+  //! The geometry handed to all modules
+  MDGeometryQuest* m_Geometry;
+  //! The interrupt flag
+  atomic<bool> m_Interrupt;
+
+  //! The run-time statistics of all modules
+  MPipelineStatistics m_Statistics;
+  //! The file to which the statistics summary is written
+  MString m_StatisticsFileName;
+
+  //! The number of events which came out of the loader
+  unsigned long m_NLoadedEvents;
+  //! The number of events which passed all modules
+  unsigned long m_NAnalyzedEvents;
+
+  // private members:
+ private:
+  //! The per-event results of the last module call
+  vector<bool> m_Results;
+  //! The clones created for the current analysis
+  vector<MModule*> m_Replicas;
+  //! The module each clone was created from
+  vector<MModule*> m_ReplicaOriginals;
+  //! The statistics of the modules running in the calling thread, not yet merged
+  vector<MModuleStatistics> m_LocalStatistics;
+  //! The times of the last merge of the local statistics
+  vector<chrono::steady_clock::time_point> m_LastMerges;
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MModulePipeline, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,148 @@
+/*
+ * MModulePipelineStage.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MModulePipelineStage__
+#define __MModulePipelineStage__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+#include <deque>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+#include "MModule.h"
+
+// Nuclearizer libs:
+#include "MReadOutAssembly.h"
+#include "MPipelineStatistics.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! One stage of the multi-threaded MModulePipeline: one or more instances of a module,
+//! each running in its own thread. The stage takes numbered batches from a bounded input
+//! queue and hands them to the next stage strictly in the order of their numbers.
+//! Batches finished out of order by the replicas wait in a bounded reorder buffer.
+class MModulePipelineStage
+{
+  // public interface:
+ public:
+  //! Default constructor - the instances are the original module and its replicas
+  MModulePipelineStage(const vector<MModule*>& Instances, unsigned int QueueSize, unsigned int ReorderSize);
+  //! Default destructor
+  virtual ~MModulePipelineStage();
+
+  //! Set the stage which receives the analyzed batches - nullptr for the last stage
+  void SetNext(MModulePipelineStage* Next) { m_Next = Next; }
+
+  //! Set the statistics into which the instances merge their counters as module m - nullptr for none
+  void SetStatistics(MPipelineStatistics* Statistics, unsigned int m) { m_Statistics = Statistics; m_ModuleIndex = m; }
+
+  //! Start the threads of all instances
+  void Start();
+  //! Wait until all threads have ended
+  void Join();
+
+  //! Add the batch with the given number - blocks while the input queue is full
+  //! The batch numbers must be handed in consecutively starting at 0
+  void Push(unsigned long Number, vector<MReadOutAssembly*>* Batch);
+  //! Signal that no more batches will arrive
+  void Close();
+
+  //! Return the number of events which passed the last stage (only valid for the last stage)
+  unsigned long GetNPassedEvents() const { return m_NPassedEvents; }
+
+
+  // protected methods:
+ protected:
+  //! The loop of the thread of instance i
+  void Run(unsigned int i);
+  //! Put an analyzed batch into the reorder buffer and hand on all batches which are next in line
+  void Deliver(unsigned long Number, vector<MReadOutAssembly*>* Batch);
+
+  // private methods:
+ private:
+
+
+
+  // protected members:
+ protected:
+  //! The module instances
+  vector<MModule*> m_Instances;
+  //! The threads of the instances
+  vector<thread*> m_Threads;
+  //! The next stage
+  MModulePipelineStage* m_Next;
+
+  //! The maximum number of batches in the input queue
+  unsigned int m_QueueSize;
+  //! The maximum number of batches an instance may be ahead of the next batch to deliver
+  unsigned int m_ReorderSize;
+
+  //! The input queue
+  deque<pair<unsigned long, vector<MReadOutAssembly*>*>> m_Queue;
+  //! True if no more batches will arrive
+  bool m_IsClosed;
+  //! The mutex protecting the input queue
+  mutex m_QueueMutex;
+  //! Signals a change of the input queue or of the delivery state
+  condition_variable m_QueueCondition;
+
+  //! The reorder buffer
+  map<unsigned long, vector<MReadOutAssembly*>*> m_Reorder;
+  //! The number of the next batch to deliver
+  atomic<unsigned long> m_NextNumber;
+  //! The mutex protecting the reorder buffer and the delivery
+  mutex m_ReorderMutex;
+
+  //! The number of batches in the reorder buffer
+  atomic<unsigned int> m_NReordered;
+
+  //! The statistics
+  MPipelineStatistics* m_Statistics;
+  //! The index of the module in the statistics
+  unsigned int m_ModuleIndex;
+
+  //! The number of instances still running
+  atomic<unsigned int> m_NRunning;
+  //! The number of events which passed the last stage
+  atomic<unsigned long> m_NPassedEvents;
+
+  // private members:
+ private:
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MModulePipelineStage, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
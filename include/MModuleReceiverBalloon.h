@@ -19,6 +19,8 @@
 // Standard libs:
 #include <list>
 #include <fstream>
+#include <thread>
+#include <atomic>
 using namespace std;
 
 // ROOT libs:
@@ -32,6 +34,7 @@ using namespace std;
 #include "MBinaryFlightDataParser.h"
 #include "MGUIExpoAspectViewer.h"
 #include "MGUIExpoReceiver.h"
+#include "MSPSCQueue.h"
 
 // Forward declarations:
 
@@ -114,6 +117,13 @@ class MModuleReceiverBalloon : public MModule, public MBinaryFlightDataParser
   //! End connection
   bool EndConnection();
 
+  //! Start the receive thread
+  void StartReceiving();
+  //! Stop the receive thread
+  void StopReceiving();
+  //! The loop of the receive thread: drain the transceiver and queue the received blocks for the parser
+  void ReceiveLoop();
+
   // private methods:
  private:
 
@@ -151,6 +161,21 @@ class MModuleReceiverBalloon : public MModule, public MBinaryFlightDataParser
   //! The transceiver
   MTransceiverTcpIpBinary* m_Receiver;
 
+  //! The maximum number of received blocks waiting for the parser
+  static const size_t c_ReceiveQueueSize = 256;
+  //! The received blocks waiting for the parser - filled by the receive thread, emptied in IsReady
+  MSPSCQueue<vector<uint8_t>> m_ReceiveQueue;
+  //! The receive thread
+  thread* m_ReceiveThread;
+  //! True if the receive thread should stop
+  atomic<bool> m_StopReceiving;
+  //! The time in ns the receive thread waited for the parser because the queue was full
+  atomic<uint64_t> m_ReceiveStallTime;
+  //! The block last popped from the receive queue
+  vector<uint8_t> m_Block;
+  //! The popped blocks concatenated, so that they are handed to the parser in one go
+  vector<uint8_t> m_ParseBuffer;
+
   //! The total received data
   long m_ReceivedData;
   //! Timer whne the last update summary was shown
@@ -0,0 +1,161 @@
+/*
+ * MModuleStatistics.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MModuleStatistics__
+#define __MModuleStatistics__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <cstdint>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+#include "MString.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! The run-time counters of one module in the pipeline: number of calls and events,
+//! processing time with a histogram of the time per event, time the loader was blocked
+//! in IsReady(), and the occupancy of the input queue and of the reorder buffer of its stage.
+//! Each thread fills its own instance without locking and merges it periodically into
+//! the shared one in MPipelineStatistics.
+class MModuleStatistics
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MModuleStatistics();
+  //! Default destructor
+  virtual ~MModuleStatistics();
+
+  //! Reset all counters - the name is kept
+  void Clear();
+
+  //! Set the name of the module
+  void SetName(const MString& Name) { m_Name = Name; }
+  //! Return the name of the module
+  MString GetName() const { return m_Name; }
+
+  //! Set the number of instances (original plus clones) of the module
+  void SetNInstances(unsigned int NInstances) { m_NInstances = NInstances; }
+  //! Return the number of instances (original plus clones) of the module
+  unsigned int GetNInstances() const { return m_NInstances; }
+
+  //! Add one call of the module with NIn events in, NOut events out, which took the given time
+  void AddCall(unsigned int NIn, unsigned int NOut, uint64_t Nanoseconds);
+  //! Add time spent in IsReady() or waiting for it to become true
+  void AddBlockedTime(uint64_t Nanoseconds) { m_BlockedTime += Nanoseconds; }
+  //! Add one sample of the queue occupancies (in batches) seen when a batch was taken
+  void AddQueueOccupancy(unsigned int InputQueue, unsigned int OutputQueue);
+
+  //! Add all counters of Other to this one
+  void Merge(const MModuleStatistics& Other);
+
+  //! Return true if nothing has been counted since the last Clear()
+  bool IsEmpty() const { return m_NCalls == 0 && m_BlockedTime == 0; }
+
+  //! Return the number of calls
+  uint64_t GetNCalls() const { return m_NCalls; }
+  //! Return the number of events handed to the module
+  uint64_t GetNEventsIn() const { return m_NEventsIn; }
+  //! Return the number of events the module accepted
+  uint64_t GetNEventsOut() const { return m_NEventsOut; }
+  //! Return the summed processing time in ns - with several instances this is CPU time
+  uint64_t GetProcessingTime() const { return m_ProcessingTime; }
+  //! Return the time spent in IsReady() or waiting for it in ns
+  uint64_t GetBlockedTime() const { return m_BlockedTime; }
+  //! Return the mean processing time per event in ns
+  double GetMeanTimePerEvent() const { return (m_NEventsIn > 0) ? double(m_ProcessingTime)/m_NEventsIn : 0.0; }
+
+  //! Return the mean occupancy of the input queue
+  double GetMeanInputQueue() const { return (m_NQueueSamples > 0) ? double(m_InputQueueSum)/m_NQueueSamples : 0.0; }
+  //! Return the maximum occupancy of the input queue
+  unsigned int GetMaxInputQueue() const { return m_InputQueueMax; }
+  //! Return the mean occupancy of the reorder buffer
+  double GetMeanOutputQueue() const { return (m_NQueueSamples > 0) ? double(m_OutputQueueSum)/m_NQueueSamples : 0.0; }
+  //! Return the maximum occupancy of the reorder buffer
+  unsigned int GetMaxOutputQueue() const { return m_OutputQueueMax; }
+
+  //! Return the number of bins of the time histogram
+  static unsigned int GetNHistogramBins() { return c_NHistogramBins; }
+  //! Return the lower edge of bin b of the time histogram in ns - bin b covers [2^b, 2^(b+1)) ns
+  static uint64_t GetHistogramBinEdge(unsigned int b) { return uint64_t(1) << b; }
+  //! Return the number of events in bin b of the time histogram
+  uint64_t GetHistogramBin(unsigned int b) const { return (b < c_NHistogramBins) ? m_Histogram[b] : 0; }
+
+
+  // protected methods:
+ protected:
+
+  // private methods:
+ private:
+
+
+
+  // protected members:
+ protected:
+  //! The number of bins of the time histogram - the last bin starts at ~1 s per event
+  static const unsigned int c_NHistogramBins = 31;
+
+  //! The name of the module
+  MString m_Name;
+  //! The number of instances of the module
+  unsigned int m_NInstances;
+
+  //! The number of calls
+  uint64_t m_NCalls;
+  //! The number of events in
+  uint64_t m_NEventsIn;
+  //! The number of events out
+  uint64_t m_NEventsOut;
+  //! The processing time in ns
+  uint64_t m_ProcessingTime;
+  //! The time spent in IsReady() or waiting for it in ns
+  uint64_t m_BlockedTime;
+  //! The time per event histogram with logarithmic bins
+  uint64_t m_Histogram[c_NHistogramBins];
+
+  //! The number of queue occupancy samples
+  uint64_t m_NQueueSamples;
+  //! The summed input queue occupancy
+  uint64_t m_InputQueueSum;
+  //! The maximum input queue occupancy
+  unsigned int m_InputQueueMax;
+  //! The summed reorder buffer occupancy
+  uint64_t m_OutputQueueSum;
+  //! The maximum reorder buffer occupancy
+  unsigned int m_OutputQueueMax;
+
+  // private members:
+ private:
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MModuleStatistics, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
@@ -117,6 +117,7 @@ Clio Sleator, 2014
 // Nuclearizer libs
 #include "MModule.h"
 #include "MGUIExpoStripPairing.h"
+#include "MBatchAnalyzer.h"
 
 // Forward declarations:
 
@@ -124,7 +125,7 @@ Clio Sleator, 2014
 
 using namespace std;
 
-class MModuleStripPairingGreedy : public MModule
+class MModuleStripPairingGreedy : public MModule, public MBatchAnalyzer
 {
   // public interface:
  public:
@@ -152,6 +153,10 @@ class MModuleStripPairingGreedy : public MModule
 
   //!Main data analysis routine, which updates the event to a new level
   virtual bool AnalyzeEvent(MReadOutAssembly* Event);
+  //! Analyze a batch of events - the energy histogram of the expo is updated once per batch
+  virtual void AnalyzeEvents(vector<MReadOutAssembly*>& Events, vector<bool>& Results);
+  //! This module carries no state between events and can be replicated
+  virtual bool IsReplicable() const { return true; }
 
 //other functions
   int GetEventInfo(MReadOutAssembly*, int);
@@ -220,6 +225,10 @@ class MModuleStripPairingGreedy : public MModule
   MModuleStripPairingGreedy(const MModuleStripPairingGreedy&) = delete;
   //! No copying itself
   MModuleStripPairingGreedy& operator=(const MModuleStripPairingGreedy&) = delete;
+  //! Pair the strips of one event, the energies for the expo are appended to m_ExpoPEnergies/m_ExpoNEnergies
+  bool PairStrips(MReadOutAssembly* Event);
+  //! Hand the collected energies to the expo
+  void FlushExpo();
 
 
 
@@ -227,11 +236,20 @@ class MModuleStripPairingGreedy : public MModule
  protected:
   //! The display of debugging data
   MGUIExpoStripPairing* m_ExpoStripPairing;
+  //! The p-side energies waiting to be added to the expo
+  vector<double> m_ExpoPEnergies;
+  //! The n-side energies waiting to be added to the expo
+  vector<double> m_ExpoNEnergies;
  
   int m_TotalMatches; //Event Counters 
   int m_NMatches; //Variable Match counter, used to events with a specific numbers of strips involved 
   int m_NBadMatches; //Counts the number of badly matched events
 
+  //! The interned strip pairing quality reasons - interned once, thus flagging an event is lock-free
+  uint16_t m_ReasonBadNumberOfStripHits;
+  uint16_t m_ReasonMultipleHitsPerStrip;
+  uint16_t m_ReasonBadPairing;
+
   //for all of these vectors, vector.at(0) = vector of x information
   //and vector.at(1) = vector of y information
   //for example, stripsHit.at(0) = vector containing all of the x strips hit
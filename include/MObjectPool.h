@@ -0,0 +1,305 @@
+/*
+ * MObjectPool.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MObjectPool__
+#define __MObjectPool__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+#include <mutex>
+#include <atomic>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! A recycling pool for the objects which are created and destroyed once per event
+//! (read-out assemblies, strip hits, hits, guard ring hits).
+//! Each thread keeps a small local free list, which it exchanges in batches with
+//! a shared depot. This way objects created in the loader thread and released in the
+//! last thread of the chain still find their way back to the loader.
+//! The pooled type must provide a default constructor and a Clear() function, which
+//! brings the object back into its freshly-constructed state.
+template <class T>
+class MObjectPool
+{
+  // public interface:
+ public:
+  //! Return a cleared object - either a recycled one or a newly allocated one
+  static T* Get();
+  //! Clear the object and hand it back to the pool - the pointer must not be used afterwards
+  static void Release(T* Object);
+
+  //! Enable or disable the pool - if disabled Get() allocates and Release() deletes
+  static void UsePool(bool Flag = true) { s_UsePool = Flag; }
+  //! Return true if the pool is in use
+  static bool UsePool() { return s_UsePool; }
+
+  //! Set the maximum number of objects kept in the shared depot
+  static void SetMaximumSize(unsigned long MaximumSize) { s_MaximumSize = MaximumSize; }
+  //! Return the maximum number of objects kept in the shared depot
+  static unsigned long GetMaximumSize() { return s_MaximumSize; }
+
+  //! Return the number of objects currently held by the pool (shared depot and all thread-local lists)
+  static unsigned long GetNObjects() { return s_NObjects; }
+  //! Return the number of objects which had to be newly allocated
+  static unsigned long GetNAllocations() { return s_NAllocations; }
+  //! Return the number of objects which have been recycled
+  static unsigned long GetNRecycled() { return s_NRecycled; }
+
+  //! Delete all objects in the shared depot and in the free list of the calling thread
+  static void Purge();
+
+  // private methods:
+ private:
+  //! The thread-local free list - returns its content to the depot when the thread ends
+  class MLocalList
+  {
+   public:
+    ~MLocalList();
+    vector<T*> m_Objects;
+  };
+
+  //! Return the free list of this thread
+  static vector<T*>& GetLocalList();
+  //! Return the shared depot
+  static vector<T*>& GetDepot();
+  //! Return the mutex protecting the shared depot
+  static mutex& GetDepotMutex();
+
+  //! Move up to c_BatchSize objects from the depot to the local list
+  static void Refill(vector<T*>& Local);
+  //! Move c_BatchSize objects from the local list to the depot
+  static void Drain(vector<T*>& Local);
+
+  // private members:
+ private:
+  //! The number of objects exchanged between local list and depot in one go
+  static const unsigned long c_BatchSize = 256;
+
+  //! True if the pool is used
+  static atomic<bool> s_UsePool;
+  //! Maximum number of objects in the depot
+  static atomic<unsigned long> s_MaximumSize;
+  //! The number of objects in the pool
+  static atomic<unsigned long> s_NObjects;
+  //! The number of allocations
+  static atomic<unsigned long> s_NAllocations;
+  //! The number of recycled objects
+  static atomic<unsigned long> s_NRecycled;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+template <class T> atomic<bool> MObjectPool<T>::s_UsePool(true);
+template <class T> atomic<unsigned long> MObjectPool<T>::s_MaximumSize(1000000);
+template <class T> atomic<unsigned long> MObjectPool<T>::s_NObjects(0);
+template <class T> atomic<unsigned long> MObjectPool<T>::s_NAllocations(0);
+template <class T> atomic<unsigned long> MObjectPool<T>::s_NRecycled(0);
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+template <class T>
+T* MObjectPool<T>::Get()
+{
+  //! Return a cleared object
+
+  if (s_UsePool == true) {
+    vector<T*>& Local = GetLocalList();
+    if (Local.empty() == true) {
+      Refill(Local);
+    }
+    if (Local.empty() == false) {
+      T* Object = Local.back();
+      Local.pop_back();
+      --s_NObjects;
+      ++s_NRecycled;
+      return Object;
+    }
+  }
+
+  ++s_NAllocations;
+  return new T();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+template <class T>
+void MObjectPool<T>::Release(T* Object)
+{
+  //! Clear the object and hand it back to the pool
+
+  if (Object == nullptr) return;
+
+  if (s_UsePool == false) {
+    delete Object;
+    return;
+  }
+
+  Object->Clear();
+
+  vector<T*>& Local = GetLocalList();
+  Local.push_back(Object);
+  ++s_NObjects;
+  if (Local.size() >= 2*c_BatchSize) {
+    Drain(Local);
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+template <class T>
+void MObjectPool<T>::Purge()
+{
+  //! Delete all objects in the shared depot and the local free list
+
+  vector<T*>& Local = GetLocalList();
+  for (T* Object: Local) {
+    delete Object;
+  }
+  s_NObjects -= Local.size();
+  Local.clear();
+
+  lock_guard<mutex> Lock(GetDepotMutex());
+  vector<T*>& Depot = GetDepot();
+  for (T* Object: Depot) {
+    delete Object;
+  }
+  s_NObjects -= Depot.size();
+  Depot.clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+template <class T>
+void MObjectPool<T>::Refill(vector<T*>& Local)
+{
+  //! Move up to c_BatchSize objects from the depot to the local list
+
+  lock_guard<mutex> Lock(GetDepotMutex());
+  vector<T*>& Depot = GetDepot();
+  unsigned long N = (Depot.size() < c_BatchSize) ? Depot.size() : c_BatchSize;
+  Local.insert(Local.end(), Depot.end() - N, Depot.end());
+  Depot.resize(Depot.size() - N);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+template <class T>
+void MObjectPool<T>::Drain(vector<T*>& Local)
+{
+  //! Move c_BatchSize objects from the local list to the depot, delete what does not fit
+
+  unsigned long N = (Local.size() < c_BatchSize) ? Local.size() : c_BatchSize;
+
+  lock_guard<mutex> Lock(GetDepotMutex());
+  vector<T*>& Depot = GetDepot();
+  for (unsigned long i = Local.size() - N; i < Local.size(); ++i) {
+    if (Depot.size() < s_MaximumSize) {
+      Depot.push_back(Local[i]);
+    } else {
+      delete Local[i];
+      --s_NObjects;
+    }
+  }
+  Local.resize(Local.size() - N);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+template <class T>
+MObjectPool<T>::MLocalList::~MLocalList()
+{
+  //! The thread ends: hand everything back to the depot
+
+  lock_guard<mutex> Lock(GetDepotMutex());
+  vector<T*>& Depot = GetDepot();
+  for (T* Object: m_Objects) {
+    if (Depot.size() < s_MaximumSize) {
+      Depot.push_back(Object);
+    } else {
+      delete Object;
+      --s_NObjects;
+    }
+  }
+  m_Objects.clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+template <class T>
+vector<T*>& MObjectPool<T>::GetLocalList()
+{
+  //! Return the free list of this thread
+
+  static thread_local MLocalList Local;
+  return Local.m_Objects;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+template <class T>
+vector<T*>& MObjectPool<T>::GetDepot()
+{
+  //! Return the shared depot - intentionally never destroyed to survive thread-local cleanup at exit
+
+  static vector<T*>* Depot = new vector<T*>();
+  return *Depot;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+template <class T>
+mutex& MObjectPool<T>::GetDepotMutex()
+{
+  //! Return the mutex protecting the shared depot
+
+  static mutex* Mutex = new mutex();
+  return *Mutex;
+}
+
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
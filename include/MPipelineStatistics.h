@@ -0,0 +1,120 @@
+/*
+ * MPipelineStatistics.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MPipelineStatistics__
+#define __MPipelineStatistics__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <ostream>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+#include "MString.h"
+
+// Nuclearizer libs:
+#include "MModuleStatistics.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! The shared run-time statistics of all modules of a pipeline.
+//! The threads count into their own MModuleStatistics and merge them via MergeIfDue()
+//! about every 100 ms and once at their end, thus the lock is rarely taken.
+class MPipelineStatistics
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MPipelineStatistics();
+  //! Default destructor
+  virtual ~MPipelineStatistics();
+
+  //! Reset everything and set up the module names - starts the wall clock
+  void Initialize(const vector<MString>& Names);
+  //! Stop the wall clock
+  void Stop();
+
+  //! Set the number of instances of module m
+  void SetNInstances(unsigned int m, unsigned int NInstances);
+
+  //! Merge the local counters of module m into the shared ones and clear them
+  void Merge(unsigned int m, MModuleStatistics& Local);
+  //! Merge the local counters if the last merge (LastMerge, updated) is long enough ago
+  void MergeIfDue(unsigned int m, MModuleStatistics& Local, chrono::steady_clock::time_point& LastMerge);
+
+  //! Return a copy of the current statistics of all modules
+  vector<MModuleStatistics> GetSnapshot() const;
+  //! Return the wall-clock time since Initialize() (until Stop()) in seconds
+  double GetWallTime() const;
+  //! Return the time at which Initialize() was called
+  chrono::steady_clock::time_point GetStartTime() const { lock_guard<mutex> Lock(m_Mutex); return m_Start; }
+
+  //! Write the summary as JSON file
+  bool WriteSummary(const MString& FileName) const;
+  //! Stream the "Modules" array of the JSON summary with the given indentation - without a final new line
+  void StreamModules(ostream& out, const MString& Indent) const;
+  //! Stream a human-readable table with one line per module
+  void StreamTable(ostream& out) const;
+
+
+  // protected methods:
+ protected:
+
+  // private methods:
+ private:
+
+
+
+  // protected members:
+ protected:
+  //! The time between merges of the thread-local counters
+  static const unsigned int c_MergeIntervalMilliseconds = 100;
+
+  //! The statistics of the modules
+  vector<MModuleStatistics> m_Modules;
+  //! The mutex protecting the statistics
+  mutable mutex m_Mutex;
+
+  //! The start of the wall clock
+  chrono::steady_clock::time_point m_Start;
+  //! The stop of the wall clock
+  chrono::steady_clock::time_point m_Stop;
+  //! True if the wall clock has been stopped
+  bool m_IsStopped;
+
+  // private members:
+ private:
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MPipelineStatistics, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
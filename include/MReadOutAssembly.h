@@ -26,6 +26,7 @@
 #include "MReadOutSequence.h"
 #include "MAspect.h"
 #include "MStripHit.h"
+#include "MStripHitArrays.h"
 #include "MGuardringHit.h"
 #include "MHit.h"
 #include "MPhysicalEvent.h"
@@ -147,6 +148,32 @@ class MReadOutAssembly : public MReadOutSequence
   void AddStripHit(MStripHit* StripHit);
   //! Remove a strip hit
   void RemoveStripHit(unsigned int i);
+  //! Append a range of strip hits - this event takes over the ownership
+  void AddStripHits(vector<MStripHit*>::const_iterator Begin, vector<MStripHit*>::const_iterator End);
+  //! Move all strip hits of the other event to the end of this event's list - Other loses the ownership
+  void TakeStripHits(MReadOutAssembly* Other);
+  //! Swap the strip hit lists (and the detector occupancy) with the other event
+  void SwapStripHits(MReadOutAssembly* Other);
+  //! Reserve space for at least N strip hits
+  void ReserveStripHits(unsigned int N) { m_StripHits.reserve(N); }
+
+  //! Return the number of strip hits on one side of a detector
+  //! The first call after a change of the strip hit list builds the (detector, side) index
+  unsigned int GetNStripHits(int DetectorID, bool IsXStrip) const;
+  //! Return strip hit i on one side of a detector
+  MStripHit* GetStripHit(int DetectorID, bool IsXStrip, unsigned int i) const;
+  //! Return the begin of the strip hits on one side of a detector
+  vector<MStripHit*>::const_iterator BeginStripHits(int DetectorID, bool IsXStrip) const;
+  //! Return the end of the strip hits on one side of a detector
+  vector<MStripHit*>::const_iterator EndStripHits(int DetectorID, bool IsXStrip) const;
+  //! Gather the given columns (MStripHitArrays::c_Column...) of the strip hits into the structure-of-arrays view and return it
+  //! The view is ordered like the (detector, side) index; it is a copy, i.e. changes only reach
+  //! the strip hits via StoreStripHitArrays(). Any change of the strip hit list empties the view.
+  MStripHitArrays& LoadStripHitArrays(unsigned int Columns = MStripHitArrays::c_ColumnAll);
+  //! Write the changes made in the structure-of-arrays view back to the strip hits
+  void StoreStripHitArrays() { m_StripHitArrays.Store(); }
+  //! Invalidate the (detector, side) index and the structure-of-arrays view - call this after changing the detector ID or side of a strip hit already in this event
+  void InvalidateStripHitIndex() { m_StripHitIndexValid = false; m_StripHitArrays.Clear(); }
 
   //! Return the number of T Only strip hits
   unsigned int GetNStripHitsTOnly() const { return m_StripHitsTOnly.size(); }
@@ -156,6 +183,10 @@ class MReadOutAssembly : public MReadOutSequence
   void AddStripHitTOnly(MStripHit*);
   //! Remove a strip hit
   void RemoveStripHitTOnly(unsigned int i);
+  //! Move all T Only strip hits of the other event to the end of this event's list - Other loses the ownership
+  void TakeStripHitsTOnly(MReadOutAssembly* Other);
+  //! Swap the T Only strip hit lists with the other event
+  void SwapStripHitsTOnly(MReadOutAssembly* Other) { m_StripHitsTOnly.swap(Other->m_StripHitsTOnly); }
 
 
   //! Return the number of guardring hits
@@ -164,6 +195,10 @@ class MReadOutAssembly : public MReadOutSequence
   MGuardringHit* GetGuardringHit(unsigned int i);
   //! Add a guardring hit
   void AddGuardringHit(MGuardringHit* GuardringHit) { return m_GuardringHits.push_back(GuardringHit); }
+  //! Move all guardring hits of the other event to the end of this event's list - Other loses the ownership
+  void TakeGuardringHits(MReadOutAssembly* Other);
+  //! Swap the guardring hit lists with the other event
+  void SwapGuardringHits(MReadOutAssembly* Other) { m_GuardringHits.swap(Other->m_GuardringHits); }
 
   //! Return the number of hits
   unsigned int GetNHits() const { return m_Hits.size(); }
@@ -204,60 +239,96 @@ class MReadOutAssembly : public MReadOutSequence
 
 
 
+  // Quality flags - the first ones mark the event as bad:
+  static const uint64_t c_QualityAspectIncomplete                       = (1 << 0);
+  static const uint64_t c_QualityTimeIncomplete                         = (1 << 1);
+  static const uint64_t c_QualityEnergyCalibrationIncomplete_BadStrip   = (1 << 2);
+  static const uint64_t c_QualityEnergyCalibrationIncomplete            = (1 << 3);
+  static const uint64_t c_QualityEnergyResolutionCalibrationIncomplete  = (1 << 4);
+  static const uint64_t c_QualityStripPairingIncomplete                 = (1 << 5);
+  static const uint64_t c_QualityLLDEvent                               = (1 << 6);
+  static const uint64_t c_QualityDepthCalibrationIncomplete             = (1 << 7);
+  static const uint64_t c_QualityDepthCalibration_OutofRange            = (1 << 8);
+  static const uint64_t c_QualityFilteredOut                            = (1 << 9);
+  //! The number of quality flags
+  static const unsigned int c_NQualityFlags = 10;
+  //! All flags which make an event bad
+  static const uint64_t c_QualityBad = (1 << 9) - 1;
+  //! All flags which prevent an event from being good
+  static const uint64_t c_QualityNotGood = c_QualityBad | c_QualityFilteredOut;
+
+  //! Set or unset a quality flag and store the reason (interns the text, thus takes a lock if not empty)
+  void SetQualityFlag(uint64_t Flag, bool Set, const MString& Text = "");
+  //! Set or unset a quality flag and store a reason code from InternQualityReason - lock-free
+  void SetQualityFlag(uint64_t Flag, bool Set, uint16_t ReasonCode);
+  //! Return true if any of the flags in the mask is set
+  bool HasQualityFlag(uint64_t Mask) const { return (m_QualityFlags & Mask) != 0; }
+  //! Return the full quality mask
+  uint64_t GetQualityFlags() const { return m_QualityFlags; }
+  //! Return the reason given for the flag (empty if none was given)
+  MString GetQualityReason(uint64_t Flag) const;
+
   //! Set the aspect-incomplete flag
-  void SetAspectIncomplete(bool Flag = true, MString Text = "") { m_AspectIncomplete = Flag; m_AspectIncompleteString = Text; }
+  void SetAspectIncomplete(bool Flag = true, MString Text = "") { SetQualityFlag(c_QualityAspectIncomplete, Flag, Text); }
   //! Get the aspect-incomplete flag
-  bool IsAspectIncomplete() const { return m_AspectIncomplete; }
+  bool IsAspectIncomplete() const { return HasQualityFlag(c_QualityAspectIncomplete); }
 
   //! Set the time-incomplete flag
-  void SetTimeIncomplete(bool Flag = true, MString Text = "") { m_TimeIncomplete = Flag;  m_TimeIncompleteString = Text; }
+  void SetTimeIncomplete(bool Flag = true, MString Text = "") { SetQualityFlag(c_QualityTimeIncomplete, Flag, Text); }
   //! Get the time-incomplete flag
-  bool IsTimeIncomplete() const { return m_TimeIncomplete; }
+  bool IsTimeIncomplete() const { return HasQualityFlag(c_QualityTimeIncomplete); }
   
    //! Set the energy-calibration-incomplete flag for strips without a calibration
-  void SetEnergyCalibrationIncomplete_BadStrip(bool Flag = true, MString Text = "") { m_EnergyCalibrationIncomplete_BadStrip = Flag;  m_EnergyCalibrationIncomplete_BadStripString = Text; }
+  void SetEnergyCalibrationIncomplete_BadStrip(bool Flag = true, MString Text = "") { SetQualityFlag(c_QualityEnergyCalibrationIncomplete_BadStrip, Flag, Text); }
   //! Get the energy-calibration-incomplete flag for strips without a calibration
-  bool IsEnergyCalibrationIncomplete_BadStrip() const { return m_EnergyCalibrationIncomplete_BadStrip; }
+  bool IsEnergyCalibrationIncomplete_BadStrip() const { return HasQualityFlag(c_QualityEnergyCalibrationIncomplete_BadStrip); }
 
   //! Set the energy-calibration-incomplete flag
-  void SetEnergyCalibrationIncomplete(bool Flag = true, MString Text = "") { m_EnergyCalibrationIncomplete = Flag;  m_EnergyCalibrationIncompleteString = Text; }
+  void SetEnergyCalibrationIncomplete(bool Flag = true, MString Text = "") { SetQualityFlag(c_QualityEnergyCalibrationIncomplete, Flag, Text); }
   //! Get the energy-calibration-incomplete flag
-  bool IsEnergyCalibrationIncomplete() const { return m_EnergyCalibrationIncomplete; }
+  bool IsEnergyCalibrationIncomplete() const { return HasQualityFlag(c_QualityEnergyCalibrationIncomplete); }
 
   //! Set the energy resolution calibration incomplete flag
-  void SetEnergyResolutionCalibrationIncomplete(bool Flag = true, MString Text = "") { m_EnergyResolutionCalibrationIncomplete = Flag; m_EnergyResolutionCalibrationIncompleteString = Text;}
+  void SetEnergyResolutionCalibrationIncomplete(bool Flag = true, MString Text = "") { SetQualityFlag(c_QualityEnergyResolutionCalibrationIncomplete, Flag, Text); }
   //! Get the energy resolution calibration incomplete flag
-  bool IsEnergyResolutionCalibrationIncomplete() const { return m_EnergyResolutionCalibrationIncomplete; }
+  bool IsEnergyResolutionCalibrationIncomplete() const { return HasQualityFlag(c_QualityEnergyResolutionCalibrationIncomplete); }
 
  //! Set the strip-pairing-incomplete flag
-  void SetStripPairingIncomplete(bool Flag = true, MString Text = "") { m_StripPairingIncomplete = Flag;  m_StripPairingIncompleteString = Text; }
+  void SetStripPairingIncomplete(bool Flag = true, MString Text = "") { SetQualityFlag(c_QualityStripPairingIncomplete, Flag, Text); }
+  //! Set the strip-pairing-incomplete flag with an interned reason code
+  void SetStripPairingIncomplete(bool Flag, uint16_t ReasonCode) { SetQualityFlag(c_QualityStripPairingIncomplete, Flag, ReasonCode); }
   //! Get the strip-pairing-incomplete flag
-  bool IsStripPairingIncomplete() const { return m_StripPairingIncomplete; }
+  bool IsStripPairingIncomplete() const { return HasQualityFlag(c_QualityStripPairingIncomplete); }
 
   //! Set the LLD Event flag
-  void SetLLDEvent(bool Flag = true, MString Text = "") { m_LLDEvent = Flag; m_LLDEventString = Text; }
+  void SetLLDEvent(bool Flag = true, MString Text = "") { SetQualityFlag(c_QualityLLDEvent, Flag, Text); }
   //! Get the LLD Event flag
-  bool IsLLDEvent() const {return m_LLDEvent;}
+  bool IsLLDEvent() const { return HasQualityFlag(c_QualityLLDEvent); }
 
   //! Set the depth-calibration-incomplete flag
-  void SetDepthCalibrationIncomplete(bool Flag = true, MString Text = "") { m_DepthCalibrationIncomplete = Flag;  m_DepthCalibrationIncompleteString = Text; }
+  void SetDepthCalibrationIncomplete(bool Flag = true, MString Text = "") { SetQualityFlag(c_QualityDepthCalibrationIncomplete, Flag, Text); }
   //! Get the depth-calibration-incomplete flag
-  bool IsDepthCalibrationIncomplete() const { return m_DepthCalibrationIncomplete; }
+  bool IsDepthCalibrationIncomplete() const { return HasQualityFlag(c_QualityDepthCalibrationIncomplete); }
 
   //! Set the depth-calibration out of range flag
-  void SetDepthCalibration_OutofRange(bool Flag = true, MString Text = "") {m_DepthCalibration_OutofRange = Flag; m_DepthCalibration_OutofRangeString = Text; }
+  void SetDepthCalibration_OutofRange(bool Flag = true, MString Text = "") { SetQualityFlag(c_QualityDepthCalibration_OutofRange, Flag, Text); }
   //! Get the depth calibration out of range flag
-  bool IsDepthCalibration_OutofRange() const { return m_DepthCalibration_OutofRange; }
+  bool IsDepthCalibration_OutofRange() const { return HasQualityFlag(c_QualityDepthCalibration_OutofRange); }
 
   //! Set the filtered-out flag
-  void SetFilteredOut(bool Flag = true) { m_FilteredOut = Flag; }
+  void SetFilteredOut(bool Flag = true) { SetQualityFlag(c_QualityFilteredOut, Flag); }
   //! Get the filgtered-out flag
-  bool IsFilteredOut() const { return m_FilteredOut; }
+  bool IsFilteredOut() const { return HasQualityFlag(c_QualityFilteredOut); }
 
   //! Returns true if none of the "bad" or "incomplete" flags has been set and the event has not been filtered out or rejected
-  bool IsGood() const;
+  bool IsGood() const { return (m_QualityFlags & c_QualityNotGood) == 0; }
   //! Returns true if any of the "bad" or "incomplete" flags has been set
-  bool IsBad() const;
+  bool IsBad() const { return (m_QualityFlags & c_QualityBad) != 0; }
+
+  //! Return the code of an interned quality reason text - the code 0 is the empty text
+  static uint16_t InternQualityReason(const MString& Text);
+  //! Return the text belonging to an interned quality reason code
+  static MString GetQualityReasonText(uint16_t Code);
 
   //! Set a specific analysis progress
   void SetAnalysisProgress(uint64_t Progress) { m_AnalysisProgress |= Progress; }
@@ -294,7 +365,12 @@ class MReadOutAssembly : public MReadOutSequence
 
   // private methods:
  private:
-
+  //! Hand all strip hits, hits and guard ring hits back to their object pools
+  void ReleaseHits();
+  //! Build the (detector, side) strip hit index if it is not up to date
+  void BuildStripHitIndex() const;
+  //! Stream the "BD" lines of all set quality flags contained in the mask
+  void StreamQualityFlags(ostream& S, uint64_t Mask) const;
 
 
   // protected members:
@@ -359,6 +435,17 @@ class MReadOutAssembly : public MReadOutSequence
   //! List of strip hits
   vector<MStripHit*> m_StripHits;
 
+  //! The number of (detector, side) slots in the strip hit index - the last one holds strip hits with an invalid detector ID
+  static const unsigned int c_NStripHitIndexSlots = 2*12 + 1;
+  //! True if the strip hit index is up to date
+  mutable bool m_StripHitIndexValid;
+  //! The strip hits ordered by (detector, side) - the order within a slot is the one of m_StripHits
+  mutable vector<MStripHit*> m_StripHitIndex;
+  //! The structure-of-arrays view of the strip hits
+  MStripHitArrays m_StripHitArrays;
+  //! The start of each (detector, side) slot in m_StripHitIndex, the last entry is the end
+  mutable unsigned int m_StripHitIndexStart[c_NStripHitIndexSlots+1];
+
   //! List of strip hits with timing only
   vector<MStripHit*> m_StripHitsTOnly;
 
@@ -374,30 +461,10 @@ class MReadOutAssembly : public MReadOutSequence
   //! The physical event from event reconstruction
   MPhysicalEvent* m_PhysicalEvent; 
 
-  // Flags indicating the quality of the event
-  bool m_AspectIncomplete;
-  MString m_AspectIncompleteString;
-  bool m_TimeIncomplete;
-  MString m_TimeIncompleteString;
-  bool m_EnergyCalibrationIncomplete_BadStrip;
-  MString m_EnergyCalibrationIncomplete_BadStripString;
-  bool m_EnergyCalibrationIncomplete;
-  MString m_EnergyCalibrationIncompleteString;
-  bool m_EnergyResolutionCalibrationIncomplete;
-  MString m_EnergyResolutionCalibrationIncompleteString;
-  bool m_StripPairingIncomplete;
-  MString m_StripPairingIncompleteString;
-  bool m_LLDEvent;
-  MString m_LLDEventString;
-  bool m_DepthCalibrationIncomplete;
-  MString m_DepthCalibrationIncompleteString;
-  bool m_DepthCalibration_OutofRange;
-  MString m_DepthCalibration_OutofRangeString;  
-
-
-
-  //! True if event has been filtered out
-  bool m_FilteredOut;
+  //! The quality flags of the event (c_Quality...)
+  uint64_t m_QualityFlags;
+  //! The interned reason codes belonging to the quality flags - only valid if the flag is set
+  uint16_t m_QualityReasons[c_NQualityFlags];
 
   //! The analysis progress 
   uint64_t m_AnalysisProgress;
@@ -0,0 +1,173 @@
+/*
+ * MSPSCQueue.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MSPSCQueue__
+#define __MSPSCQueue__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! A bounded lock-free queue for exactly one producer thread and one consumer thread.
+//! Items are swapped in and out of the slots instead of being copied. Thus, with vectors as
+//! items, the producer gets back the buffers the consumer has returned earlier, and the
+//! steady state does not allocate.
+//! The queue counts how often the producer found it full, which measures the backpressure.
+template <class T>
+class MSPSCQueue
+{
+  // public interface:
+ public:
+  //! Default constructor - the capacity is rounded up to the next power of 2
+  explicit MSPSCQueue(size_t Capacity = 1024);
+
+  //! Producer: swap the item into the queue, return false if the queue is full
+  //! On success the item holds a recycled item from the queue
+  bool TryPush(T& Item);
+  //! Consumer: swap the oldest item out of the queue, return false if the queue is empty
+  //! The previous content of the item is kept in the queue for reuse
+  bool TryPop(T& Item);
+
+  //! Producer: count one push attempt on a full queue
+  void AddFull() { m_NFull.fetch_add(1, memory_order_relaxed); }
+
+  //! Return the capacity of the queue
+  size_t GetCapacity() const { return m_Slots.size(); }
+  //! Return the number of items in the queue - only a snapshot when called from a third thread
+  size_t GetSize() const { return m_Tail.load(memory_order_acquire) - m_Head.load(memory_order_acquire); }
+  //! Return the number of items pushed so far
+  uint64_t GetNPushed() const { return m_Tail.load(memory_order_acquire); }
+  //! Return the largest number of items the consumer found in the queue
+  uint64_t GetMaxSize() const { return m_MaxSize.load(memory_order_relaxed); }
+  //! Return how often the producer found the queue full
+  uint64_t GetNFull() const { return m_NFull.load(memory_order_relaxed); }
+
+  //! Remove all items and reset the counters - neither producer nor consumer may be active
+  void Clear();
+
+
+  // private members:
+ private:
+  //! The slots
+  vector<T> m_Slots;
+  //! The mask to map a position onto a slot
+  size_t m_Mask;
+
+  //! The position of the next item to pop - only written by the consumer
+  alignas(64) atomic<uint64_t> m_Head;
+  //! The largest number of items in the queue - only written by the consumer
+  atomic<uint64_t> m_MaxSize;
+  //! The position of the next item to push - only written by the producer
+  alignas(64) atomic<uint64_t> m_Tail;
+  //! The producer's copy of the head - avoids touching the consumer's cache line on each push
+  alignas(64) uint64_t m_CachedHead;
+  //! How often the producer found the queue full - only written by the producer
+  atomic<uint64_t> m_NFull;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+template <class T>
+MSPSCQueue<T>::MSPSCQueue(size_t Capacity) : m_Head(0), m_MaxSize(0), m_Tail(0), m_CachedHead(0), m_NFull(0)
+{
+  //! Default constructor
+
+  size_t Size = 1;
+  while (Size < Capacity) Size <<= 1;
+  m_Slots.resize(Size);
+  m_Mask = Size - 1;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+template <class T>
+bool MSPSCQueue<T>::TryPush(T& Item)
+{
+  //! Producer: swap the item into the queue, return false if the queue is full
+
+  uint64_t Tail = m_Tail.load(memory_order_relaxed);
+  if (Tail - m_CachedHead == m_Slots.size()) {
+    m_CachedHead = m_Head.load(memory_order_acquire);
+    if (Tail - m_CachedHead == m_Slots.size()) return false;
+  }
+
+  swap(m_Slots[Tail & m_Mask], Item);
+  m_Tail.store(Tail + 1, memory_order_release);
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+template <class T>
+bool MSPSCQueue<T>::TryPop(T& Item)
+{
+  //! Consumer: swap the oldest item out of the queue, return false if the queue is empty
+
+  uint64_t Head = m_Head.load(memory_order_relaxed);
+  uint64_t Tail = m_Tail.load(memory_order_acquire);
+  if (Head == Tail) return false;
+
+  // The consumer sees the occupancy anyway, thus it tracks the maximum and the push stays cheap
+  if (Tail - Head > m_MaxSize.load(memory_order_relaxed)) m_MaxSize.store(Tail - Head, memory_order_relaxed);
+
+  swap(m_Slots[Head & m_Mask], Item);
+  m_Head.store(Head + 1, memory_order_release);
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+template <class T>
+void MSPSCQueue<T>::Clear()
+{
+  //! Remove all items and reset the counters
+
+  for (T& Slot: m_Slots) Slot = T();
+  m_Head = 0;
+  m_Tail = 0;
+  m_CachedHead = 0;
+  m_MaxSize = 0;
+  m_NFull = 0;
+}
+
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
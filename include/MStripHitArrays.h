@@ -0,0 +1,168 @@
+/*
+ * MStripHitArrays.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MStripHitArrays__
+#define __MStripHitArrays__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+
+// Nuclearizer libs
+#include "MStripHit.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! A structure-of-arrays view of the strip hits of one event
+//! The strip hits are stored grouped by (detector, side), thus each group is a
+//! contiguous range [GetBegin(), GetEnd()) in all arrays.
+//! The view is a copy: Load() gathers the values from the strip hit objects,
+//! Store() writes the modifiable values (ADC units, timing, energy, energy resolution,
+//! preamp temperature) back. Detector ID, strip ID and side are read-only.
+class MStripHitArrays
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MStripHitArrays();
+  //! Default destructor
+  virtual ~MStripHitArrays();
+
+  //! The columns which can be loaded
+  static const unsigned int c_ColumnIDs               = (1 << 0);
+  static const unsigned int c_ColumnADCUnits          = (1 << 1);
+  static const unsigned int c_ColumnTimings           = (1 << 2);
+  static const unsigned int c_ColumnEnergies          = (1 << 3);
+  static const unsigned int c_ColumnEnergyResolutions = (1 << 4);
+  static const unsigned int c_ColumnPreampTemps       = (1 << 5);
+  static const unsigned int c_ColumnAll               = (1 << 6) - 1;
+
+  //! Reset all data - the arrays keep their capacity
+  void Clear();
+
+  //! Gather the values from the strip hits, which are grouped into NSlots (detector, side) slots
+  //! starting at SlotStart[s] - SlotStart must have NSlots+1 entries
+  //! Only the given columns (c_Column...) are gathered, the others are empty
+  void Load(const vector<MStripHit*>& StripHits, const unsigned int* SlotStart, unsigned int NSlots, unsigned int Columns = c_ColumnAll);
+  //! Write the loaded modifiable values back to the strip hits
+  void Store() const;
+
+  //! Return the loaded columns
+  unsigned int GetColumns() const { return m_Columns; }
+
+  //! Return the number of strip hits
+  unsigned int GetSize() const { return m_StripHits.size(); }
+
+  //! Return the first element of one side of a detector
+  unsigned int GetBegin(int DetectorID, bool IsXStrip) const;
+  //! Return the element after the last one of one side of a detector
+  unsigned int GetEnd(int DetectorID, bool IsXStrip) const;
+
+  //! Return the strip hit object behind element i
+  MStripHit* GetStripHit(unsigned int i) const { return m_StripHits[i]; }
+
+  //! Return the detector IDs
+  const int* GetDetectorIDs() const { return m_DetectorIDs.data(); }
+  //! Return the strip IDs
+  const int* GetStripIDs() const { return m_StripIDs.data(); }
+  //! Return the strip sides (1: x-strip, 0: y-strip)
+  const unsigned char* GetIsXStrips() const { return m_IsXStrips.data(); }
+
+  //! Return the ADC units
+  double* GetADCUnits() { return m_ADCUnits.data(); }
+  //! Return the ADC units
+  const double* GetADCUnits() const { return m_ADCUnits.data(); }
+
+  //! Return the timings
+  double* GetTimings() { return m_Timings.data(); }
+  //! Return the timings
+  const double* GetTimings() const { return m_Timings.data(); }
+
+  //! Return the energies
+  double* GetEnergies() { return m_Energies.data(); }
+  //! Return the energies
+  const double* GetEnergies() const { return m_Energies.data(); }
+
+  //! Return the energy resolutions
+  double* GetEnergyResolutions() { return m_EnergyResolutions.data(); }
+  //! Return the energy resolutions
+  const double* GetEnergyResolutions() const { return m_EnergyResolutions.data(); }
+
+  //! Return the preamp temperatures
+  double* GetPreampTemps() { return m_PreampTemps.data(); }
+  //! Return the preamp temperatures
+  const double* GetPreampTemps() const { return m_PreampTemps.data(); }
+
+
+  // protected methods:
+ protected:
+
+  // private methods:
+ private:
+  //! Return the slot of one side of a detector
+  unsigned int GetSlot(int DetectorID, bool IsXStrip) const;
+
+
+  // protected members:
+ protected:
+
+
+  // private members:
+ private:
+  //! The strip hit objects behind the arrays
+  vector<MStripHit*> m_StripHits;
+  //! The start of each (detector, side) slot, the last entry is the end
+  vector<unsigned int> m_SlotStart;
+  //! The loaded columns
+  unsigned int m_Columns;
+
+  //! The detector IDs
+  vector<int> m_DetectorIDs;
+  //! The strip IDs
+  vector<int> m_StripIDs;
+  //! The strip sides
+  vector<unsigned char> m_IsXStrips;
+  //! The ADC units
+  vector<double> m_ADCUnits;
+  //! The timings
+  vector<double> m_Timings;
+  //! The energies
+  vector<double> m_Energies;
+  //! The energy resolutions
+  vector<double> m_EnergyResolutions;
+  //! The preamp temperatures
+  vector<double> m_PreampTemps;
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MStripHitArrays, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
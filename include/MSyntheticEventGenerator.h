@@ -0,0 +1,155 @@
+/*
+ * MSyntheticEventGenerator.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MSyntheticEventGenerator__
+#define __MSyntheticEventGenerator__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+using namespace std;
+
+// ROOT libs:
+#include "TRandom3.h"
+
+// MEGAlib libs:
+#include "MGlobal.h"
+
+// Nuclearizer libs:
+#include "MReadOutAssembly.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Fills read-out assemblies with synthetic strip hits for benchmarks.
+//! Each event consists of a number of interactions (the multiplicity) in randomly chosen
+//! detectors. An interaction triggers one x and one y strip with a depth-dependent timing
+//! (linear drift model); with the charge-sharing probability a neighboring strip shares
+//! part of the energy. The energy is drawn from a line on a flat continuum and is stored
+//! both as energy and, via a linear gain, as ADC value, thus the events can be fed to the
+//! energy calibration as well as directly to the later modules.
+class MSyntheticEventGenerator
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MSyntheticEventGenerator();
+  //! Default destructor
+  virtual ~MSyntheticEventGenerator();
+
+  //! Set the seed of the random number generator
+  void SetSeed(unsigned int Seed) { m_Random.SetSeed(Seed); }
+
+  //! Set the number of interactions per event
+  void SetMultiplicity(unsigned int Multiplicity) { m_Multiplicity = (Multiplicity > 0) ? Multiplicity : 1; }
+  //! Return the number of interactions per event
+  unsigned int GetMultiplicity() const { return m_Multiplicity; }
+
+  //! Set the probability that an interaction shares charge with a neighboring strip (per side)
+  void SetChargeSharingProbability(double Probability) { m_ChargeSharingProbability = Probability; }
+  //! Return the probability that an interaction shares charge with a neighboring strip
+  double GetChargeSharingProbability() const { return m_ChargeSharingProbability; }
+
+  //! Set the detectors from which the interactions are drawn
+  void SetDetectors(const vector<int>& Detectors) { if (Detectors.size() > 0) m_Detectors = Detectors; }
+  //! Return the detectors from which the interactions are drawn
+  const vector<int>& GetDetectors() const { return m_Detectors; }
+
+  //! Set the number of strips per side
+  void SetNStrips(unsigned int NStrips) { m_NStrips = (NStrips > 1) ? NStrips : 2; }
+
+  //! Set the mean event rate in Hz - the event times are exponentially distributed
+  void SetEventRate(double Rate) { m_EventRate = (Rate > 0) ? Rate : 1.0; }
+  //! Set the drift time through the full detector thickness and the timing noise (both in ns)
+  void SetTiming(double DriftTime, double Noise) { m_DriftTime = DriftTime; m_TimingNoise = Noise; }
+
+  //! Set the line energy, the fraction of events in the line, and the continuum range (all energies in keV)
+  void SetSpectrum(double LineEnergy, double LineFraction, double ContinuumMin, double ContinuumMax);
+  //! Set the linear conversion ADC = Offset + Gain * Energy
+  void SetADCConversion(double Offset, double Gain) { m_ADCOffset = Offset; m_ADCGain = Gain; }
+
+  //! Fill the (cleared) event with the next synthetic event
+  void Generate(MReadOutAssembly* Event);
+
+
+  // protected methods:
+ protected:
+  //! Add one strip hit to the event
+  void AddStripHit(MReadOutAssembly* Event, int DetectorID, int StripID, bool IsXStrip, double Energy, double Timing);
+
+  // private methods:
+ private:
+
+
+
+  // protected members:
+ protected:
+  //! The random number generator
+  TRandom3 m_Random;
+
+  //! The number of interactions per event
+  unsigned int m_Multiplicity;
+  //! The probability of charge sharing with a neighboring strip
+  double m_ChargeSharingProbability;
+  //! The detectors
+  vector<int> m_Detectors;
+  //! The number of strips per side
+  unsigned int m_NStrips;
+
+  //! The mean event rate in Hz
+  double m_EventRate;
+  //! The drift time through the detector in ns
+  double m_DriftTime;
+  //! The timing noise in ns
+  double m_TimingNoise;
+
+  //! The line energy in keV
+  double m_LineEnergy;
+  //! The fraction of events in the line
+  double m_LineFraction;
+  //! The minimum energy of the continuum in keV
+  double m_ContinuumMin;
+  //! The maximum energy of the continuum in keV
+  double m_ContinuumMax;
+  //! The energy resolution (1 sigma) in keV
+  double m_EnergyResolution;
+
+  //! The ADC offset
+  double m_ADCOffset;
+  //! The ADC gain per keV
+  double m_ADCGain;
+
+  //! The ID of the next event
+  unsigned long m_NextID;
+  //! The time of the last event in seconds
+  double m_Time;
+
+  // private members:
+ private:
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MSyntheticEventGenerator, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
@@ -17,7 +17,7 @@
 #include <string.h>
 #include "GCUHousekeepingParser.h"
 
-struct GCUHousekeepingPacket* ParseGCUHousekeepingPacket(uint8_t* RawData) {
+struct GCUHousekeepingPacket* ParseGCUHousekeepingPacket(const uint8_t* RawData) {
   uint16_t byteIndex = 0;
   uint8_t bitIndex = 7;
   struct GCUHousekeepingPacket* packet;
@@ -27,11 +27,11 @@ struct GCUHousekeepingPacket* ParseGCUHousekeepingPacket(uint8_t* RawData) {
   return packet;
 }
 
-void ParseGCUHousekeepingPacketWrapper(uint8_t* RawData, void* packet_bytes) {
+void ParseGCUHousekeepingPacketWrapper(const uint8_t* RawData, void* packet_bytes) {
   ParseAllocatedGCUHousekeepingPacket(RawData, (struct GCUHousekeepingPacket*)packet_bytes);
 }
 
-void ParseAllocatedGCUHousekeepingPacket(uint8_t* RawData, struct GCUHousekeepingPacket* packet) {
+void ParseAllocatedGCUHousekeepingPacket(const uint8_t* RawData, struct GCUHousekeepingPacket* packet) {
   uint16_t i;
   uint16_t j;
   packet->Sync = (((uint16_t)RawData[0]) << 8) | ((uint16_t)RawData[1]);
@@ -17,7 +17,7 @@
 #include <string.h>
 #include "GCUSettingsParser.h"
 
-struct GCUSettingsPacket* ParseGCUSettingsPacket(uint8_t* RawData) {
+struct GCUSettingsPacket* ParseGCUSettingsPacket(const uint8_t* RawData) {
   uint16_t byteIndex = 0;
   uint8_t bitIndex = 7;
   struct GCUSettingsPacket* packet;
@@ -27,11 +27,11 @@ struct GCUSettingsPacket* ParseGCUSettingsPacket(uint8_t* RawData) {
   return packet;
 }
 
-void ParseGCUSettingsPacketWrapper(uint8_t* RawData, void* packet_bytes) {
+void ParseGCUSettingsPacketWrapper(const uint8_t* RawData, void* packet_bytes) {
   ParseAllocatedGCUSettingsPacket(RawData, (struct GCUSettingsPacket*)packet_bytes);
 }
 
-void ParseAllocatedGCUSettingsPacket(uint8_t* RawData, struct GCUSettingsPacket* packet) {
+void ParseAllocatedGCUSettingsPacket(const uint8_t* RawData, struct GCUSettingsPacket* packet) {
   uint16_t i;
   packet->Sync = (((uint16_t)RawData[0]) << 8) | ((uint16_t)RawData[1]);
   packet->PacketID = ((uint8_t)RawData[2]);
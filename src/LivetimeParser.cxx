@@ -13,7 +13,7 @@ Written by Clio Sleator
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void ParseLivetime(struct LivetimePacket* packet, uint8_t* RawData){
+void ParseLivetime(struct LivetimePacket* packet, const uint8_t* RawData){
 
 	int dx = 10;
 
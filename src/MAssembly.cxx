@@ -28,9 +28,12 @@
 
 // Standard libs:
 #include <iostream>
+#include <fstream>
 #include <sstream>
 #include <vector>
 #include <csignal>
+#include <iomanip>
+#include <sys/resource.h>
 using namespace std;
 
 // ROOT libs:
@@ -50,6 +53,7 @@ using namespace std;
 #include "MString.h"
 #include "MTimer.h"
 #include "MFile.h"
+#include "MDGeometryQuest.h"
 
 // Nuclearizer libs:
 #include "MReadOutAssembly.h"
@@ -73,6 +77,7 @@ using namespace std;
 #include "MModuleEventFilter.h"
 #include "MModuleEventSaver.h"
 #include "MModuleResponseGenerator.h"
+#include "MModulePipeline.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -90,8 +95,17 @@ MAssembly::MAssembly()
 {
   // standard constructor
     
+  m_CreationTime = chrono::steady_clock::now();
+  
   m_Interrupt = false;
   m_UseGui = true;
+  m_BatchSize = 0;
+  m_NReplicas = 0;
+  m_UseMultiThreading = true;
+  m_StatisticsFileName = "";
+  m_BenchmarkConfiguration = "";
+  m_BenchmarkFileName = "";
+  m_Pipeline = nullptr;
   
   g_Verbosity = c_Error;
   
@@ -104,7 +118,7 @@ MAssembly::MAssembly()
   MFile::ExpandFileName(Cfg);
   m_Supervisor->SetConfigurationFileName(Cfg);
   
-  m_Supervisor->UseMultiThreading(true);
+  m_Supervisor->UseMultiThreading(m_UseMultiThreading);
   
   m_Supervisor->AddAvailableModule(new MModuleLoaderSimulationsBalloon());
   m_Supervisor->AddAvailableModule(new MModuleLoaderSimulationsSMEX());
@@ -164,9 +178,24 @@ bool MAssembly::ParseCommandLine(int argc, char** argv)
   Usage<<"             E.g. to change the roa file, one would set pattern to:"<<endl;
   Usage<<"             -C ModuleOptions.XmlTagMeasurementLoaderROA.FileName=My.roa"<<endl;
   Usage<<"      -a --auto:"<<endl;
-  Usage<<"             Automatically start analysis without GUI"<<endl;
+  Usage<<"             Automatically start analysis without GUI: the module chain runs in nuclearizer's own pipeline,"<<endl;
+  Usage<<"             which times all modules and prints the per-module statistics at the end"<<endl;
+  Usage<<"      -b --batch <size>:"<<endl;
+  Usage<<"             In --auto mode: hand the events from module to module in batches of this size (default: 64)"<<endl;
+  Usage<<"      -r --replicas <number>:"<<endl;
+  Usage<<"             In --auto mode: run each module in its own thread and modules which support it as this"<<endl;
+  Usage<<"             many parallel clones; the event order is kept"<<endl;
+  Usage<<"      -s --statistics <filename>.json:"<<endl;
+  Usage<<"             In --auto mode: write the per-module statistics to this file"<<endl;
+  Usage<<"      --benchmark <filename>.cfg:"<<endl;
+  Usage<<"             Run this configuration without GUI through the pipeline, write the saved events to /dev/null,"<<endl;
+  Usage<<"             and write events/s, time per module, peak memory, and startup time as JSON"<<endl;
+  Usage<<"             to <configuration base name>.benchmark.json in the current directory"<<endl;
+  Usage<<"      --benchmark-output <filename>.json:"<<endl;
+  Usage<<"             Write the benchmark result to this file instead"<<endl;
   Usage<<"      -m --multithreading:"<<endl;
-  Usage<<"             0: false (default), else: true"<<endl;
+  Usage<<"             0: false, else: true (default)"<<endl;
+  Usage<<"             In --auto mode without --replicas: run each module in its own thread"<<endl;
   Usage<<"      -g --geometry:"<<endl;
   Usage<<"             Use this geometry file"<<endl;
   Usage<<"      -t --test:"<<endl;
@@ -196,6 +225,11 @@ bool MAssembly::ParseCommandLine(int argc, char** argv)
     // Single argument
     if (Option == "-c" || Option == "--configuration" ||
         Option == "-g" || Option == "--geometry" ||
+        Option == "-b" || Option == "--batch" ||
+        Option == "-r" || Option == "--replicas" ||
+        Option == "-s" || Option == "--statistics" ||
+        Option == "--benchmark" ||
+        Option == "--benchmark-output" ||
         Option == "-m" || Option == "--multithreading") {
       if (!((argc > i+1) && argv[i+1][0] != '-')){
         cout<<"Error: Option "<<argv[i][1]<<" needs a second argument!"<<endl;
@@ -215,8 +249,25 @@ bool MAssembly::ParseCommandLine(int argc, char** argv)
       g_Verbosity = atoi(argv[++i]);
       cout<<"Command-line parser: Verbosity "<<g_Verbosity<<endl;
     } else if (Option == "--multithreading" || Option == "-m") {
-      m_Supervisor->UseMultiThreading((atoi(argv[++i]) != 0 ? true : false));
-      cout<<"Command-line parser: Using multithreading: "<<(atoi(argv[i]) != 0 ? "yes" : "no")<<endl;
+      m_UseMultiThreading = (atoi(argv[++i]) != 0 ? true : false);
+      m_Supervisor->UseMultiThreading(m_UseMultiThreading);
+      cout<<"Command-line parser: Using multithreading: "<<(m_UseMultiThreading == true ? "yes" : "no")<<endl;
+    } else if (Option == "--batch" || Option == "-b") {
+      m_BatchSize = atoi(argv[++i]);
+      cout<<"Command-line parser: Batch size: "<<m_BatchSize<<endl;
+    } else if (Option == "--replicas" || Option == "-r") {
+      m_NReplicas = atoi(argv[++i]);
+      cout<<"Command-line parser: Replicas: "<<m_NReplicas<<endl;
+    } else if (Option == "--benchmark") {
+      m_BenchmarkConfiguration = argv[++i];
+      m_Supervisor->Load(m_BenchmarkConfiguration);
+      cout<<"Command-line parser: Benchmark with configuration file "<<m_BenchmarkConfiguration<<endl;
+    } else if (Option == "--benchmark-output") {
+      m_BenchmarkFileName = argv[++i];
+      cout<<"Command-line parser: Benchmark output file: "<<m_BenchmarkFileName<<endl;
+    } else if (Option == "--statistics" || Option == "-s") {
+      m_StatisticsFileName = argv[++i];
+      cout<<"Command-line parser: Statistics file: "<<m_StatisticsFileName<<endl;
     } else if (Option == "--test" || Option == "-t") {
       // Parse later
     } else if (Option == "--auto" || Option == "-a") {
@@ -236,6 +287,13 @@ bool MAssembly::ParseCommandLine(int argc, char** argv)
     }
   }  
   
+  // A benchmark measures the processing, not the disk: the saved events go to the null device
+  if (m_BenchmarkConfiguration != "") {
+    m_Supervisor->ChangeConfiguration("ModuleOptions.XmlTagEventSaver.FileName=/dev/null");
+    m_Supervisor->ChangeConfiguration("ModuleOptions.XmlTagEventSaver.AddTimeTag=false");
+    m_Supervisor->ChangeConfiguration("ModuleOptions.XmlTagEventSaver.SplitFile=false");
+  }
+  
   for (int i = 1; i < argc; i++) {
     Option = argv[i];
     if (Option == "--geometry" || Option == "-g") {
@@ -245,13 +303,25 @@ bool MAssembly::ParseCommandLine(int argc, char** argv)
   }
   
   // Now parse all high level options
+  if (m_BenchmarkConfiguration != "") {
+    m_UseGui = false;
+    gROOT->SetBatch(true);
+    m_Supervisor->UseUI(false);
+    AnalyzeWithPipeline();
+    m_Supervisor->Exit();
+    return false;
+  }
   for (int i = 1; i < argc; i++) {
     Option = argv[i];
     if (Option == "--auto" || Option == "-a") {
       m_UseGui = false;
       gROOT->SetBatch(true);
       m_Supervisor->UseUI(false);
-      m_Supervisor->Analyze();
+      // The pipeline's stage threads replace the module threads of the supervisor
+      if (m_NReplicas == 0 && m_UseMultiThreading == true) {
+        m_NReplicas = 1;
+      }
+      AnalyzeWithPipeline();
       m_Supervisor->Exit();
       return false;
     } else if (Option == "--test" || Option == "-t") {
@@ -265,6 +335,9 @@ bool MAssembly::ParseCommandLine(int argc, char** argv)
   }
   
   if (m_UseGui == true) {
+    if (m_BatchSize > 0 || m_NReplicas > 0 || m_StatisticsFileName != "") {
+      cout<<"Warning: --batch, --replicas, and --statistics are only used in --auto mode - the GUI runs the analysis in the supervisor without module statistics"<<endl;
+    }
     if (m_Supervisor->LaunchUI() == false) {
       return false; 
     }
@@ -274,5 +347,130 @@ bool MAssembly::ParseCommandLine(int argc, char** argv)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MAssembly::AnalyzeWithPipeline()
+{
+  //! Run the module chain of the supervisor with nuclearizer's own batch pipeline
+
+  // The supervisor only loads the geometry in its own analysis loop, thus we do it here
+  MDGeometryQuest* Geometry = new MDGeometryQuest();
+  if (Geometry->ScanSetupFile(m_Supervisor->GetGeometryFileName()) == false) {
+    cout<<"Error: Unable to load the geometry "<<m_Supervisor->GetGeometryFileName()<<endl;
+    delete Geometry;
+    return false;
+  }
+
+  m_Pipeline = new MModulePipeline();
+  m_Pipeline->SetBatchSize(m_BatchSize > 0 ? m_BatchSize : 64);
+  m_Pipeline->SetNReplicas(m_NReplicas);
+  m_Pipeline->SetGeometry(Geometry);
+  m_Pipeline->SetStatisticsFileName(m_StatisticsFileName);
+  for (unsigned int m = 0; m < m_Supervisor->GetNModules(); ++m) {
+    m_Pipeline->AddModule(m_Supervisor->GetModule(m));
+  }
+
+  bool Return = m_Pipeline->Analyze();
+  
+  cout<<endl;
+  cout<<"Module statistics:"<<endl;
+  m_Pipeline->GetStatistics().StreamTable(cout);
+  cout<<endl;
+  
+  if (m_BenchmarkConfiguration != "") {
+    WriteBenchmark();
+  }
+
+  MModulePipeline* Pipeline = m_Pipeline;
+  m_Pipeline = nullptr;
+  delete Pipeline;
+  delete Geometry;
+
+  return Return;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MAssembly::WriteBenchmark()
+{
+  //! Write the benchmark result of the pipeline as JSON file
+  //! Without --benchmark-output the name is derived from the configuration file name
+
+  MString FileName = m_BenchmarkFileName;
+  if (FileName == "") {
+    FileName = m_BenchmarkConfiguration;
+    if (FileName.Last('/') != MString::npos) {
+      FileName.RemoveInPlace(0, FileName.Last('/')+1);
+    }
+    if (FileName.EndsWith(".cfg") == true) {
+      FileName.RemoveInPlace(FileName.Length() - 4);
+    }
+    if (FileName.EndsWith(".xml") == true) {
+      FileName.RemoveInPlace(FileName.Length() - 4);
+    }
+    FileName += ".benchmark.json";
+  }
+
+  ofstream out;
+  out.open(FileName.Data());
+  if (out.is_open() == false) {
+    if (g_Verbosity >= c_Error) cout<<"Benchmark: Error: Unable to open file "<<FileName<<endl;
+    return false;
+  }
+
+  StreamBenchmark(out);
+  out.close();
+
+  cout<<"Benchmark: Result written to "<<FileName<<endl;
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MAssembly::StreamBenchmark(ostream& out)
+{
+  //! Stream the benchmark result of the pipeline as JSON
+
+  const MPipelineStatistics& Statistics = m_Pipeline->GetStatistics();
+  double WallTime = Statistics.GetWallTime();
+  // The startup ends when all modules are initialized, i.e. when the statistics start
+  double StartupTime = chrono::duration<double>(Statistics.GetStartTime() - m_CreationTime).count();
+
+  // The peak resident set size is in kB on Linux and in bytes on macOS
+  struct rusage Usage;
+  getrusage(RUSAGE_SELF, &Usage);
+#ifdef __APPLE__
+  double PeakRSS = Usage.ru_maxrss/1048576.0;
+#else
+  double PeakRSS = Usage.ru_maxrss/1024.0;
+#endif
+
+  MString Configuration = m_BenchmarkConfiguration;
+  Configuration.ReplaceAll("\\", "\\\\");
+  Configuration.ReplaceAll("\"", "\\\"");
+
+  out<<setprecision(9);
+  out<<"{"<<endl;
+  out<<"  \"Configuration\": \""<<Configuration<<"\","<<endl;
+  out<<"  \"BatchSize\": "<<m_Pipeline->GetBatchSize()<<","<<endl;
+  out<<"  \"Replicas\": "<<m_Pipeline->GetNReplicas()<<","<<endl;
+  out<<"  \"StartupTime\": "<<StartupTime<<","<<endl;
+  out<<"  \"WallTime\": "<<WallTime<<","<<endl;
+  out<<"  \"EventsLoaded\": "<<m_Pipeline->GetNLoadedEvents()<<","<<endl;
+  out<<"  \"EventsAnalyzed\": "<<m_Pipeline->GetNAnalyzedEvents()<<","<<endl;
+  out<<"  \"EventsPerSecond\": "<<((WallTime > 0) ? m_Pipeline->GetNLoadedEvents()/WallTime : 0.0)<<","<<endl;
+  out<<"  \"PeakRSSMegabytes\": "<<PeakRSS<<","<<endl;
+  Statistics.StreamModules(out, "  ");
+  out<<endl;
+  out<<"}"<<endl;
+}
+
+
 // MAssembly: the end...
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,366 @@
+/*
+ * MBinaryFlightDataFileReader.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MBinaryFlightDataFileReader
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MBinaryFlightDataFileReader.h"
+
+// Standard libs:
+#include <cstring>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MStreams.h"
+
+// Nuclearizer libs:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MBinaryFlightDataFileReader)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+const uint16_t MBinaryFlightDataFileReader::c_MaxPacketLength;
+const size_t MBinaryFlightDataFileReader::c_BatchSize;
+const size_t MBinaryFlightDataFileReader::c_ChunkSize;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MBinaryFlightDataFileReader::MBinaryFlightDataFileReader() : m_Begin(0), m_End(0), m_IsZipped(false), m_Current(nullptr), m_CurrentPacket(0), m_IsDone(true), m_HasError(false), m_Stop(false)
+{
+  // Construct an instance of MBinaryFlightDataFileReader
+
+  m_Batches.resize(c_NBatches);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MBinaryFlightDataFileReader::~MBinaryFlightDataFileReader()
+{
+  // Delete this instance of MBinaryFlightDataFileReader
+
+  Close();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFlightDataFileReader::Open(const MString& FileName, uint64_t Begin, uint64_t End)
+{
+  //! Open the file and start the reading thread, return false on error
+
+  Close();
+
+  m_FileName = FileName;
+  m_Begin = Begin;
+  m_End = End;
+  m_IsZipped = FileName.EndsWith(".gz");
+
+  if (m_IsZipped == true) {
+    if (m_ZipReader.Open(FileName) == false) return false;
+  } else {
+    m_In.clear();
+    m_In.open(FileName.Data(), ios::binary);
+    if (m_In.is_open() == false) return false;
+  }
+
+  m_Filled.clear();
+  m_Empty.clear();
+  for (auto& B: m_Batches) {
+    m_Empty.push_back(&B);
+  }
+  m_Current = nullptr;
+  m_CurrentPacket = 0;
+  m_IsDone = false;
+  m_HasError = false;
+  m_Stop = false;
+
+  m_Thread = thread(&MBinaryFlightDataFileReader::ReadLoop, this);
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataFileReader::Close()
+{
+  //! Stop the reading thread and close the file
+
+  if (m_Thread.joinable() == true) {
+    {
+      lock_guard<mutex> Lock(m_Mutex);
+      m_Stop = true;
+    }
+    m_Condition.notify_all();
+    m_Thread.join();
+  }
+
+  if (m_In.is_open() == true) m_In.close();
+  m_ZipReader.Close();
+
+  m_Filled.clear();
+  m_Empty.clear();
+  m_Current = nullptr;
+  m_CurrentPacket = 0;
+  m_IsDone = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFlightDataFileReader::HasError() const
+{
+  //! Return true if reading failed (e.g. a truncated gzip'ed file)
+
+  lock_guard<mutex> Lock(m_Mutex);
+
+  return m_HasError;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFlightDataFileReader::Next()
+{
+  //! Advance to the next packet - blocks until the reading thread has framed it
+
+  if (m_Current != nullptr) {
+    ++m_CurrentPacket;
+    if (m_CurrentPacket < m_Current->Packets.size()) return true;
+  }
+
+  unique_lock<mutex> Lock(m_Mutex);
+
+  if (m_Current != nullptr) {
+    m_Empty.push_back(m_Current);
+    m_Current = nullptr;
+    m_Condition.notify_all();
+  }
+
+  m_Condition.wait(Lock, [this] { return m_Filled.empty() == false || m_IsDone == true; });
+  if (m_Filled.empty() == true) return false;
+
+  // Batches are never queued empty
+  m_Current = m_Filled.front();
+  m_Filled.pop_front();
+  m_CurrentPacket = 0;
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MBinaryFlightDataFileReader::batch* MBinaryFlightDataFileReader::Exchange(batch* Filled)
+{
+  //! Queue a filled batch and return an empty one - blocks while all batches are in use, returns nullptr if stopped
+
+  unique_lock<mutex> Lock(m_Mutex);
+
+  if (Filled != nullptr) {
+    m_Filled.push_back(Filled);
+    m_Condition.notify_all();
+  }
+
+  m_Condition.wait(Lock, [this] { return m_Empty.empty() == false || m_Stop == true; });
+  if (m_Stop == true) return nullptr;
+
+  batch* Empty = m_Empty.back();
+  m_Empty.pop_back();
+  Empty->Bytes.clear();
+  Empty->Packets.clear();
+
+  return Empty;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataFileReader::ReadLoop()
+{
+  //! The reading thread: read, frame, and queue the packets until the end of the region
+
+  batch* Batch = Exchange(nullptr);
+
+  vector<uint8_t> Chunk;
+  uint64_t Position = 0; // The stream position of the next read byte
+  if (m_IsZipped == false) {
+    Chunk.resize(c_ChunkSize);
+    m_In.seekg(m_Begin);
+    Position = m_Begin;
+  }
+
+  // The buffer holds the not yet framed bytes, starting at stream position BufferOffset
+  vector<uint8_t> Buffer;
+  uint64_t BufferOffset = m_Begin;
+  uint64_t Clock = 0;
+  bool HasError = false;
+
+  while (Batch != nullptr && Position < m_End) {
+    const uint8_t* Data = nullptr;
+    size_t Size = 0;
+    if (m_IsZipped == true) {
+      Size = m_ZipReader.Read(Data);
+      if (Size == 0 && m_ZipReader.HasError() == true) HasError = true;
+    } else {
+      m_In.read(reinterpret_cast<char*>(Chunk.data()), Chunk.size());
+      Size = m_In.gcount();
+      Data = Chunk.data();
+    }
+    if (Size == 0) break;
+
+    // Restrict the chunk to the region - gzip'ed files are always read from the beginning
+    uint64_t ChunkBegin = Position;
+    Position += Size;
+    if (Position <= m_Begin) continue;
+    if (ChunkBegin < m_Begin) {
+      Data += m_Begin - ChunkBegin;
+      Size -= m_Begin - ChunkBegin;
+    }
+    if (Position > m_End) {
+      Size -= Position - m_End;
+    }
+
+    Buffer.insert(Buffer.end(), Data, Data + Size);
+
+    size_t Start = 0;
+    while (Start < Buffer.size()) {
+      const uint8_t* Sync = static_cast<const uint8_t*>(memchr(Buffer.data() + Start, 0xEB, Buffer.size() - Start));
+      if (Sync == nullptr) {
+        Start = Buffer.size();
+        break;
+      }
+      Start = Sync - Buffer.data();
+      if (Start + 10 > Buffer.size()) break;
+      if (IsPlausibleHeader(Buffer.data() + Start) == false) {
+        ++Start;
+        continue;
+      }
+      uint16_t Length = ((uint16_t) Buffer[Start+8] << 8) | ((uint16_t) Buffer[Start+9]);
+      if (Start + Length > Buffer.size()) break;
+
+      uint64_t DataframeClock = GetDataframeClock(Buffer.data() + Start, Length);
+      if (DataframeClock != 0) Clock = DataframeClock;
+
+      packetinfo P;
+      P.Position = Batch->Bytes.size();
+      P.Length = Length;
+      P.Offset = BufferOffset + Start;
+      P.Clock = Clock;
+      Batch->Packets.push_back(P);
+      Batch->Bytes.insert(Batch->Bytes.end(), Buffer.begin() + Start, Buffer.begin() + Start + Length);
+      Start += Length;
+
+      if (Batch->Bytes.size() >= c_BatchSize) {
+        Batch = Exchange(Batch);
+        if (Batch == nullptr) break;
+      }
+    }
+
+    Buffer.erase(Buffer.begin(), Buffer.begin() + Start);
+    BufferOffset += Start;
+  }
+
+  lock_guard<mutex> Lock(m_Mutex);
+  if (Batch != nullptr) {
+    if (Batch->Packets.empty() == false) {
+      m_Filled.push_back(Batch);
+    } else {
+      m_Empty.push_back(Batch);
+    }
+  }
+  m_HasError = HasError;
+  m_IsDone = true;
+  m_Condition.notify_all();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+uint64_t MBinaryFlightDataFileReader::GetDataframeClock(const uint8_t* Packet, uint16_t Length)
+{
+  //! Return the 48-bit system clock of a raw or Compton dataframe, 0 for all other packets
+
+  uint8_t Type = Packet[2] & 0x0f;
+  if (Type == 0x00 && Length >= 18) {
+    // Raw dataframe: little-endian in bytes 12 to 17
+    return ((uint64_t) Packet[17] << 40) | ((uint64_t) Packet[16] << 32) | ((uint64_t) Packet[15] << 24) | ((uint64_t) Packet[14] << 16) | ((uint64_t) Packet[13] << 8) | ((uint64_t) Packet[12]);
+  } else if (Type == 0x01 && Length >= 16) {
+    // Compton dataframe: big-endian in bytes 10 to 15
+    return ((uint64_t) Packet[10] << 40) | ((uint64_t) Packet[11] << 32) | ((uint64_t) Packet[12] << 24) | ((uint64_t) Packet[13] << 16) | ((uint64_t) Packet[14] << 8) | ((uint64_t) Packet[15]);
+  }
+
+  return 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFlightDataFileReader::IsPlausibleHeader(const uint8_t* Header)
+{
+  //! Return true if the packet header (at least 10 bytes) is plausible
+
+  if (Header[0] != 0xEB || Header[1] != 0x90) return false;
+
+  // Same checks as the parser uses when resynchronizing
+  uint16_t Length = ((uint16_t) Header[8] << 8) | ((uint16_t) Header[9]);
+  if (Length < 10 || Length > c_MaxPacketLength) return false;
+
+  switch (Header[2] & 0x0f) {
+    case 0x00:
+    case 0x01:
+    case 0x05:
+    case 0x06:
+    case 0x07:
+    case 0x0b:
+      return true;
+    default:
+      return false;
+  }
+}
+
+
+// MBinaryFlightDataFileReader.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,341 @@
+/*
+ * MBinaryFlightDataIndex.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MBinaryFlightDataIndex
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MBinaryFlightDataIndex.h"
+
+// Standard libs:
+#include <fstream>
+#include <cstring>
+#include <limits>
+#include <sys/stat.h>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MStreams.h"
+
+// Nuclearizer libs:
+#include "MBinaryFlightDataFileReader.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MBinaryFlightDataIndex)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+const uint8_t MBinaryFlightDataIndex::c_NoCCId;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! The first bytes of an index file
+static const char g_IndexFileMagic[8] = { 'N', 'B', 'F', 'I', 'D', 'X', '0', '1' };
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MBinaryFlightDataIndex::MBinaryFlightDataIndex() : m_DataFileSize(0), m_UnixTimeMSB(0), m_HasUnixTimeMSB(false)
+{
+  // Construct an instance of MBinaryFlightDataIndex
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MBinaryFlightDataIndex::~MBinaryFlightDataIndex()
+{
+  // Delete this instance of MBinaryFlightDataIndex
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+uint64_t MBinaryFlightDataIndex::GetFileSize(const MString& FileName)
+{
+  //! Return the size of the file on disk (0 if it does not exist)
+
+  struct stat Status;
+  if (stat(FileName.Data(), &Status) != 0) return 0;
+
+  return Status.st_size;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFlightDataIndex::Load(const MString& DataFileName)
+{
+  //! Read the sidecar index of the data file - build and write it if it does not exist or is outdated
+
+  MString IndexFileName = GetIndexFileName(DataFileName);
+
+  if (Read(IndexFileName, GetFileSize(DataFileName)) == true) {
+    if (g_Verbosity >= c_Info) cout<<"Binary flight data index: Read index of "<<m_Entries.size()<<" packets from \""<<IndexFileName<<"\""<<endl;
+    return true;
+  }
+
+  if (g_Verbosity >= c_Info) cout<<"Binary flight data index: Indexing file \""<<DataFileName<<"\" - this is done only once"<<endl;
+  if (Build(DataFileName) == false) return false;
+
+  // Not being able to store the index (e.g. a read-only directory) just means we have to build it again next time
+  if (Write(IndexFileName) == false) {
+    if (g_Verbosity >= c_Warning) cout<<"Binary flight data index: Warning: Unable to write the index file \""<<IndexFileName<<"\""<<endl;
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFlightDataIndex::Build(const MString& DataFileName)
+{
+  //! Scan the (uncompressed or gzip'ed) data file and build the index
+
+  m_Entries.clear();
+  m_DataFileSize = GetFileSize(DataFileName);
+  m_UnixTimeMSB = 0;
+  m_HasUnixTimeMSB = false;
+
+  MBinaryFlightDataFileReader Reader;
+  if (Reader.Open(DataFileName) == false) {
+    if (g_Verbosity >= c_Error) cout<<"Binary flight data index: Error: Unable to open file \""<<DataFileName<<"\""<<endl;
+    return false;
+  }
+
+  while (Reader.Next() == true) {
+    AddPacket(Reader.GetPacket(), Reader.GetLength(), Reader.GetOffset());
+  }
+
+  if (Reader.HasError() == true) {
+    if (g_Verbosity >= c_Warning) cout<<"Binary flight data index: Warning: Unable to read file \""<<DataFileName<<"\" completely - only the readable part is indexed"<<endl;
+  }
+  Reader.Close();
+
+  if (m_HasUnixTimeMSB == false && m_Entries.size() > 0) {
+    if (g_Verbosity >= c_Warning) cout<<"Binary flight data index: Warning: No GCU housekeeping packet in file \""<<DataFileName<<"\" - only the lower 24 bits of the Unix times are known"<<endl;
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataIndex::AddPacket(const uint8_t* Packet, uint16_t Length, uint64_t Offset)
+{
+  //! Add the packet at the given offset to the index
+
+  entry E;
+  E.Offset = Offset;
+  E.Length = Length;
+  E.Type = Packet[2] & 0x0f;
+  E.CCId = c_NoCCId;
+  E.UnixTime = ((uint32_t) Packet[3] << 16) | ((uint32_t) Packet[4] << 8) | ((uint32_t) Packet[5]);
+
+  E.Clock = MBinaryFlightDataFileReader::GetDataframeClock(Packet, Length);
+
+  if (E.Type == 0x00 && Length > 10) {
+    // Raw dataframe: card cage in byte 10
+    E.CCId = Packet[10] & 0x0f;
+  } else if (E.Type == 0x07 && Length > 243) {
+    // The packet headers only have the lower 24 bits of the Unix time, the GCU housekeeping has the upper 8
+    m_UnixTimeMSB = Packet[243];
+    if (m_HasUnixTimeMSB == false) {
+      for (auto& Earlier: m_Entries) {
+        Earlier.UnixTime |= (uint32_t) m_UnixTimeMSB << 24;
+      }
+      m_HasUnixTimeMSB = true;
+    }
+  }
+
+  if (m_HasUnixTimeMSB == true) {
+    E.UnixTime |= (uint32_t) m_UnixTimeMSB << 24;
+  }
+
+  m_Entries.push_back(E);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFlightDataIndex::Write(const MString& FileName) const
+{
+  //! Write the index to a file
+
+  ofstream out;
+  out.open(FileName.Data(), ios::binary);
+  if (out.is_open() == false) return false;
+
+  // All numbers are little-endian
+  vector<uint8_t> Bytes;
+  Bytes.reserve(24 + c_EntrySize*m_Entries.size());
+
+  auto Put = [&Bytes](uint64_t Value, unsigned int NBytes) {
+    for (unsigned int b = 0; b < NBytes; ++b) {
+      Bytes.push_back((Value >> (8*b)) & 0xff);
+    }
+  };
+
+  Bytes.insert(Bytes.end(), g_IndexFileMagic, g_IndexFileMagic + sizeof(g_IndexFileMagic));
+  Put(m_DataFileSize, 8);
+  Put(m_Entries.size(), 8);
+  for (const entry& E: m_Entries) {
+    Put(E.Offset, 8);
+    Put(E.Length, 2);
+    Put(E.Type, 1);
+    Put(E.CCId, 1);
+    Put(E.UnixTime, 4);
+    Put(E.Clock, 6);
+  }
+
+  out.write(reinterpret_cast<const char*>(Bytes.data()), Bytes.size());
+  out.close();
+
+  return out.fail() == false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFlightDataIndex::Read(const MString& FileName, uint64_t DataFileSize)
+{
+  //! Read the index from a file - fails if the index was not built from a data file of the given size
+
+  m_Entries.clear();
+
+  ifstream in;
+  in.open(FileName.Data(), ios::binary);
+  if (in.is_open() == false) return false;
+
+  vector<uint8_t> Bytes((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+  in.close();
+
+  size_t Position = 0;
+  auto Get = [&Bytes, &Position](unsigned int NBytes) {
+    uint64_t Value = 0;
+    for (unsigned int b = 0; b < NBytes; ++b) {
+      Value |= (uint64_t) Bytes[Position++] << (8*b);
+    }
+    return Value;
+  };
+
+  if (Bytes.size() < 24 || memcmp(Bytes.data(), g_IndexFileMagic, sizeof(g_IndexFileMagic)) != 0) {
+    if (g_Verbosity >= c_Warning) cout<<"Binary flight data index: Warning: \""<<FileName<<"\" is not an index file"<<endl;
+    return false;
+  }
+  Position = sizeof(g_IndexFileMagic);
+
+  uint64_t IndexedSize = Get(8);
+  uint64_t NEntries = Get(8);
+  if (IndexedSize != DataFileSize) {
+    if (g_Verbosity >= c_Info) cout<<"Binary flight data index: The index \""<<FileName<<"\" is outdated"<<endl;
+    return false;
+  }
+  if (Bytes.size() != 24 + c_EntrySize*NEntries) {
+    if (g_Verbosity >= c_Warning) cout<<"Binary flight data index: Warning: The index \""<<FileName<<"\" is truncated"<<endl;
+    return false;
+  }
+
+  m_DataFileSize = IndexedSize;
+  m_HasUnixTimeMSB = false;
+  m_Entries.resize(NEntries);
+  for (entry& E: m_Entries) {
+    E.Offset = Get(8);
+    E.Length = Get(2);
+    E.Type = Get(1);
+    E.CCId = Get(1);
+    E.UnixTime = Get(4);
+    E.Clock = Get(6);
+    if (E.UnixTime > 0xffffff) m_HasUnixTimeMSB = true;
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFlightDataIndex::FindRegion(uint32_t Start, uint32_t Stop, uint64_t& Begin, uint64_t& End) const
+{
+  //! Find the byte region [Begin, End) of the uncompressed data stream which contains all packets
+  //! with Unix times within [Start, Stop] - return false if there are no such packets
+
+  if (Stop < Start) return false;
+
+  // Without the upper byte of the Unix time we can only compare the lower 24 bits: this is
+  // unambiguous if both bounds are set and less than 2^23 s apart, and the wrapped difference
+  // handles a range across a 24-bit boundary - otherwise all packets are in the region
+  bool IsWrapped = false;
+  if (m_HasUnixTimeMSB == false) {
+    if (Start == 0 || Stop - Start >= 0x800000) {
+      Start = 0;
+      Stop = numeric_limits<uint32_t>::max();
+    } else {
+      IsWrapped = true;
+    }
+  }
+
+  bool Found = false;
+  for (const entry& E: m_Entries) {
+    bool IsInRange = false;
+    if (IsWrapped == true) {
+      IsInRange = ((E.UnixTime - Start) & 0xffffff) <= Stop - Start;
+    } else {
+      IsInRange = (E.UnixTime >= Start && E.UnixTime <= Stop);
+    }
+    if (IsInRange == true) {
+      if (Found == false) {
+        Begin = E.Offset;
+        Found = true;
+      }
+      End = E.Offset + E.Length;
+    }
+  }
+
+  return Found;
+}
+
+
+// MBinaryFlightDataIndex.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
@@ -31,6 +31,7 @@
 // Standard libs:
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <time.h>
 using namespace std;
 
@@ -42,10 +43,9 @@ using namespace std;
 #include "MFile.h"
 #include "MModuleEventSaver.h"
 #include "MQuaternion.h"
+#include "MObjectPool.h"
 
 //Pipeline Tools:
-#include "GCUSettingsParser.h"
-#include "GCUHousekeepingParser.h"
 #include "LivetimeParser.h"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -56,13 +56,14 @@ ClassImp(MBinaryFlightDataParser)
 #endif
 
 
+////////////////////////////////////////////////////////////////////////////////
 
 
+const size_t MBinaryFlightDataParser::c_SBufCapacity;
+const uint16_t MBinaryFlightDataParser::c_MaxPacketLength;
 
-////////////////////////////////////////////////////////////////////////////////
 
 
-bool MReadOutAssemblyTimeCompare(MReadOutAssembly* E1, MReadOutAssembly* E2);
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -75,17 +76,13 @@ MBinaryFlightDataParser::MBinaryFlightDataParser() : TIRecord(1000)
 	m_DataSelectionMode = MBinaryFlightDataParserDataModes::c_All;
 	m_UseComptonDataframes = false;
 	m_UseRawDataframes = true;
-	m_NumRawDataframes = 0;
-	m_NumComptonDataframes = 0;
-	m_NumAspectPackets = 0;
-	m_NumSettingsPackets = 0;
-	m_NumGCUHkpPackets = 0;
-	m_NumLivetimePackets = 0;
-	m_NumOtherPackets = 0;
-	MAX_TRIGS = 80;
+	m_GCUUnixTimeMSB = 0;
+	m_HasGCUUnixTimeMSB = false;
+	m_PreampTemps.assign(24, 0);
 	LastTimestamps.clear();
 	LastTimestamps.resize(12, 0);
-	dx = 0;
+	m_SBufBegin = 0;
+	m_SBufEnd = 0;
 	m_EventTimeWindow = 60 * 10000000;
 	m_ComptonWindow = 2;
 	LoadStripMap();
@@ -95,15 +92,19 @@ MBinaryFlightDataParser::MBinaryFlightDataParser() : TIRecord(1000)
 	m_UseGPSDSO = true; //simply sets whether or not we add these frames to the Aspect deque
 	m_UseMagnetometer = true; //^^^^
 	m_NumDSOReceived = 0;
-	m_NumComptonBytes = 0;
-	m_NumBytesReceived = 0;
-	m_LostBytes = 0;
+	m_NDecodeThreads = 0;
+	m_NextDecodeJob = 0;
+	m_StopDecoding = false;
+	m_Dataframe = new dataframe();
 	m_IgnoreAspect = false;
 	m_LastDSOUnixTime = 0xffffffff;
 	m_LastAspectID = 0xffff;
 	m_AspectReconstructor = nullptr;
 	m_CoincidenceEnabled = true;
 	m_HousekeepingFileName = "Housekeeping.hkp";
+	m_BinaryHousekeeping = false;
+	m_MetricsFileName = "";
+	m_MetricsInterval = 10;
 }
 
 
@@ -114,8 +115,16 @@ MBinaryFlightDataParser::~MBinaryFlightDataParser()
 {
 	// Delete this instance of MBinaryFlightDataParser
 
+	StopDecodeThreads();
+	for (auto Job: m_FreeDecodeJobs) {
+		delete Job->Dataframe;
+		delete Job;
+	}
+	m_FreeDecodeJobs.clear();
+	delete m_Dataframe;
+
 	for (auto E: m_Events) {
-		delete E;
+		MObjectPool<MReadOutAssembly>::Release(E);
 	}
 	m_Events.clear();
 }
@@ -128,40 +137,37 @@ bool MBinaryFlightDataParser::Initialize()
 {
 	// Initialize the module 
 
-  m_NumRawDataframes = 0;
-  m_NumComptonDataframes = 0;
-  m_NumAspectPackets = 0;
-  m_NumSettingsPackets = 0;
-  m_NumGCUHkpPackets = 0;
-  m_NumLivetimePackets = 0;
-  m_NumOtherPackets = 0;
+  m_Statistics.Clear();
 
 
   //LastTimestamps.clear();
   //LastTimestamps.resize(12);
-  dx = 0;
 
   m_EventIDCounter = 0;
   m_LastCorrectedClk = 0xffffffffffffffff;
   
   m_NumDSOReceived = 0;
-  m_NumComptonBytes = 0;
-  m_NumBytesReceived = 0;
-  m_LostBytes = 0;
+  m_PacketRecord.Clear();
   
   m_LastDSOUnixTime = 0xffffffff;
   m_LastAspectID = 0xffff;
 
   for (auto E: m_Events) {
-    delete E;
+    MObjectPool<MReadOutAssembly>::Release(E);
   }
   m_Events.clear();
-  for (auto E: m_EventsBuf) {
-    delete E;
-  }
-  m_EventsBuf.clear();
+  m_EventsBuf.Clear();
   
-  m_SBuf.clear();
+  m_SBuf.resize(c_SBufCapacity);
+  m_SBufBegin = 0;
+  m_SBufEnd = 0;
+  m_Stitch.reserve(c_MaxPacketLength);
+
+  if (m_NDecodeThreads > 0) {
+    StartDecodeThreads();
+  } else {
+    StopDecodeThreads();
+  }
   
   m_LastDateTimeString = "";
   m_LastCorrectedClk = 0;
@@ -171,11 +177,10 @@ bool MBinaryFlightDataParser::Initialize()
   m_LastGPSWeek = 0;
   m_LastAspectID = 0;
   LastComptonTimestamp = 0;
-  m_NumComptonBytes = 0;
-  m_NumRawDataBytes = 0;
-  m_NumBytesReceived = 0;
  
-  m_PreampTemps.reserve(24);
+  m_PreampTemps.assign(24, 0);
+  m_GCUUnixTimeMSB = 0;
+  m_HasGCUUnixTimeMSB = false;
  
   // Load aspect reconstruction module
   delete m_AspectReconstructor;
@@ -221,11 +226,35 @@ bool MBinaryFlightDataParser::Initialize()
     m_Housekeeping.close();
     m_Housekeeping.clear();    
   }
-  m_Housekeeping.open(m_HousekeepingFileName);
-  if (m_Housekeeping.is_open() == false) {
-    cout<<"Error: Unable to open housekeeping file for writing: "<<m_HousekeepingFileName<<endl;
-    return false;
+  m_HousekeepingWriter.Close();
+  if (m_BinaryHousekeeping == true) {
+    if (m_HousekeepingWriter.Open(m_HousekeepingFileName) == false) {
+      cout<<"Error: Unable to open binary housekeeping file for writing: "<<m_HousekeepingFileName<<endl;
+      return false;
+    }
+  } else {
+    m_Housekeeping.open(m_HousekeepingFileName);
+    if (m_Housekeeping.is_open() == false) {
+      cout<<"Error: Unable to open housekeeping file for writing: "<<m_HousekeepingFileName<<endl;
+      return false;
+    }
+  }
+  
+  // Handle the metrics file
+  
+  if (m_Metrics.is_open() == true) {
+    m_Metrics.close();
+    m_Metrics.clear();
+  }
+  if (m_MetricsFileName != "") {
+    m_Metrics.open(m_MetricsFileName);
+    if (m_Metrics.is_open() == false) {
+      cout<<"Error: Unable to open metrics file for writing: "<<m_MetricsFileName<<endl;
+      return false;
+    }
   }
+  m_MetricsStart = chrono::steady_clock::now();
+  m_LastMetrics = m_MetricsStart;
   
   return true;
 }
@@ -243,35 +272,47 @@ bool MReadOutAssemblyReverseSort(MReadOutAssembly* E1, MReadOutAssembly* E2) {
 ////////////////////////////////////////////////////////////////////////////////
 
 
-bool MBinaryFlightDataParser::ParseData(vector<uint8_t> Received) 
+bool MBinaryFlightDataParser::ParseData(const vector<uint8_t>& Received) 
+{
+	return ParseData(Received.data(), Received.size());
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFlightDataParser::ParseData(const uint8_t* Data, size_t Size) 
 {
 	uint8_t Type;
 	vector <MReadOutAssembly*> NewEvents;
 	vector<unsigned char> SyncWord;
 	dataframe * Dataframe;
 	int ParseErr;
-	//unsigned int CCId = 0;
+	unsigned int Stream = 0; //the event stream of the card cage which produced the events
 
-	struct GCUSettingsPacket* SettingsPacket;
- 	struct GCUHousekeepingPacket* GCUHkpPacket;
 	struct LivetimePacket CCLivetimePacket;
-	uint8_t GCUUnixTimeMSB;
-	double ShieldNumCounts;
-	double ShieldTimeInterval;
 	double ShieldCountRate;
 	MAspect* LatestAspect;
 
+	//the search buffer has a fixed capacity, thus larger inputs are handed over piece by piece
+	//after parsing, at most one incomplete packet is left in the search buffer
+	while (Size > c_SBufCapacity - GetSBufSize()) {
+		size_t Piece = c_SBufCapacity - GetSBufSize();
+		ParseData(Data, Piece);
+		Data += Piece;
+		Size -= Piece;
+	}
+
 	SyncWord.push_back(0xEB);
 	SyncWord.push_back(0x90);
-	m_NumBytesReceived += Received.size();
-	if (g_Verbosity >= c_Info) cout<<"BinaryFlightDataParser: NumBytesReceived "<<m_NumBytesReceived<<endl;
+	m_Statistics.AddBytesReceived(Size);
+	if (g_Verbosity >= c_Info) cout<<"BinaryFlightDataParser: NumBytesReceived "<<m_Statistics.GetNBytesReceived()<<endl;
 
-	//apend the received data to m_SBuf
-	//might want to reserve space here
-	m_SBuf.insert( m_SBuf.end(), Received.begin(), Received.end() );
+	//append the received data to the search buffer
+	AppendToSBuf( Data, Size );
 	//FindNextPacket handles all the resyncing etc...
 
-	vector<uint8_t> NextPacket;
+	packet NextPacket;
 	while (FindNextPacket( NextPacket )) {
 		Type = NextPacket[2] & 0x0f;
 		
@@ -282,54 +323,53 @@ bool MBinaryFlightDataParser::ParseData(vector<uint8_t> Received)
 									((uint64_t)NextPacket[7] << 8) | 
 									Type;
 
-		if(m_PacketRecord.count(PacketKey) == 1){
+		//the redundant downlinks (openport A/B) deliver most packets twice, only use the first one
+		//the filter remembers the last 10000 packets in arrival order
+		if(m_PacketRecord.IsDuplicate(PacketKey) == true){
 			//cout << "duplicate compton packet, ID:" << Dataframe->PacketCounter << " UNIXT:" << Dataframe->UnixTime << endl;
 			continue;
-		} else {
-			m_PacketRecord[PacketKey] = (NextPacket[2] & 0x80) >> 7; //mapped value of zero -> normal data, or openport A. mapped value of one -> openport B
-		}
-
-		//trim the packet record
-		while(m_PacketRecord.size() > 10000){
-			m_PacketRecord.erase(m_PacketRecord.begin());
 		}
 
 		if (g_Verbosity >= c_Info) {
-			//printf("FNP: %u - %lu, dx = %d, bufsize = %lu\n",Type, NextPacket.size(), dx, m_SBuf.size());
-			cout<<"FNP: "<<hex<<Type<<" - "<<NextPacket.size()<<", dx = "<<dx<<", bufsize = "<<m_SBuf.size()<<endl;
+			cout<<"FNP: "<<hex<<Type<<" - "<<NextPacket.size()<<dec<<", leftover bytes in search buffer = "<<GetSBufSize()<<endl;
 		}
 
+		//for dataframes handed to the decoding threads this is the submission, their decoding time is added when they are collected
+		chrono::steady_clock::time_point ParseStart = chrono::steady_clock::now();
+
 
 		switch( Type ){
 			case 0x00:
 				//raw dataframe
-				if( m_DataSelectionMode == MBinaryFlightDataParserDataModes::c_Raw ){
-					Dataframe = new dataframe();
+				if( m_DataSelectionMode == MBinaryFlightDataParserDataModes::c_Raw && m_NDecodeThreads > 0 ){
+					SubmitDataframe( NextPacket, Type );
+				} else if( m_DataSelectionMode == MBinaryFlightDataParserDataModes::c_Raw ){
+					Dataframe = m_Dataframe;
 					ParseErr = RawDataframe2Struct( NextPacket, Dataframe );
 					if( ParseErr >= 0 ){
 						ConvertToMReadOutAssemblys( Dataframe, &NewEvents );
-						//CCId = Dataframe->CCId;
+						Stream = Dataframe->CCId;
 					} else {
 						if (g_Verbosity >= c_Error) cout<<"BinaryFlightDataParser: ParseERR"<<endl;
+						m_Statistics.AddParseError(Type);
 					}
 					//cout<<"made "<<NewEvents.size()<<" MReadOutAssemblys"<<endl;
-					delete Dataframe;
-					m_NumRawDataBytes += NextPacket.size();
-					//cout<<"NumRawDataBytes "<<m_NumRawDataBytes<<endl;
-					m_NumRawDataframes++;
-
 				}
 				break;
 			case 0x01:
 				//compton dataframe
-				if( m_DataSelectionMode == MBinaryFlightDataParserDataModes::c_Compton ){
-					Dataframe = new dataframe();
+				if( m_DataSelectionMode == MBinaryFlightDataParserDataModes::c_Compton && m_NDecodeThreads > 0 ){
+					SubmitDataframe( NextPacket, Type );
+				} else if( m_DataSelectionMode == MBinaryFlightDataParserDataModes::c_Compton ){
+					Dataframe = m_Dataframe;
 					if( ComptonDataframe2Struct( NextPacket, Dataframe ) ){
 						ConvertToMReadOutAssemblys( Dataframe, &NewEvents );
+						Stream = c_ComptonStream;
 					} else {
 						if (g_Verbosity >= c_Error) cout<<"BinaryFlightDataParser: Parsing error"<<endl;
+						m_Statistics.AddParseError(Type);
 					}
-					size_t NEvents = Dataframe->Events.size();
+					size_t NEvents = Dataframe->NumEvents;
 					
 					/*
 					printf("!@# ID:%u UNIXT:%u (%u,%f) <---> (%u,%f)\n",Dataframe->PacketCounter,
@@ -339,11 +379,6 @@ bool MBinaryFlightDataParser::ParseData(vector<uint8_t> Received)
 																						 Dataframe->Events[NEvents-1].EventID,
 																						 ((double)NewEvents[NEvents-1]->GetCL())*1E-7);
 																						 */
-
-					delete Dataframe;
-					m_NumComptonDataframes++;
-					m_NumComptonBytes += NextPacket.size();
-
 				}
 				break;
 			case 0x05:
@@ -354,183 +389,97 @@ bool MBinaryFlightDataParser::ParseData(vector<uint8_t> Received)
 					ProcessAspect( NextPacket );
 
 					//Print info into housekeeping file 
-        	                      if (m_Housekeeping.is_open() == true) {
+        	                      if (HasHousekeepingFile() == true) {
 						if (m_AspectReconstructor->GetLastAspectInDeque() != 0) { 
 							LatestAspect = m_AspectReconstructor->GetLastAspectInDeque();
 							if (((m_AspectMode == MBinaryFlightDataParserAspectModes::c_GPS || m_AspectMode == MBinaryFlightDataParserAspectModes::c_Interpolate) && (LatestAspect->GetGPS_or_magnetometer() == 0)) || ((m_AspectMode == MBinaryFlightDataParserAspectModes::c_Magnetometer) && (LatestAspect->GetGPS_or_magnetometer() == 1))) {
-								m_Housekeeping<<"ASP\nTI "<<LatestAspect->GetUTCTime()<<"\nMD "<<LatestAspect->GetGPS_or_magnetometer()<<"\nGX "<<LatestAspect->GetGalacticPointingXAxisLongitude()<<" "<<LatestAspect->GetGalacticPointingXAxisLatitude()<<"\nGZ "<<LatestAspect->GetGalacticPointingZAxisLongitude()<<" "<<LatestAspect->GetGalacticPointingZAxisLatitude()<<"\nCO "<<LatestAspect->GetLatitude()<<" "<<LatestAspect->GetLongitude()<<" "<<LatestAspect->GetAltitude()<<"\nGPS "<<LatestAspect->GetHeading()<<" "<<LatestAspect->GetPitch()<<" "<<LatestAspect->GetRoll()<<"\n\n";
+								MTime UTCTime = LatestAspect->GetUTCTime();
+								MHousekeepingBinary::aspect Record;
+								Record.Seconds = UTCTime.GetAsSystemSeconds();
+								Record.NanoSeconds = UTCTime.GetNanoSeconds();
+								Record.Mode = LatestAspect->GetGPS_or_magnetometer();
+								Record.GXLongitude = LatestAspect->GetGalacticPointingXAxisLongitude();
+								Record.GXLatitude = LatestAspect->GetGalacticPointingXAxisLatitude();
+								Record.GZLongitude = LatestAspect->GetGalacticPointingZAxisLongitude();
+								Record.GZLatitude = LatestAspect->GetGalacticPointingZAxisLatitude();
+								Record.Latitude = LatestAspect->GetLatitude();
+								Record.Longitude = LatestAspect->GetLongitude();
+								Record.Altitude = LatestAspect->GetAltitude();
+								Record.Heading = LatestAspect->GetHeading();
+								Record.Pitch = LatestAspect->GetPitch();
+								Record.Roll = LatestAspect->GetRoll();
+								WriteHousekeeping(Record);
 							}
 						}
 					}
 					//cout<<"GZ: "<<LatestAspect->GetGalacticPointingZAxisLongitude()<<" "<<LatestAspect->GetGalacticPointingZAxisLatitude()<<endl;
 				
 				}
-				m_NumAspectPackets++;
 				break;
 			case 0x06:
 				//livetime packet
 				if (g_Verbosity >= c_Info) cout<<"got livetime packet!"<<endl;
 				//wait to get a gcu_hkp packet to use the unix time most sig bit
-				if (m_NumGCUHkpPackets > 0) {
-					ParseLivetime(&CCLivetimePacket,&NextPacket[0]);
+				if (m_HasGCUUnixTimeMSB == true) {
+					ParseLivetime(&CCLivetimePacket,NextPacket.data());
 					//Print CC livetime info into housekeeping file
-					if (m_Housekeeping.is_open() == true) {
-						m_Housekeeping<<"LT\nTI "<<((GCUUnixTimeMSB << 24) | CCLivetimePacket.UnixTime)<<"\nID "<<CCLivetimePacket.PacketCounter<<"\nDU 1";;
+					if (HasHousekeepingFile() == true) {
+						MHousekeepingBinary::livetime Record;
+						Record.UnixTime = (m_GCUUnixTimeMSB << 24) | CCLivetimePacket.UnixTime;
+						Record.PacketCounter = CCLivetimePacket.PacketCounter;
 						for (int i = 0; i < 12; ++i) {
-							if (CCLivetimePacket.CCHasLivetime[i] == 1) {
-								m_Housekeeping<<"\nCC"<<i<<" "<<(CCLivetimePacket.TotalLivetime[i])/3051.;
-							} else {
-								m_Housekeeping<<"\nCC"<<i<<" -1";
-							}
+							Record.HasLivetime[i] = CCLivetimePacket.CCHasLivetime[i];
+							Record.Livetime[i] = CCLivetimePacket.TotalLivetime[i];
 						}
-						m_Housekeeping<<"\n\n";
+						WriteHousekeeping(Record);
 					}
 				}
-				m_NumLivetimePackets++;
 				break;
 			case 0x07:
 				//gcu hkp packet
 
 				if (g_Verbosity >= c_Info) cout<<"got GCU housekeeping packet!"<<endl;
-				GCUHkpPacket = ParseGCUHousekeepingPacket(&NextPacket[0]);
-				GCUUnixTimeMSB = GCUHkpPacket->UnixTimeMSB;
-
-				//Calculate shield rate
-				ShieldNumCounts = static_cast <double> (GCUHkpPacket->NumCounts[0]);
-				ShieldTimeInterval = (static_cast <double> (GCUHkpPacket->TimeInterval[0]))*1e-7;
-				ShieldCountRate = ShieldNumCounts/ShieldTimeInterval;
+				if (DecodeGCUHousekeeping(NextPacket, m_GCUUnixTimeMSB, ShieldCountRate) == false) {
+					if (g_Verbosity >= c_Warning) cout<<"BinaryFlightDataParser: GCU housekeeping packet too short: "<<NextPacket.size()<<" bytes"<<endl;
+					m_Statistics.AddParseError(Type);
+					break;
+				}
+				m_HasGCUUnixTimeMSB = true;
 
 				//Print info into housekeeping file
-				if (m_Housekeeping.is_open() == true) {
-					m_Housekeeping<<"HKP\nTI "<<((GCUUnixTimeMSB << 24) | GCUHkpPacket->UnixTime)<<"\nID "<<GCUHkpPacket->PacketCounter<<"\nDU 5"<<"\nSR "<<ShieldCountRate<<"\n\n";
+				if (HasHousekeepingFile() == true) {
+					MHousekeepingBinary::gcuhousekeeping Record;
+					Record.UnixTime = (m_GCUUnixTimeMSB << 24) | (((uint32_t) NextPacket[3] << 16) | ((uint32_t) NextPacket[4] << 8) | NextPacket[5]);
+					Record.PacketCounter = ((uint16_t) NextPacket[6] << 8) | NextPacket[7];
+					Record.ShieldCountRate = ShieldCountRate;
+					WriteHousekeeping(Record);
 				}
-				m_NumGCUHkpPackets++;
 				break;
 			case 0x0b:
 				//preamp temperatures
 				if (g_Verbosity >= c_Info) cout<<"got settings packet!"<<endl;
-				SettingsPacket = ParseGCUSettingsPacket(&NextPacket[0]);
-				//Order of PreampTemps are defined as Det0 DC, Det0 AC, Det1 DC, Det1, AC...etc
-				m_PreampTemps[0] = SettingsPacket->RpiTemp_Brd2_Ch0;
-				m_PreampTemps[1] = SettingsPacket->RpiTemp_Brd2_Ch3;
-				m_PreampTemps[2] = SettingsPacket->RpiTemp_Brd0_Ch6;
-				m_PreampTemps[3] = SettingsPacket->RpiTemp_Brd2_Ch2;
-				m_PreampTemps[4] = SettingsPacket->RpiTemp_Brd0_Ch7;
-				m_PreampTemps[5] = SettingsPacket->RpiTemp_Brd2_Ch1;
-				m_PreampTemps[6] = SettingsPacket->RpiTemp_Brd1_Ch6;
-				m_PreampTemps[7] = SettingsPacket->RpiTemp_Brd2_Ch4;
-				m_PreampTemps[8] = SettingsPacket->RpiTemp_Brd1_Ch7;
-				m_PreampTemps[9] = SettingsPacket->RpiTemp_Brd2_Ch5;
-				m_PreampTemps[10] = SettingsPacket->RpiTemp_Brd2_Ch7;
-				m_PreampTemps[11] = SettingsPacket->RpiTemp_Brd2_Ch6;
-				m_PreampTemps[12] = SettingsPacket->RpiTemp_Brd1_Ch5;
-				m_PreampTemps[13] = SettingsPacket->RpiTemp_Brd1_Ch2;
-				m_PreampTemps[14] = SettingsPacket->RpiTemp_Brd1_Ch4;
-				m_PreampTemps[15] = SettingsPacket->RpiTemp_Brd1_Ch1;
-				m_PreampTemps[16] = SettingsPacket->RpiTemp_Brd1_Ch3;
-				m_PreampTemps[17] = SettingsPacket->RpiTemp_Brd1_Ch0;
-				m_PreampTemps[18] = SettingsPacket->RpiTemp_Brd0_Ch3;
-				m_PreampTemps[19] = SettingsPacket->RpiTemp_Brd0_Ch0;
-				m_PreampTemps[20] = SettingsPacket->RpiTemp_Brd0_Ch4;
-				m_PreampTemps[21] = SettingsPacket->RpiTemp_Brd0_Ch1;
-				m_PreampTemps[22] = SettingsPacket->RpiTemp_Brd0_Ch5;
-				m_PreampTemps[23] = SettingsPacket->RpiTemp_Brd0_Ch2;
-				m_NumSettingsPackets++;
+				if (DecodePreampTemperatures(NextPacket) == false) {
+					if (g_Verbosity >= c_Warning) cout<<"BinaryFlightDataParser: GCU settings packet too short: "<<NextPacket.size()<<" bytes"<<endl;
+					m_Statistics.AddParseError(Type);
+					break;
+				}
 				break;
 			default:
 				//don't care
-				m_NumOtherPackets++;
+				break;
 		}
-		if( NewEvents.size() > 0 ){
-			for( auto E: NewEvents ){
-				/*
-				int CCId = E->GetStripHit(0)>GetDetectorID(); //this line might be an issue since events from compton packets can have SHs from more than one detector
-				uint64_t Lower;
-				if(m_EventTimeWindow > LastTimestamps[CCId]){
-					Lower = LastTimestamps[CCId] >> 1;
-				} else {
-					Lower = LastTimestamps[CCId] - m_EventTimeWindow;
-				}
-				bool DeleteEvent = false;
-				if(E->GetCL() < Lower){ //timestamp went back in time too far
-					cout << CCId << " past: current CL = " << E->GetCL() <<", LastCL = " << LastTimestamps[CCId];
-					if(m_EventsBuf.size() > 0) cout << ", frontCL = " << m_EventsBuf.front()->GetCL() << ", backCL = " << m_EventsBuf.back()->GetCL() << endl; else cout << endl;
-					while(m_EventsBuf.size() > 0){
-						MReadOutAssembly* E = m_EventsBuf[0]; m_EventsBuf.pop_front();
-						delete E;
-					}
-					deque<MReadOutAssembly*>::iterator I = lower_bound(m_EventsBuf.begin(), m_EventsBuf.end(), E, MReadOutAssemblyReverseSort);
-					m_EventsBuf.insert(I, E);
-				} else if(E->GetCL() > (LastTimestamps[CCId] + (m_EventTimeWindow << 1))){ //timestamp is too far in the future
-					cout << CCId << " future: current CL = " << E->GetCL() <<", LastCL = " << LastTimestamps[CCId];
-					if(m_EventsBuf.size() > 0) cout << ", frontCL = " << m_EventsBuf.front()->GetCL() << ", backCL = " << m_EventsBuf.back()->GetCL() << endl; else cout << endl;
-					DeleteEvent = true;
-				} else {//timestamp is OK, insert the event into m_EventsBuf
-					deque<MReadOutAssembly*>::iterator I = lower_bound(m_EventsBuf.begin(), m_EventsBuf.end(), E, MReadOutAssemblyReverseSort);
-					m_EventsBuf.insert(I, E);
-				}
-				LastTimestamps[CCId] = E->GetCL();
-				if(DeleteEvent){
-					delete E;
-				}*/
-
-				/*
-				if(m_EventsBuf.size() > 0){
-					if(m_EventsBuf.front()->GetCL() >= m_EventTimeWindow){
-						if(E->GetCL() < (m_EventsBuf.front()->GetCL() - m_EventTimeWindow)){ //event time jumped back too far
-							cout << "event time back-skip: this CL = " << E->GetCL() << ", front CL = " << m_EventsBuf.front()->GetCL() << ", back CL = " << m_EventsBuf.back()->GetCL() << endl;
-							while(m_EventsBuf.size() > 0){
-								MReadOutAssembly* Ev = m_EventsBuf.front(); m_EventsBuf.pop_front();
-								delete Ev;
-							}
-							deque<MReadOutAssembly*>::iterator I = lower_bound(m_EventsBuf.begin(), m_EventsBuf.end(), E, MReadOutAssemblyReverseSort);
-							m_EventsBuf.insert(I, E);
-						} else if(E->GetCL() > (m_EventsBuf.back()->GetCL() + (4*m_EventTimeWindow))){ //event time jumped forward too far
-							cout << "event time forward-skip: this CL = " << E->GetCL() << ", front CL = " << m_EventsBuf.front()->GetCL() << ", back CL = " << m_EventsBuf.back()->GetCL() << endl;
-							delete E;
-						} else {
-							deque<MReadOutAssembly*>::iterator I = lower_bound(m_EventsBuf.begin(), m_EventsBuf.end(), E, MReadOutAssemblyReverseSort);
-							m_EventsBuf.insert(I, E);
-						}
-					} else {
-							deque<MReadOutAssembly*>::iterator I = lower_bound(m_EventsBuf.begin(), m_EventsBuf.end(), E, MReadOutAssemblyReverseSort);
-							m_EventsBuf.insert(I, E);
-					}
-				} else {
-					m_EventsBuf.push_back(E);
-				}
-				*/
-				if(m_EventsBuf.size() > 0){
-					if(E->GetCL() < (m_EventsBuf.front()->GetCL() >> 1)){ //event time jumped back too far
-						cout << "event time back-skip: this CL = " << E->GetCL() << ", front CL = " << m_EventsBuf.front()->GetCL() << ", back CL = " << m_EventsBuf.back()->GetCL() << endl;
-						while(m_EventsBuf.size() > 0){
-							MReadOutAssembly* Ev = m_EventsBuf.front(); m_EventsBuf.pop_front();
-							delete Ev;
-						}
-						m_EventsBuf.push_back(E);
-					} else {
-						deque<MReadOutAssembly*>::iterator I = lower_bound(m_EventsBuf.begin(), m_EventsBuf.end(), E, MReadOutAssemblyReverseSort);
-						m_EventsBuf.insert(I, E);
-					}
-				} else {
-					m_EventsBuf.push_back(E);
-				}
+		m_Statistics.AddPacket(Type, NextPacket.size(), chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - ParseStart).count());
+		AddToEventsBuf( NewEvents, Stream );
+	}
 
-			}
-			NewEvents.clear();
-			if( m_UseRawDataframes ){
-				if (g_Verbosity >= c_Info) cout<<"BinaryFlightDataParser: T ::: ";;
-				for( auto E: LastTimestamps ){
-					if (g_Verbosity >= c_Info) cout<<std::hex<<E<<" ";
-				}
-				if (g_Verbosity >= c_Info) cout<<std::dec<<endl;
-			} else if( m_UseComptonDataframes ){
-				if (g_Verbosity >= c_Info) cout<<"BinaryFlightDataParser: T_compton ::: "<<LastComptonTimestamp<<endl;
-			}
-		}
+	//the decoded dataframes are added in packet order, thus the result is the same as decoding them here
+	if( m_NDecodeThreads > 0 ){
+		CollectDecodedDataframes();
 	}
 
 	CheckEventsBuf();
+	m_Statistics.AddMergeWindowOccupancy(m_EventsBuf.GetNEvents());
+	WriteMetrics(false);
 
 	if( m_AspectMode != MBinaryFlightDataParserAspectModes::c_Neither){
 		for( auto E: m_Events ){
@@ -588,85 +537,361 @@ bool MBinaryFlightDataParser::ParseData(vector<uint8_t> Received)
 ////////////////////////////////////////////////////////////////////////////////
 
 
-bool MBinaryFlightDataParser::FindNextPacket(vector<uint8_t>& NextPacket , unsigned int * idx){
+void MBinaryFlightDataParser::AddToEventsBuf(vector<MReadOutAssembly*>& NewEvents, unsigned int Stream)
+{
+	//Add the events of one dataframe to the given stream of the time-sorted event buffer
+
+	if( NewEvents.size() > 0 ){
+		for( auto E: NewEvents ){
+			/*
+			int CCId = E->GetStripHit(0)>GetDetectorID(); //this line might be an issue since events from compton packets can have SHs from more than one detector
+			uint64_t Lower;
+			if(m_EventTimeWindow > LastTimestamps[CCId]){
+				Lower = LastTimestamps[CCId] >> 1;
+			} else {
+				Lower = LastTimestamps[CCId] - m_EventTimeWindow;
+			}
+			bool DeleteEvent = false;
+			if(E->GetCL() < Lower){ //timestamp went back in time too far
+				cout << CCId << " past: current CL = " << E->GetCL() <<", LastCL = " << LastTimestamps[CCId];
+				if(m_EventsBuf.size() > 0) cout << ", frontCL = " << m_EventsBuf.front()->GetCL() << ", backCL = " << m_EventsBuf.back()->GetCL() << endl; else cout << endl;
+				while(m_EventsBuf.size() > 0){
+					MReadOutAssembly* E = m_EventsBuf[0]; m_EventsBuf.pop_front();
+					delete E;
+				}
+				deque<MReadOutAssembly*>::iterator I = lower_bound(m_EventsBuf.begin(), m_EventsBuf.end(), E, MReadOutAssemblyReverseSort);
+				m_EventsBuf.insert(I, E);
+			} else if(E->GetCL() > (LastTimestamps[CCId] + (m_EventTimeWindow << 1))){ //timestamp is too far in the future
+				cout << CCId << " future: current CL = " << E->GetCL() <<", LastCL = " << LastTimestamps[CCId];
+				if(m_EventsBuf.size() > 0) cout << ", frontCL = " << m_EventsBuf.front()->GetCL() << ", backCL = " << m_EventsBuf.back()->GetCL() << endl; else cout << endl;
+				DeleteEvent = true;
+			} else {//timestamp is OK, insert the event into m_EventsBuf
+				deque<MReadOutAssembly*>::iterator I = lower_bound(m_EventsBuf.begin(), m_EventsBuf.end(), E, MReadOutAssemblyReverseSort);
+				m_EventsBuf.insert(I, E);
+			}
+			LastTimestamps[CCId] = E->GetCL();
+			if(DeleteEvent){
+				delete E;
+			}*/
+
+			/*
+			if(m_EventsBuf.size() > 0){
+				if(m_EventsBuf.front()->GetCL() >= m_EventTimeWindow){
+					if(E->GetCL() < (m_EventsBuf.front()->GetCL() - m_EventTimeWindow)){ //event time jumped back too far
+						cout << "event time back-skip: this CL = " << E->GetCL() << ", front CL = " << m_EventsBuf.front()->GetCL() << ", back CL = " << m_EventsBuf.back()->GetCL() << endl;
+						while(m_EventsBuf.size() > 0){
+							MReadOutAssembly* Ev = m_EventsBuf.front(); m_EventsBuf.pop_front();
+							delete Ev;
+						}
+						deque<MReadOutAssembly*>::iterator I = lower_bound(m_EventsBuf.begin(), m_EventsBuf.end(), E, MReadOutAssemblyReverseSort);
+						m_EventsBuf.insert(I, E);
+					} else if(E->GetCL() > (m_EventsBuf.back()->GetCL() + (4*m_EventTimeWindow))){ //event time jumped forward too far
+						cout << "event time forward-skip: this CL = " << E->GetCL() << ", front CL = " << m_EventsBuf.front()->GetCL() << ", back CL = " << m_EventsBuf.back()->GetCL() << endl;
+						delete E;
+					} else {
+						deque<MReadOutAssembly*>::iterator I = lower_bound(m_EventsBuf.begin(), m_EventsBuf.end(), E, MReadOutAssemblyReverseSort);
+						m_EventsBuf.insert(I, E);
+					}
+				} else {
+						deque<MReadOutAssembly*>::iterator I = lower_bound(m_EventsBuf.begin(), m_EventsBuf.end(), E, MReadOutAssemblyReverseSort);
+						m_EventsBuf.insert(I, E);
+				}
+			} else {
+				m_EventsBuf.push_back(E);
+			}
+			*/
+			if(m_EventsBuf.IsEmpty() == false){
+				if(E->GetCL() < (m_EventsBuf.GetOldest()->GetCL() >> 1)){ //event time jumped back too far
+					cout << "event time back-skip: this CL = " << E->GetCL() << ", front CL = " << m_EventsBuf.GetOldest()->GetCL() << ", back CL = " << m_EventsBuf.GetNewestCL() << endl;
+					m_EventsBuf.Clear();
+				}
+			}
+			//the events of a stream arrive nearly in order, thus this rarely needs more than an append
+			m_EventsBuf.Add(E, Stream);
+
+		}
+		NewEvents.clear();
+		if( m_UseRawDataframes ){
+			if (g_Verbosity >= c_Info) cout<<"BinaryFlightDataParser: T ::: ";;
+			for( auto E: LastTimestamps ){
+				if (g_Verbosity >= c_Info) cout<<std::hex<<E<<" ";
+			}
+			if (g_Verbosity >= c_Info) cout<<std::dec<<endl;
+		} else if( m_UseComptonDataframes ){
+			if (g_Verbosity >= c_Info) cout<<"BinaryFlightDataParser: T_compton ::: "<<LastComptonTimestamp<<endl;
+		}
+	}
+}
 
-	//return true if a complete packet was found, return packet in NextPacket
-	//return false if a complete packet was not found.  also copy the leftover bytes
-	//back to the beginning
 
-	//idx is the value of dx that points to the beginning of the packet in m_SBuf
+////////////////////////////////////////////////////////////////////////////////
 
-	//assert: search buf is either synced or empty
 
-	uint16_t Len;
-	//bool FoundPacket;
-	//FoundPacket = false;
-	NextPacket.clear();
+void MBinaryFlightDataParser::SetNDecodeThreads(unsigned int NThreads)
+{
+	//Set the number of threads decoding dataframes (0: decode them in the parsing thread)
+	//Only takes effect in Initialize()
 
-	if( (dx + 2) > m_SBuf.size() ){
-		//not enough bytes to check for sync
-		return false;
+	m_NDecodeThreads = NThreads;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataParser::StartDecodeThreads()
+{
+	//Start the dataframe decoding threads
+
+	StopDecodeThreads();
+
+	m_StopDecoding = false;
+	for (unsigned int t = 0; t < m_NDecodeThreads; ++t) {
+		m_DecodeThreads.push_back(thread(&MBinaryFlightDataParser::DecodeLoop, this));
 	}
+}
 
-	while( !(m_SBuf[dx] == 0xeb && m_SBuf[dx+1] == 0x90) ){
-		ResyncSBuf();
-		if( m_SBuf.size() == 0 ){
-			return false;
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataParser::StopDecodeThreads()
+{
+	//Stop the dataframe decoding threads and release all not yet collected events
+
+	{
+		lock_guard<mutex> Lock(m_DecodeMutex);
+		m_StopDecoding = true;
+	}
+	m_DecodeCondition.notify_all();
+	for (auto& T: m_DecodeThreads) {
+		T.join();
+	}
+	m_DecodeThreads.clear();
+
+	for (auto Job: m_DecodeJobs) {
+		for (auto E: Job->Events) {
+			MObjectPool<MReadOutAssembly>::Release(E);
 		}
+		Job->Events.clear();
+		m_FreeDecodeJobs.push_back(Job);
 	}
+	m_DecodeJobs.clear();
+	m_NextDecodeJob = 0;
+}
 
-	//we are synced and the buffer is not empty
-	if( (dx + 10) > m_SBuf.size() ){
-		//not enough bytes to compute len
-		return false;
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataParser::SubmitDataframe(const packet& Packet, uint8_t Type)
+{
+	//Hand a raw or Compton dataframe to the decoding threads
+
+	lock_guard<mutex> Lock(m_DecodeMutex);
+
+	decodejob* Job = nullptr;
+	if (m_FreeDecodeJobs.empty() == false) {
+		Job = m_FreeDecodeJobs.back();
+		m_FreeDecodeJobs.pop_back();
+	} else {
+		Job = new decodejob();
 	}
 
-	Len = ((uint16_t)m_SBuf[dx+8]<<8) | ((uint16_t)m_SBuf[dx+9]);
-	if( Len > 1360 ){
-		//got a weird value, could be a spurious eb90, Resync() and exit
-		ResyncSBuf();
-		return false;
+	//views into the search buffer stay valid until this ParseData call has collected the
+	//decoded dataframes, only a stitched packet has to be copied since the stitch buffer is reused
+	if (Packet.data() == m_Stitch.data()) {
+		Job->Copy.assign(Packet.begin(), Packet.end());
+		Job->Packet = packet(Job->Copy.data(), Job->Copy.size());
+	} else {
+		Job->Packet = Packet;
 	}
-	// AZ: Found a case with Len == 0 which screwed up everything...
-	// Skip ahead beyond syncword and resync
-	if (Len == 0) {
-		dx += 2; 
-		ResyncSBuf();
-		return false;
+	Job->Type = Type;
+	Job->Stream = 0;
+	Job->HasError = false;
+	Job->IsDone = false;
+	Job->DecodeTime = 0;
+
+	m_DecodeJobs.push_back(Job);
+	m_DecodeCondition.notify_one();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataParser::DecodeLoop()
+{
+	//The loop of the decoding threads: decode the submitted dataframes in any order
+
+	unique_lock<mutex> Lock(m_DecodeMutex);
+	while (true) {
+		m_DecodeCondition.wait(Lock, [this] { return m_StopDecoding == true || m_NextDecodeJob < m_DecodeJobs.size(); });
+		if (m_StopDecoding == true) break;
+
+		decodejob* Job = m_DecodeJobs[m_NextDecodeJob++];
+		Lock.unlock();
+		DecodeDataframe(Job);
+		Lock.lock();
+		Job->IsDone = true;
+		m_DecodedCondition.notify_all();
 	}
+}
 
-	if( (dx + Len) > m_SBuf.size() ){
-		//we don't have the complete packet
-		//this should happen often since TCP will give us a bunch of bytes w/o boundaries 
-		//move the data up so as to clear out the packets we have already processed
-		m_SBuf.assign( m_SBuf.begin() + dx, m_SBuf.end() );
-		dx = 0;
-		return false;
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataParser::DecodeDataframe(decodejob* Job)
+{
+	//Decode the dataframe of the job into read-out assemblies - touches no shared state
+
+	chrono::steady_clock::time_point DecodeStart = chrono::steady_clock::now();
+
+	if( Job->Dataframe == nullptr ){
+		Job->Dataframe = new dataframe();
+	}
+	dataframe* Dataframe = Job->Dataframe;
+	if( Job->Type == 0x00 ){
+		if( RawDataframe2Struct( Job->Packet, Dataframe ) >= 0 ){
+			ConvertToMReadOutAssemblys( Dataframe, &Job->Events );
+			Job->Stream = Dataframe->CCId;
+		} else {
+			Job->HasError = true;
+		}
+	} else {
+		if( ComptonDataframe2Struct( Job->Packet, Dataframe ) ){
+			ConvertToMReadOutAssemblys( Dataframe, &Job->Events );
+			Job->Stream = c_ComptonStream;
+		} else {
+			Job->HasError = true;
+		}
 	}
 
-	//FoundPacket = true;
+	Job->DecodeTime = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - DecodeStart).count();
+}
 
-	//we have a complete packet, extract it
-	NextPacket.assign( m_SBuf.begin() + dx, m_SBuf.begin() + dx + Len);
-	//store the location of beginning of this packet
-	if( idx != NULL ){
-		*idx = dx;
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataParser::CollectDecodedDataframes()
+{
+	//Wait for all dataframes submitted in this ParseData call and add their events in packet order
+
+	for (size_t j = 0; j < m_DecodeJobs.size(); ++j) {
+		decodejob* Job = m_DecodeJobs[j];
+		{
+			unique_lock<mutex> Lock(m_DecodeMutex);
+			//help decoding instead of just waiting
+			while (Job->IsDone == false && m_NextDecodeJob < m_DecodeJobs.size()) {
+				decodejob* Other = m_DecodeJobs[m_NextDecodeJob++];
+				Lock.unlock();
+				DecodeDataframe(Other);
+				Lock.lock();
+				Other->IsDone = true;
+			}
+			m_DecodedCondition.wait(Lock, [Job] { return Job->IsDone == true; });
+		}
+
+		if( Job->HasError == true ){
+			if (g_Verbosity >= c_Error) cout<<"BinaryFlightDataParser: "<<(Job->Type == 0x00 ? "ParseERR" : "Parsing error")<<endl;
+			m_Statistics.AddParseError(Job->Type);
+		}
+		m_Statistics.AddParseTime(Job->Type, Job->DecodeTime);
+		AddToEventsBuf( Job->Events, Job->Stream );
+	}
+
+	lock_guard<mutex> Lock(m_DecodeMutex);
+	for (auto Job: m_DecodeJobs) {
+		m_FreeDecodeJobs.push_back(Job);
+	}
+	m_DecodeJobs.clear();
+	m_NextDecodeJob = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFlightDataParser::FindNextPacket(packet& NextPacket , uint64_t * Position){
+
+	//return true if a complete packet was found, return a view of the packet in NextPacket
+	//return false if a complete packet was not found, the leftover bytes stay in the search buffer
+
+	//the view points into the search buffer, or into the stitch buffer if the packet wraps around
+	//the end of the search buffer, thus it is only valid until the next call or until new data is appended
+
+	//Position is the position in the search buffer stream at which the packet begins
+
+	//assert: search buf is either synced or empty
+
+	uint16_t Len;
+	NextPacket = packet();
+
+	while (true) {
+		if( GetSBufSize() < 2 ){
+			//not enough bytes to check for sync
+			return false;
+		}
+
+		if( !(SBufAt(m_SBufBegin) == 0xeb && SBufAt(m_SBufBegin+1) == 0x90) ){
+			if( ResyncSBuf() == false ){
+				return false;
+			}
+		}
+
+		//we are synced and the buffer is not empty
+		if( GetSBufSize() < 10 ){
+			//not enough bytes to compute len
+			return false;
+		}
+
+		Len = ((uint16_t)SBufAt(m_SBufBegin+8)<<8) | ((uint16_t)SBufAt(m_SBufBegin+9));
+		if( Len > c_MaxPacketLength ){
+			//got a weird value, could be a spurious eb90, resync and try again
+			ResyncSBuf();
+			continue;
+		}
+		// AZ: Found a case with Len == 0 which screwed up everything...
+		// Anything shorter than the header is equally broken, skip ahead beyond syncword and resync
+		if (Len < 10) {
+			m_SBufBegin += 2; 
+			ResyncSBuf();
+			continue;
+		}
+
+		if( GetSBufSize() < Len ){
+			//we don't have the complete packet
+			//this should happen often since TCP will give us a bunch of bytes w/o boundaries 
+			//the leftover stays in the search buffer and is completed by the next data
+			return false;
+		}
+
+		break;
 	}
-	//increment the index...we should be pointing at the next 0xeb 
-	dx += Len;
 
-	if( dx == m_SBuf.size() ){
-		//no leftover bytes, just clear the buffer
-		dx = 0;
-		m_SBuf.clear();
+	//we have a complete packet, return a view of it
+	size_t Offset = m_SBufBegin & (c_SBufCapacity - 1);
+	if( Offset + Len <= c_SBufCapacity ){
+		NextPacket = packet( &m_SBuf[Offset], Len );
+	} else {
+		//the packet wraps around the end of the search buffer, stitch it together
+		m_Stitch.assign( m_SBuf.begin() + Offset, m_SBuf.end() );
+		m_Stitch.insert( m_Stitch.end(), m_SBuf.begin(), m_SBuf.begin() + (Offset + Len - c_SBufCapacity) );
+		NextPacket = packet( m_Stitch.data(), Len );
+	}
+	//store the location of beginning of this packet
+	if( Position != NULL ){
+		*Position = m_SBufBegin;
 	}
+	//we should be pointing at the next 0xeb now
+	m_SBufBegin += Len;
 
-	if( m_SBuf.size() > 10000000 ){
-		//clear out buffer
-		cout<<"lost !!! dx = "<<dx<<" size = "<<m_SBuf.size()<<endl;
-		m_LostBytes += m_SBuf.size() - dx;
-		dx = 0;
-		m_SBuf.clear();
+	if( m_SBufBegin == m_SBufEnd ){
+		//no leftover bytes, start again at the beginning, which keeps most packets contiguous
+		m_SBufBegin = 0;
+		m_SBufEnd = 0;
 	}
 
 	return true;
@@ -680,44 +905,136 @@ bool MBinaryFlightDataParser::FindNextPacket(vector<uint8_t>& NextPacket , unsig
 bool MBinaryFlightDataParser::ResyncSBuf(void){
 
 
-	//this method makes sure that either m_SBuf[dx] = 0xeb and m_SBuf[dx+1] = 0x90
-	//or that the buffer is empty and dx = 0;
+	//this method makes sure that either the search buffer begins with 0xeb 0x90 followed by
+	//a plausible header, or that the buffer is empty (or only holds a trailing 0xeb)
 
 	//start from the +1th element when searching for 0xeb, or check if the current
-	//Buf[dx] is eb, and if it is then + 1
-
-	if (g_Verbosity >= c_Info) cout<<"BinaryFlightDataParser: Resyncing input stream! Buffer size: "<<m_SBuf.size()<<", position in buffer: "<<dx<<endl;
+	//first byte is eb, and if it is then + 1
 
-	bool FoundSync;
+	//this happens a lot on noisy links, thus we only count instead of logging every call
 
-	if( m_SBuf.size() == 0 ){
-		dx = 0;
-		FoundSync = false;
-		return FoundSync;
+	if( GetSBufSize() == 0 ){
+		m_SBufBegin = 0;
+		m_SBufEnd = 0;
+		return false;
 	}
 
+	m_Statistics.AddResync();
+
 	//we might be pointing at a spurious 0xeb 0x90, rare case... add 1 so that
-	//the for loop below doesn't think its on a valid sync word
-	if (m_SBuf[dx] == 0xeb) ++dx;
-
-	FoundSync = false;
-	for(unsigned i = dx; i < m_SBuf.size()-1; ++i) { // m_SBuf is not allowed to be 0 so we are OK
-		if( m_SBuf[i] == 0xeb ){
-			if( m_SBuf[i+1] == 0x90 ){
-				FoundSync = true;
-				dx = i;
-				break;
-			}
+	//the search below doesn't think its on a valid sync word
+	uint64_t Start = m_SBufBegin;
+	if (SBufAt(Start) == 0xeb) ++Start;
+
+	uint64_t Position = Start;
+	while( (Position = FindSyncWord(Position)) != m_SBufEnd ){
+		if( IsPlausibleHeader(Position) == true ){
+			m_Statistics.AddLostBytes(Position - m_SBufBegin);
+			m_SBufBegin = Position;
+			return true;
 		}
+		++Position;
 	}
 
-	if( !FoundSync ){
-		m_SBuf.clear();
-		dx = 0;
-	} 
+	//a trailing 0xeb might be the first half of a sync word split between two inputs, keep it
+	if( m_SBufEnd - 1 >= Start && SBufAt(m_SBufEnd - 1) == 0xeb ){
+		m_Statistics.AddLostBytes(m_SBufEnd - 1 - m_SBufBegin);
+		m_SBufBegin = m_SBufEnd - 1;
+		return false;
+	}
 
-	return FoundSync;
+	m_Statistics.AddLostBytes(GetSBufSize());
+	m_SBufBegin = 0;
+	m_SBufEnd = 0;
 
+	return false;
+
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+uint64_t MBinaryFlightDataParser::FindSyncWord(uint64_t Position) const
+{
+	//Return the position of the next 0xeb 0x90 at or after Position, or m_SBufEnd if there is none
+
+	//memchr is vectorized in any decent C library, thus we let it find the candidates 0xeb
+	//in the (up to two) contiguous parts of the ring buffer and only check their second byte
+	while( Position + 1 < m_SBufEnd ){
+		size_t Offset = Position & (c_SBufCapacity - 1);
+		size_t Contiguous = min<uint64_t>(m_SBufEnd - Position, c_SBufCapacity - Offset);
+		const uint8_t* Begin = &m_SBuf[Offset];
+		const uint8_t* Found = static_cast<const uint8_t*>(memchr(Begin, 0xeb, Contiguous));
+		if( Found == nullptr ){
+			Position += Contiguous;
+			continue;
+		}
+		Position += Found - Begin;
+		if( Position + 1 < m_SBufEnd && SBufAt(Position + 1) == 0x90 ){
+			return Position;
+		}
+		++Position;
+	}
+
+	return m_SBufEnd;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFlightDataParser::IsPlausibleHeader(uint64_t Position) const
+{
+	//Check the header of the packet starting with the sync word at Position
+	//The packets have no checksum, thus we check the length bounds and the packet type
+	//If the header is not yet complete, we give it the benefit of the doubt
+
+	if( Position + 10 > m_SBufEnd ){
+		return true;
+	}
+
+	uint16_t Len = ((uint16_t)SBufAt(Position+8)<<8) | ((uint16_t)SBufAt(Position+9));
+	if( Len < 10 || Len > c_MaxPacketLength ){
+		return false;
+	}
+
+	//only accept the packet types we decode: raw, Compton, aspect, livetime, GCU housekeeping, settings
+	switch( SBufAt(Position+2) & 0x0f ){
+		case 0x00:
+		case 0x01:
+		case 0x05:
+		case 0x06:
+		case 0x07:
+		case 0x0b:
+			return true;
+		default:
+			return false;
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+size_t MBinaryFlightDataParser::AppendToSBuf(const uint8_t* Data, size_t Size)
+{
+	//Append as much data to the search buffer as fits, return the number of appended bytes
+
+	if (m_SBuf.size() != c_SBufCapacity) m_SBuf.resize(c_SBufCapacity);
+
+	Size = min(Size, c_SBufCapacity - GetSBufSize());
+	if (Size == 0) return 0;
+
+	size_t Offset = m_SBufEnd & (c_SBufCapacity - 1);
+	size_t First = min(Size, c_SBufCapacity - Offset);
+	memcpy(&m_SBuf[Offset], Data, First);
+	if (First < Size) {
+		memcpy(&m_SBuf[0], Data + First, Size - First);
+	}
+	m_SBufEnd += Size;
+
+	return Size;
 }
 
 
@@ -729,14 +1046,14 @@ bool MBinaryFlightDataParser::FlushEventsBuf(void){
 	//int MergedEventCounter = 0;
 
 	//don't check m_EventTimeWindow, we are flushing the buffer
-	while( m_EventsBuf.size() > 0){
-		MReadOutAssembly * FirstEvent = m_EventsBuf.front(); m_EventsBuf.pop_front();
+	while( m_EventsBuf.IsEmpty() == false ){
+		MReadOutAssembly * FirstEvent = m_EventsBuf.PopOldest();
 		deque<MReadOutAssembly*> EventList;
 		EventList.push_back(FirstEvent);
 		//now check if the next events are within the compton window
-		while( m_EventsBuf.size() > 0 ){
-			if( (m_EventsBuf[0]->GetCL() - FirstEvent->GetCL()) <= m_ComptonWindow ){
-				EventList.push_back( m_EventsBuf.front() ); m_EventsBuf.pop_front();
+		while( m_EventsBuf.IsEmpty() == false ){
+			if( (m_EventsBuf.GetOldest()->GetCL() - FirstEvent->GetCL()) <= m_ComptonWindow ){
+				EventList.push_back( m_EventsBuf.PopOldest() );
 			} else {
 				break;
 			}
@@ -747,9 +1064,10 @@ bool MBinaryFlightDataParser::FlushEventsBuf(void){
 		//set the ID of the event and increment the ID counter
 		NewMergedEvent->SetID( ++m_EventIDCounter );
 		m_Events.push_back( NewMergedEvent );
+		m_Statistics.AddEventsEmitted(1);
 	}
 
-	if( m_EventsBuf.size() == 0 ) return true; else return false;
+	if( m_EventsBuf.IsEmpty() == true ) return true; else return false;
 }
 
 
@@ -768,25 +1086,25 @@ bool MBinaryFlightDataParser::CheckEventsBuf(void){
 		Window = m_EventTimeWindow;
 	}
 
-	if( m_EventsBuf.size() > 0 ){
-		if (m_EventsBuf.back()->GetCL() - m_EventsBuf.front()->GetCL() < 100000 && 
-				m_EventsBuf.size() > 500) {
+	if( m_EventsBuf.IsEmpty() == false ){
+		if (m_EventsBuf.GetNewestCL() - m_EventsBuf.GetOldest()->GetCL() < 100000 && 
+				m_EventsBuf.GetNEvents() > 500) {
 			cout<<"Something is strange: I have more than 500 events and all are within the time window of 10 milli-seconds"<<endl;
 		}    
 	}
 
 	//pop good events
-	while(m_EventsBuf.size() > 0){
-		if(m_EventsBuf.back()->GetCL() - m_EventsBuf.front()->GetCL() >= Window ){
-			MReadOutAssembly * FirstEvent = m_EventsBuf.front(); m_EventsBuf.pop_front();
+	while(m_EventsBuf.IsEmpty() == false){
+		if(m_EventsBuf.GetNewestCL() - m_EventsBuf.GetOldest()->GetCL() >= Window ){
+			MReadOutAssembly * FirstEvent = m_EventsBuf.PopOldest();
 			deque<MReadOutAssembly*> EventList;
 			EventList.push_back(FirstEvent);
 
 			if( m_CoincidenceEnabled ){
 				//now check if the next events are within the compton window
-				while( m_EventsBuf.size() > 0 ){
-					if( (m_EventsBuf[0]->GetCL() - FirstEvent->GetCL()) <= m_ComptonWindow ){
-						EventList.push_back( m_EventsBuf.front() ); m_EventsBuf.pop_front();
+				while( m_EventsBuf.IsEmpty() == false ){
+					if( (m_EventsBuf.GetOldest()->GetCL() - FirstEvent->GetCL()) <= m_ComptonWindow ){
+						EventList.push_back( m_EventsBuf.PopOldest() );
 					} else {
 						break;
 					}
@@ -797,6 +1115,7 @@ bool MBinaryFlightDataParser::CheckEventsBuf(void){
 			//now push this merged event onto the internal events deque
 			NewMergedEvent->SetID( ++m_EventIDCounter );
 			m_Events.push_back(NewMergedEvent);
+			m_Statistics.AddEventsEmitted(1);
 			//if( m_EventsBuf.size() == 0 ) break;
 		} else {
 			break;
@@ -818,18 +1137,21 @@ MReadOutAssembly * MBinaryFlightDataParser::MergeEvents( deque<MReadOutAssembly*
 	//take the first event, and then merge hits from all other coincident
 	//events into this base event
 	BaseEvent = EventList->front(); EventList->pop_front();
-	for( auto E: *EventList ){
-		while( E->GetNStripHits() > 0){
-			BaseEvent->AddStripHit( E->GetStripHit(0) );
-			E->RemoveStripHit(0);
+	if( EventList->size() > 0 ){
+		//reserve once, so that appending the hits does not reallocate
+		unsigned int NStripHits = BaseEvent->GetNStripHits();
+		for( auto E: *EventList ){
+			NStripHits += E->GetNStripHits();
 		}
-		while( E->GetNStripHitsTOnly() > 0){
-			BaseEvent->AddStripHitTOnly( E->GetStripHitTOnly(0) );
-			E->RemoveStripHitTOnly(0);
-		}
-		//now we should free the memory for the MReadOutAssembly that we just copied the 
+		BaseEvent->ReserveStripHits(NStripHits);
+	}
+	for( auto E: *EventList ){
+		BaseEvent->TakeStripHits(E);
+		BaseEvent->TakeStripHitsTOnly(E);
+		BaseEvent->TakeGuardringHits(E);
+		//now we should recycle the MReadOutAssembly that we just copied the 
 		//strip hit from
-		delete E;
+		MObjectPool<MReadOutAssembly>::Release(E);
 	}
 
 	return BaseEvent;
@@ -844,17 +1166,34 @@ void MBinaryFlightDataParser::Finalize()
 {
 	// Close the tranceiver 
   
-  while (m_EventsBuf.begin() != m_EventsBuf.end()) {
-    delete m_EventsBuf.front();
-    m_EventsBuf.pop_front();
-  }
+  StopDecodeThreads();
+
+  m_EventsBuf.Clear();
 	while (m_Events.begin() != m_Events.end()) {
-		delete m_Events.front();
+		MObjectPool<MReadOutAssembly>::Release(m_Events.front());
 		m_Events.pop_front();
 	}
 
 	m_Housekeeping.close();
+	m_HousekeepingWriter.Close();
 	cout<<"HOUSEKEEPING FILE CLOSED"<<endl;
+
+	WriteMetrics(true);
+	m_Metrics.close();
+
+	if (g_Verbosity >= c_Info && m_Statistics.GetNResyncs() > 0) {
+		cout<<"BinaryFlightDataParser: Resynchronized the input stream "<<m_Statistics.GetNResyncs()<<" times, skipping "<<m_Statistics.GetNLostBytes()<<" bytes"<<endl;
+	}
+	if (g_Verbosity >= c_Info) {
+		cout<<"BinaryFlightDataParser: Duplicate packets: "<<m_PacketRecord.GetNHits()<<", unique packets: "<<m_PacketRecord.GetNMisses()<<endl;
+		cout<<"BinaryFlightDataParser: Events out of order within their card cage stream: "<<m_EventsBuf.GetNLateEvents()<<endl;
+		cout<<"BinaryFlightDataParser: Parse errors: "<<m_Statistics.GetNParseErrors()<<", events emitted: "<<m_Statistics.GetNEventsEmitted()<<endl;
+		for (unsigned int t = 0; t < MBinaryFlightDataParserStatistics::GetNTypes(); ++t) {
+			if (m_Statistics.GetNPackets(t) == 0) continue;
+			cout<<"BinaryFlightDataParser: "<<MBinaryFlightDataParserStatistics::GetTypeName(t)<<" packets: "<<m_Statistics.GetNPackets(t)
+			    <<", bytes: "<<m_Statistics.GetNPacketBytes(t)<<", parse time: "<<1E-9*m_Statistics.GetParseTime(t)<<" s"<<endl;
+		}
+	}
 	return;
 }
 
@@ -862,13 +1201,44 @@ void MBinaryFlightDataParser::Finalize()
 ////////////////////////////////////////////////////////////////////////////////
 
 
-int MBinaryFlightDataParser::RawDataframe2Struct( vector<uint8_t> Buf, dataframe * DataOut)
+MBinaryFlightDataParserStatistics MBinaryFlightDataParser::GetStatistics() const
+{
+	//Return a snapshot of the telemetry statistics including the counters kept by the duplicate filter and the merger
+
+	MBinaryFlightDataParserStatistics Statistics = m_Statistics;
+	Statistics.SetNDuplicates(m_PacketRecord.GetNHits());
+	Statistics.SetNLateEvents(m_EventsBuf.GetNLateEvents());
+	return Statistics;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataParser::WriteMetrics(bool Force)
+{
+	//Append the statistics to the metrics file as one JSON line if the metrics interval has passed or if forced
+
+	if( m_Metrics.is_open() == false ) return;
+
+	chrono::steady_clock::time_point Now = chrono::steady_clock::now();
+	if( Force == false && chrono::duration<double>(Now - m_LastMetrics).count() < m_MetricsInterval ) return;
+	m_LastMetrics = Now;
+
+	GetStatistics().StreamJson(m_Metrics, chrono::duration<double>(Now - m_MetricsStart).count());
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+int MBinaryFlightDataParser::RawDataframe2Struct( const packet& Buf, dataframe * DataOut)
 {
 	//return a dataframe struct
 	//a subsequent funtion should dtake the returned dataframe and return a vector of MReadOutAssemblys
 
 	size_t x; //index for looping through Buf
-	trigger TrigBuf[MAX_TRIGS];
+	trigger TrigBuf[c_MaxTriggersPerEvent];
 	unsigned int tx;
 	int EventCounter;
 	int NumPayLoadBytes;
@@ -876,18 +1246,17 @@ int MBinaryFlightDataParser::RawDataframe2Struct( vector<uint8_t> Buf, dataframe
 	int NumADCTrigs, NumTimingTrigs;
 	int NumTimingBytes[8];
 	unsigned int j;
-	event Event;
 	uint8_t mask_or[10];
 	uint8_t Masks[8] = {1,2,4,8,16,32,64,128};
 	int NumEvents;	
 	unsigned int Length;
-	trigger NewTrig;
 
 
 	if( DataOut == NULL ){
 		cout<<"DataOut is NULL, returning -1..."<<endl;
 		return -1;
 	}
+	DataOut->Reset();
 
 	if( Buf.size() != 1360 ){
 		cout<<"dataframe must be 1360 bytes! returning -1..."<<endl;
@@ -914,7 +1283,6 @@ int MBinaryFlightDataParser::RawDataframe2Struct( vector<uint8_t> Buf, dataframe
 	DataOut->SysTime = DataOut->SysTime & 0xffffffffffff;
 	DataOut->LifetimeBits = (((((uint32_t)Buf[21] << 24) | ((uint32_t)Buf[20] << 16)) | ((uint32_t)Buf[19] << 8)) | ((uint32_t)Buf[18]));
 	DataOut->RawOrCompton = "raw";
-	DataOut->HasSysErr = false;
 
 	//x = 12; //jump to index of first 0xAE
 	x = 22; //now the input is a full 1360 packet
@@ -999,7 +1367,7 @@ int MBinaryFlightDataParser::RawDataframe2Struct( vector<uint8_t> Buf, dataframe
 					}
 
 					++tx;
-					if( tx > MAX_TRIGS ){
+					if( tx > c_MaxTriggersPerEvent ){
 						//might want to copy below code regarding NumPayloadBytes since it will get skipped on the goto
 						goto loop_exit; //legitimate usage of goto... to break out of nested for loops
 					}
@@ -1019,7 +1387,7 @@ int MBinaryFlightDataParser::RawDataframe2Struct( vector<uint8_t> Buf, dataframe
 
 loop_exit:
 
-		if( (tx <= MAX_TRIGS) && ( tx > 0) ){
+		if( (tx <= c_MaxTriggersPerEvent) && ( tx > 0) ){
 
 			Tx = x + 32; //jump to first timing byte
 
@@ -1065,7 +1433,14 @@ loop_exit:
 			}
 
 
-			if( NumADCTrigs > 0 ){ //allocate mem for a new event if there are ADC trigs
+			if( NumADCTrigs > 0 ){ //fill the next event of the dataframe if there are ADC trigs
+
+				if( DataOut->NumEvents >= c_MaxEventsPerDataframe || DataOut->NumTriggers + tx > c_MaxTriggersPerDataframe ){
+					//cannot happen in a 1360 byte dataframe
+					DataOut->ParseError = true;
+					return -6;
+				}
+				event& Event = DataOut->Events[DataOut->NumEvents];
 
 				//fill in the event header info 
 				Event.EventTime = (Buf[x+5]<<24)|(Buf[x+4]<<16)|(Buf[x+3]<<8)|(Buf[x+2]);
@@ -1083,8 +1458,8 @@ loop_exit:
 					DataOut->HasSysErr = true;
 				}
 
-				//clear out triggers
-				Event.Triggers.clear();
+				//the triggers follow the ones of the previous events
+				Event.FirstTrigger = DataOut->NumTriggers;
 
 				int N;
 				N = 0;
@@ -1094,9 +1469,9 @@ loop_exit:
 					//in that case, don't throw out the timing only triggers here
 					//then below, in ConvertToMReadOutAssemblys, put the timing only strip hits in a separate buffer so that they don't interfere
 					//with all of the mainstream analysis.
-					NewTrig = TrigBuf[i];
-					NewTrig.CCId = DataOut->CCId;
-					Event.Triggers.push_back(NewTrig);
+					DataOut->Triggers[DataOut->NumTriggers] = TrigBuf[i];
+					DataOut->Triggers[DataOut->NumTriggers].CCId = DataOut->CCId;
+					++DataOut->NumTriggers;
 					++N;
 
 					/*
@@ -1110,7 +1485,6 @@ loop_exit:
 				}
 
 				Event.NumTriggers = N;
-				DataOut->Events.push_back(Event);
 				++EventCounter;
 				++DataOut->NumEvents;
 
@@ -1153,13 +1527,13 @@ bool MBinaryFlightDataParser::ConvertToMReadOutAssemblys( dataframe * DataIn, ve
 	CEvents->clear(); //
 
 	//make sure we have some events
-	if( DataIn->Events.size() == 0 ){
+	if( DataIn->NumEvents == 0 ){
 		return false;
 	}
 
-	//since the MReadOutAssemblys are going to be pushed into a deque for the coincedence search, we want to call 
-	//new and delete so that the pointers to these MReadOutAssemblys will be valid until the MReadOutAssembly is popped
-	//out of the deque.
+	//since the MReadOutAssemblys are going to be pushed into a deque for the coincedence search, we take them from
+	//the object pool so that the pointers to these MReadOutAssemblys will be valid until the MReadOutAssembly is popped
+	//out of the deque and released again.
 
 	//check for rollovers in this dataframe.  need this info in order to properly shift bits 48..33 of the 
 	//systime into the individual events times (which are only 32 bits)
@@ -1169,7 +1543,7 @@ bool MBinaryFlightDataParser::ConvertToMReadOutAssemblys( dataframe * DataIn, ve
 		RolloverOccurred = true; 
 		//EndRollover = false; 
 		MiddleRollover = false;
-		if( DataIn->Events.back().EventTime < DataIn->Events.front().EventTime ){
+		if( DataIn->Events[DataIn->NumEvents-1].EventTime < DataIn->Events[0].EventTime ){
 			MiddleRollover = true;
 		} else {
 			// EndRollover = true; // az: not used, thus commented out
@@ -1179,15 +1553,17 @@ bool MBinaryFlightDataParser::ConvertToMReadOutAssemblys( dataframe * DataIn, ve
 	//negative side -> DC -> boards 4-7 -> X
 	//positive side -> AC -> boards 0-3 -> Y
 
-	for( auto E: DataIn->Events ){
-		NewEvent = new MReadOutAssembly();
-		for( auto T: E.Triggers ){
-			StripHit = new MStripHit();
+	for( uint32_t e = 0; e < DataIn->NumEvents; ++e ){
+		const event& E = DataIn->Events[e];
+		NewEvent = MObjectPool<MReadOutAssembly>::Get();
+		for( uint32_t t = E.FirstTrigger; t < E.FirstTrigger + E.NumTriggers; ++t ){
+			const trigger& T = DataIn->Triggers[t];
+			StripHit = MObjectPool<MStripHit>::Get();
 			StripHit->SetDetectorID(m_CCMap[T.CCId]);
 			//go from board channel, to side strip
-			if( T.Board >= 4 && T.Board < 8 ) PosSide = false; else if( T.Board >= 0 && T.Board < 4 ) PosSide = true; else {cout<<"bad trigger board = "<<T.Board<<endl; delete StripHit; continue;} 
+			if( T.Board >= 4 && T.Board < 8 ) PosSide = false; else if( T.Board >= 0 && T.Board < 4 ) PosSide = true; else {cout<<"bad trigger board = "<<T.Board<<endl; MObjectPool<MStripHit>::Release(StripHit); continue;} 
 			StripHit->IsPositiveStrip(PosSide);
-			if( T.Channel >= 0 && T.Channel < 10 ) StripHit->SetStripID(m_StripMap[T.Board][T.Channel]+1); else {cout<<"bad trigger channel = "<<T.Channel<<endl; delete StripHit; continue;}
+			if( T.Channel >= 0 && T.Channel < 10 ) StripHit->SetStripID(m_StripMap[T.Board][T.Channel]+1); else {cout<<"bad trigger channel = "<<T.Channel<<endl; MObjectPool<MStripHit>::Release(StripHit); continue;}
 			if( T.HasADC ) StripHit->SetADCUnits((double)((uint16_t)T.ADCBytes & 0x1fff)); else StripHit->SetADCUnits(0.0);
 			if( T.HasTiming ) {
 				unsigned int Val = 0;
@@ -1217,7 +1593,7 @@ bool MBinaryFlightDataParser::ConvertToMReadOutAssemblys( dataframe * DataIn, ve
 		if( RolloverOccurred ){
 			if( MiddleRollover ){
 				//cout << "middle rollover for CC " << DataIn->CCId << endl;
-				if( E.EventTime >= DataIn->Events.front().EventTime ){
+				if( E.EventTime >= DataIn->Events[0].EventTime ){
 					Clk = E.EventTime | ((DataIn->SysTime - 0x0000000100000000) & 0x0000ffff00000000);
 				} else {
 					Clk = E.EventTime | (DataIn->SysTime & 0x0000ffff00000000);
@@ -1353,25 +1729,57 @@ void MBinaryFlightDataParser::LoadStripMap(void){
 
 ///////////////////////////////////////////////////////////////////
 
-bool MBinaryFlightDataParser::SortEventsBuf(void){
+bool MBinaryFlightDataParser::DecodeGCUHousekeeping( const packet & Packet, uint8_t & UnixTimeMSB, double & ShieldCountRate ) const
+{
+	//Decode only the used fields of a GCU housekeeping packet directly from the bytes
+	//the offsets are the ones of the generated GCUHousekeepingParser
 
-	std::sort(m_EventsBuf.begin(), m_EventsBuf.end(), MReadOutAssemblyTimeCompare);
-	return true;
+	if( Packet.size() < 244 ){
+		return false;
+	}
+
+	UnixTimeMSB = Packet[243];
+
+	//the shield samples start at byte 343 with 9 bytes each: counts, time interval in 100 ns, livetime fraction
+	ShieldCountRate = 0;
+	uint8_t NumSamples = ( Packet.size() > 342 ) ? Packet[342] : 0;
+	if( NumSamples > 0 && Packet.size() >= 352 ){
+		uint32_t NumCounts = ((uint32_t) Packet[343] << 24) | ((uint32_t) Packet[344] << 16) | ((uint32_t) Packet[345] << 8) | Packet[346];
+		uint32_t TimeInterval = ((uint32_t) Packet[347] << 24) | ((uint32_t) Packet[348] << 16) | ((uint32_t) Packet[349] << 8) | Packet[350];
+		ShieldCountRate = static_cast<double>(NumCounts)/(static_cast<double>(TimeInterval)*1e-7);
+	}
 
+	return true;
 }
 
-///////////////////////////////////////////////////////////////////
 
-bool MReadOutAssemblyTimeCompare(MReadOutAssembly * E1, MReadOutAssembly * E2){
+////////////////////////////////////////////////////////////////////////////////
 
-	//sort based on 48 bit clock value
-	if( E1->GetCL() < E2->GetCL() ) return true; else return false;
 
+bool MBinaryFlightDataParser::DecodePreampTemperatures( const packet & Packet )
+{
+	//Decode the preamp temperatures directly from the bytes of a GCU settings packet
+	//the temperature of board b and channel c is at byte 98 + 2*(8*b + c), see the generated GCUSettingsParser
+
+	if( Packet.size() < 146 ){
+		return false;
+	}
+
+	//Order of PreampTemps are defined as Det0 DC, Det0 AC, Det1 DC, Det1, AC...etc
+	static const unsigned int BoardChannel[24] = { 16, 19, 6, 18, 7, 17, 14, 20, 15, 21, 23, 22, 13, 10, 12, 9, 11, 8, 3, 0, 4, 1, 5, 2 };
+	for( unsigned int i = 0; i < 24; ++i ){
+		size_t Offset = 98 + 2*BoardChannel[i];
+		m_PreampTemps[i] = ((uint16_t) Packet[Offset] << 8) | Packet[Offset + 1];
+	}
+
+	return true;
 }
 
-///////////////////////////////////////////////////////////////////
 
-bool MBinaryFlightDataParser::ProcessAspect( vector<uint8_t> & NextPacket ){
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFlightDataParser::ProcessAspect( const packet & NextPacket ){
 
 	//look for '$'
 
@@ -1426,8 +1834,7 @@ bool MBinaryFlightDataParser::ProcessAspect( vector<uint8_t> & NextPacket ){
 				if( Header.find("$PASHR,DSO") == 0 ){
 					//check that we have enough bytes in the buffer for this
 					if( (wx + DSOLen) <= Len ){
-						vector<uint8_t> DSOMsg;
-						DSOMsg.assign( NextPacket.begin() + wx, NextPacket.begin() + wx + DSOLen );
+						packet DSOMsg( NextPacket.data() + wx, DSOLen );
 						MAspectPacket DSOPacket;
 						DecodeDSO( DSOMsg, DSOPacket );//transfer info from DSO msg into an MAspectPacket
 						DSOPacket.PPSClk |= UpperClkBytes;
@@ -1468,9 +1875,8 @@ bool MBinaryFlightDataParser::ProcessAspect( vector<uint8_t> & NextPacket ){
 								//the above check on unix time and aspect ID are so that if we get misordered packets,
 								//and the first subpacket is a magnetometer packet, we won't use the DSO info 
 								//from the last DSO message processed, since this will have happened in the future.
-								vector<uint8_t> MagMsg;
+								packet MagMsg( NextPacket.data() + wx, MagLen );
 								MAspectPacket MagPacket;
-								MagMsg.assign( NextPacket.begin() + wx, NextPacket.begin() + wx + MagLen );
 								DecodeMag( MagMsg, MagPacket );
 
 								//copy over all necessary parameters to MagPacket from m_LastDSOPacket
@@ -1676,7 +2082,7 @@ bool MBinaryFlightDataParser::ProcessAspect_works( vector<uint8_t> & NextPacket
 
 ////////////////////////////////////////////////////////////////////////////////
 
-bool MBinaryFlightDataParser::DecodeDSO(vector<uint8_t> & DSOString, MAspectPacket& GPS_Packet){
+bool MBinaryFlightDataParser::DecodeDSO(const packet & DSOString, MAspectPacket& GPS_Packet){
 
 	uint32_t MySeconds;
 	MySeconds = 0;
@@ -1864,7 +2270,7 @@ bool MBinaryFlightDataParser::DecodeDSO(vector<uint8_t> & DSOString, MAspectPack
 /////////////////////////////////////////////////////////////////////
 
 
-bool MBinaryFlightDataParser::DecodeMag(vector<uint8_t>& MagString, MAspectPacket& M_Packet){
+bool MBinaryFlightDataParser::DecodeMag(const packet & MagString, MAspectPacket& M_Packet){
 
 	//  printf(" %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x \n", MagString[0] & 0xFF, MagString[1] & 0xFF, MagString[2] & 0xFF, MagString[3] & 0xFF, MagString[4] & 0xFF, MagString[5] & 0xFF, MagString[6] & 0xFF, MagString[7] & 0xFF, MagString[8] & 0xFF, MagString[9] & 0xFF, MagString[10] & 0xFF, MagString[11] & 0xFF, MagString[12] & 0xFF, MagString[13] & 0xFF, MagString[14] & 0xFF, MagString[15] & 0xFF, MagString[16] & 0xFF, MagString[17] & 0xFF, MagString[18] & 0xFF, MagString[19] & 0xFF, MagString[20] & 0xFF, MagString[21] & 0xFF, MagString[22] & 0xFF, MagString[23] & 0xFF);
 
@@ -1983,7 +2389,7 @@ bool MBinaryFlightDataParser::DecodeMag(vector<uint8_t>& MagString, MAspectPacke
 ///////////////////////////////////////////////////////////////////////////////////////////
 
 
-bool MBinaryFlightDataParser::ComptonDataframe2Struct( vector<uint8_t>& Buf, dataframe * DataOut ){
+bool MBinaryFlightDataParser::ComptonDataframe2Struct( const packet& Buf, dataframe * DataOut ){
 
 	size_t wx = 0;
 	size_t BufSize = Buf.size();
@@ -1992,6 +2398,7 @@ bool MBinaryFlightDataParser::ComptonDataframe2Struct( vector<uint8_t>& Buf, dat
 	if( DataOut == NULL ){
 		return false;
 	}
+	DataOut->Reset();
 
 	if( BufSize < 16 ){
 		return false;
@@ -2012,7 +2419,10 @@ bool MBinaryFlightDataParser::ComptonDataframe2Struct( vector<uint8_t>& Buf, dat
 			//we are at the beginning of an event, read it in
 
 			wx += 7; if( wx > BufSize ) { DataOut->ParseError = true; return false; }
-			event NewEvent;
+			if( DataOut->NumEvents >= c_MaxEventsPerDataframe ) { DataOut->ParseError = true; return false; }
+			event& NewEvent = DataOut->Events[DataOut->NumEvents];
+			NewEvent.FirstTrigger = DataOut->NumTriggers;
+			NewEvent.NumTriggers = 0;
 			EvCnt++;
 			NewEvent.EventID = Buf[wx - 6];
 			NewEvent.NumCCsInvolved = Buf[wx - 5] & 0x0f;
@@ -2032,7 +2442,8 @@ bool MBinaryFlightDataParser::ComptonDataframe2Struct( vector<uint8_t>& Buf, dat
 					//at this point, wx points at the trigger byte
 
 					wx += 3; if( wx > BufSize ) { DataOut->ParseError = true; return false; }
-					trigger NewTrig;
+					if( DataOut->NumTriggers >= c_MaxTriggersPerDataframe ) { DataOut->ParseError = true; return false; }
+					trigger& NewTrig = DataOut->Triggers[DataOut->NumTriggers];
 					NewTrig.HasADC = true;
 					NewTrig.Channel = Buf[wx-3] & 0x0f;
 					NewTrig.Board = (Buf[wx-3] & 0x70) >> 4;
@@ -2049,12 +2460,13 @@ bool MBinaryFlightDataParser::ComptonDataframe2Struct( vector<uint8_t>& Buf, dat
 					}
 
 					NewTrig.CCId = CurrentCC;
-					NewEvent.Triggers.push_back(NewTrig);
+					++DataOut->NumTriggers;
+					++NewEvent.NumTriggers;
 
 				}
 			}
 
-			DataOut->Events.push_back(NewEvent);
+			++DataOut->NumEvents;
 
 		} else { DataOut->ParseError = true; return false; }
 	}
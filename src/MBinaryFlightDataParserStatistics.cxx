@@ -0,0 +1,234 @@
+/*
+ * MBinaryFlightDataParserStatistics.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MBinaryFlightDataParserStatistics
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MBinaryFlightDataParserStatistics.h"
+
+// Standard libs:
+#include <iomanip>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MStreams.h"
+
+// Nuclearizer libs:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MBinaryFlightDataParserStatistics)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+const unsigned int MBinaryFlightDataParserStatistics::c_NTypes;
+const uint8_t MBinaryFlightDataParserStatistics::c_TypeMask;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MBinaryFlightDataParserStatistics::MBinaryFlightDataParserStatistics()
+{
+  // Construct an instance of MBinaryFlightDataParserStatistics
+
+  Clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MBinaryFlightDataParserStatistics::~MBinaryFlightDataParserStatistics()
+{
+  // Delete this instance of MBinaryFlightDataParserStatistics
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataParserStatistics::Clear()
+{
+  //! Reset all counters
+
+  m_NBytesReceived = 0;
+  for (unsigned int t = 0; t < c_NTypes; ++t) {
+    m_NPackets[t] = 0;
+    m_NPacketBytes[t] = 0;
+    m_ParseTime[t] = 0;
+    m_NParseErrors[t] = 0;
+  }
+  m_NResyncs = 0;
+  m_NLostBytes = 0;
+  m_NDuplicates = 0;
+  m_NLateEvents = 0;
+  m_NEventsEmitted = 0;
+
+  m_NMergeWindowSamples = 0;
+  m_MergeWindowSum = 0;
+  m_MergeWindowMax = 0;
+  m_MergeWindowLast = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataParserStatistics::AddPacket(uint8_t Type, uint64_t Bytes, uint64_t Nanoseconds)
+{
+  //! Add one packet of the given type with its size and the time it took to parse it
+
+  Type &= c_TypeMask;
+  ++m_NPackets[Type];
+  m_NPacketBytes[Type] += Bytes;
+  m_ParseTime[Type] += Nanoseconds;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataParserStatistics::AddMergeWindowOccupancy(uint64_t NEvents)
+{
+  //! Add one sample of the number of events in the merge window
+
+  ++m_NMergeWindowSamples;
+  m_MergeWindowSum += NEvents;
+  if (NEvents > m_MergeWindowMax) m_MergeWindowMax = NEvents;
+  m_MergeWindowLast = NEvents;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+uint64_t MBinaryFlightDataParserStatistics::GetNPackets() const
+{
+  //! Return the number of packets of all types
+
+  uint64_t N = 0;
+  for (unsigned int t = 0; t < c_NTypes; ++t) N += m_NPackets[t];
+  return N;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+uint64_t MBinaryFlightDataParserStatistics::GetNParseErrors() const
+{
+  //! Return the number of packets of all types which could not be parsed
+
+  uint64_t N = 0;
+  for (unsigned int t = 0; t < c_NTypes; ++t) N += m_NParseErrors[t];
+  return N;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+uint64_t MBinaryFlightDataParserStatistics::GetNOtherPackets() const
+{
+  //! Return the number of packets of types the parser does not handle
+
+  uint64_t N = 0;
+  for (unsigned int t = 0; t < c_NTypes; ++t) {
+    if (t == 0x00 || t == 0x01 || t == 0x05 || t == 0x06 || t == 0x07 || t == 0x0b) continue;
+    N += m_NPackets[t];
+  }
+  return N;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MString MBinaryFlightDataParserStatistics::GetTypeName(uint8_t Type)
+{
+  //! Return the name of the packet type
+
+  switch (Type & c_TypeMask) {
+  case 0x00:
+    return "Raw";
+  case 0x01:
+    return "Compton";
+  case 0x05:
+    return "Aspect";
+  case 0x06:
+    return "Livetime";
+  case 0x07:
+    return "GCUHousekeeping";
+  case 0x0b:
+    return "Settings";
+  default:
+    break;
+  }
+
+  MString Name("Type");
+  Name += (int) (Type & c_TypeMask);
+  return Name;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataParserStatistics::StreamJson(ostream& out, double Time) const
+{
+  //! Stream the statistics as one line of JSON with the given time stamp in seconds
+
+  out<<setprecision(9);
+  out<<"{\"Time\": "<<Time;
+  out<<", \"BytesReceived\": "<<m_NBytesReceived;
+  out<<", \"LostBytes\": "<<m_NLostBytes;
+  out<<", \"Resyncs\": "<<m_NResyncs;
+  out<<", \"Duplicates\": "<<m_NDuplicates;
+  out<<", \"ParseErrors\": "<<GetNParseErrors();
+  out<<", \"EventsEmitted\": "<<m_NEventsEmitted;
+  out<<", \"LateEvents\": "<<m_NLateEvents;
+  out<<", \"MergeWindow\": {\"Last\": "<<m_MergeWindowLast<<", \"Mean\": "<<GetMeanMergeWindowOccupancy()<<", \"Max\": "<<m_MergeWindowMax<<"}";
+  out<<", \"Packets\": {";
+  bool First = true;
+  for (unsigned int t = 0; t < c_NTypes; ++t) {
+    if (m_NPackets[t] == 0 && m_NParseErrors[t] == 0) continue;
+    if (First == false) out<<", ";
+    First = false;
+    out<<"\""<<GetTypeName(t)<<"\": {\"Count\": "<<m_NPackets[t]<<", \"Bytes\": "<<m_NPacketBytes[t]
+       <<", \"ParseErrors\": "<<m_NParseErrors[t]<<", \"ParseTime\": "<<1E-9*m_ParseTime[t]<<"}";
+  }
+  out<<"}}"<<endl;
+}
+
+
+// MBinaryFlightDataParserStatistics.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
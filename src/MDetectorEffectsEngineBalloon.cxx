@@ -63,6 +63,7 @@ using namespace std;
 // Nuclearizer
 #include "MDetectorEffectsEngineBalloon.h"
 #include "MDepthCalibrator.h"
+#include "MObjectPool.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1551,7 +1552,7 @@ bool MDetectorEffectsEngineBalloon::GetNextEvent(MReadOutAssembly* Event)
         Event->AddSimIA(*IAs[i]);
       }
       for (MDEEStripHit Hit: MergedStripHits){
-        MStripHit* SH = new MStripHit();
+        MStripHit* SH = MObjectPool<MStripHit>::Get();
         SH->SetDetectorID(Hit.m_ROE.GetDetectorID());
         SH->SetStripID(Hit.m_ROE.GetStripID());
         SH->IsXStrip(Hit.m_ROE.IsPositiveStrip());
@@ -0,0 +1,164 @@
+/*
+ * MDuplicatePacketFilter.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MDuplicatePacketFilter
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MDuplicatePacketFilter.h"
+
+// Standard libs:
+#include <algorithm>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+
+// Nuclearizer libs:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MDuplicatePacketFilter)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MDuplicatePacketFilter::MDuplicatePacketFilter(unsigned int Capacity)
+{
+  // Construct an instance of MDuplicatePacketFilter
+
+  if (Capacity == 0) Capacity = 1;
+
+  // Keep the load factor at or below 50% so that the probe sequences stay short
+  size_t Slots = 2;
+  m_Shift = 63;
+  while (Slots < 2*size_t(Capacity)) {
+    Slots <<= 1;
+    --m_Shift;
+  }
+  m_Table.resize(Slots, 0);
+  m_Mask = Slots - 1;
+  m_Order.resize(Capacity, 0);
+
+  Clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MDuplicatePacketFilter::~MDuplicatePacketFilter()
+{
+  // Delete this instance of MDuplicatePacketFilter
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MDuplicatePacketFilter::Clear()
+{
+  //! Forget all keys and reset the counters
+
+  fill(m_Table.begin(), m_Table.end(), 0);
+  m_Oldest = 0;
+  m_Size = 0;
+  m_NHits = 0;
+  m_NMisses = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MDuplicatePacketFilter::IsDuplicate(uint64_t Key)
+{
+  //! Return true if the key is among the remembered ones (a duplicate), otherwise remember it
+
+  uint64_t Value = Key + 1;
+
+  size_t Slot = GetSlot(Value);
+  while (m_Table[Slot] != 0) {
+    if (m_Table[Slot] == Value) {
+      ++m_NHits;
+      return true;
+    }
+    Slot = (Slot + 1) & m_Mask;
+  }
+  ++m_NMisses;
+
+  // Make room by forgetting the oldest key - the slot found above stays valid,
+  // since removing keeps every other value reachable from its home slot
+  if (m_Size == m_Order.size()) {
+    Remove(m_Order[m_Oldest]);
+    m_Oldest = (m_Oldest + 1) % m_Order.size();
+    --m_Size;
+    Slot = GetSlot(Value);
+    while (m_Table[Slot] != 0) Slot = (Slot + 1) & m_Mask;
+  }
+
+  m_Table[Slot] = Value;
+  m_Order[(m_Oldest + m_Size) % m_Order.size()] = Value;
+  ++m_Size;
+
+  return false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MDuplicatePacketFilter::Remove(uint64_t Value)
+{
+  //! Remove a stored value from the hash table, keeping the probe sequences intact
+
+  size_t Slot = GetSlot(Value);
+  while (m_Table[Slot] != Value) {
+    if (m_Table[Slot] == 0) return;
+    Slot = (Slot + 1) & m_Mask;
+  }
+
+  // Backward-shift deletion: move later values of the cluster into the hole
+  // unless their home slot lies cyclically between the hole and their position
+  size_t Hole = Slot;
+  size_t Next = Slot;
+  while (true) {
+    Next = (Next + 1) & m_Mask;
+    if (m_Table[Next] == 0) break;
+    size_t Home = GetSlot(m_Table[Next]);
+    if (((Next - Home) & m_Mask) >= ((Next - Hole) & m_Mask)) {
+      m_Table[Hole] = m_Table[Next];
+      Hole = Next;
+    }
+  }
+  m_Table[Hole] = 0;
+}
+
+
+// MDuplicatePacketFilter.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,214 @@
+/*
+ * MEventStreamMerger.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MEventStreamMerger
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MEventStreamMerger.h"
+
+// Standard libs:
+#include <algorithm>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+
+// Nuclearizer libs:
+#include "MObjectPool.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MEventStreamMerger)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MEventStreamMerger::MEventStreamMerger(unsigned int NStreams) : m_NEvents(0), m_NewestCL(0), m_NLateEvents(0)
+{
+  // Construct an instance of MEventStreamMerger
+
+  m_Streams.resize(NStreams);
+  m_HeapPosition.resize(NStreams, -1);
+  m_Heap.reserve(NStreams);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MEventStreamMerger::~MEventStreamMerger()
+{
+  // Delete this instance of MEventStreamMerger
+
+  Clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MEventStreamMerger::Add(MReadOutAssembly* Event, unsigned int Stream)
+{
+  //! Add an event to the given stream
+
+  if (Stream >= m_Streams.size()) {
+    m_Streams.resize(Stream + 1);
+    m_HeapPosition.resize(Stream + 1, -1);
+  }
+
+  deque<MReadOutAssembly*>& Queue = m_Streams[Stream];
+  uint64_t CL = Event->GetCL();
+
+  if (Queue.empty() == true || Queue.back()->GetCL() <= CL) {
+    Queue.push_back(Event);
+  } else {
+    // A late event: usually only a few steps away from the back
+    ++m_NLateEvents;
+    deque<MReadOutAssembly*>::iterator I = Queue.end();
+    unsigned int Steps = 0;
+    while (I != Queue.begin() && (*(I - 1))->GetCL() > CL && Steps < c_InsertionWindow) {
+      --I;
+      ++Steps;
+    }
+    if (I != Queue.begin() && (*(I - 1))->GetCL() > CL) {
+      I = upper_bound(Queue.begin(), I, Event, [](MReadOutAssembly* A, MReadOutAssembly* B) { return A->GetCL() < B->GetCL(); });
+    }
+    Queue.insert(I, Event);
+  }
+
+  if (m_NEvents == 0 || CL > m_NewestCL) m_NewestCL = CL;
+  ++m_NEvents;
+
+  if (m_HeapPosition[Stream] < 0) {
+    m_Heap.push_back(Stream);
+    m_HeapPosition[Stream] = m_Heap.size() - 1;
+    SiftUp(m_Heap.size() - 1);
+  } else if (Queue.front() == Event) {
+    // The oldest event of this stream changed to an older one
+    SiftUp(m_HeapPosition[Stream]);
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MReadOutAssembly* MEventStreamMerger::PopOldest()
+{
+  //! Remove and return the oldest event of all streams (nullptr if there is none)
+
+  if (m_Heap.empty() == true) return nullptr;
+
+  unsigned int Stream = m_Heap[0];
+  MReadOutAssembly* Event = m_Streams[Stream].front();
+  m_Streams[Stream].pop_front();
+  --m_NEvents;
+
+  if (m_Streams[Stream].empty() == true) {
+    Swap(0, m_Heap.size() - 1);
+    m_Heap.pop_back();
+    m_HeapPosition[Stream] = -1;
+  }
+  if (m_Heap.empty() == false) SiftDown(0);
+
+  return Event;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MEventStreamMerger::Clear()
+{
+  //! Release all events back to the object pool
+
+  for (auto& Queue: m_Streams) {
+    for (auto E: Queue) {
+      MObjectPool<MReadOutAssembly>::Release(E);
+    }
+    Queue.clear();
+  }
+  m_Heap.clear();
+  fill(m_HeapPosition.begin(), m_HeapPosition.end(), -1);
+  m_NEvents = 0;
+  m_NewestCL = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MEventStreamMerger::SiftUp(size_t i)
+{
+  //! Move the heap element at position i up until the heap is valid again
+
+  while (i > 0) {
+    size_t Parent = (i - 1)/2;
+    if (GetKey(m_Heap[i]) >= GetKey(m_Heap[Parent])) break;
+    Swap(i, Parent);
+    i = Parent;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MEventStreamMerger::SiftDown(size_t i)
+{
+  //! Move the heap element at position i down until the heap is valid again
+
+  while (true) {
+    size_t Smallest = i;
+    size_t Left = 2*i + 1;
+    size_t Right = 2*i + 2;
+    if (Left < m_Heap.size() && GetKey(m_Heap[Left]) < GetKey(m_Heap[Smallest])) Smallest = Left;
+    if (Right < m_Heap.size() && GetKey(m_Heap[Right]) < GetKey(m_Heap[Smallest])) Smallest = Right;
+    if (Smallest == i) break;
+    Swap(i, Smallest);
+    i = Smallest;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MEventStreamMerger::Swap(size_t i, size_t j)
+{
+  //! Swap two heap elements
+
+  swap(m_Heap[i], m_Heap[j]);
+  m_HeapPosition[m_Heap[i]] = i;
+  m_HeapPosition[m_Heap[j]] = j;
+}
+
+
+// MEventStreamMerger.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
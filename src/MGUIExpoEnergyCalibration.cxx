@@ -121,6 +121,23 @@ void MGUIExpoEnergyCalibration::AddEnergy(double Energy)
 ////////////////////////////////////////////////////////////////////////////////
 
 
+void MGUIExpoEnergyCalibration::AddEnergies(const vector<double>& Energies)
+{
+  // Add many energies to the energy histogram with one lock
+
+  m_Mutex.Lock();
+
+  for (double Energy: Energies) {
+    m_Energy->Fill(Energy);
+  }
+  
+  m_Mutex.UnLock();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
 void MGUIExpoEnergyCalibration::Export(const MString& FileName)
 {
   // Add data to the energy histogram
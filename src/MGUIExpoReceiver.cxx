@@ -44,6 +44,12 @@ ClassImp(MGUIExpoReceiver)
 ////////////////////////////////////////////////////////////////////////////////
 
 
+const uint8_t MGUIExpoReceiver::c_PacketTypes[6] = { 0x00, 0x01, 0x05, 0x06, 0x07, 0x0b };
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
 MGUIExpoReceiver::MGUIExpoReceiver(MModule* Module) : MGUIExpo(Module)
 {
   // standard constructor
@@ -52,11 +58,13 @@ MGUIExpoReceiver::MGUIExpoReceiver(MModule* Module) : MGUIExpo(Module)
   m_TabTitle = "Receiver";
   
   m_TimeReceived.Set(0);
-  m_BytesReceived = 0;
-  m_RawFramesParsed = 0;
-  m_ComptonFramesParsed = 0;
-  m_AspectFramesParsed = 0;
-  m_OtherFramesParsed = 0;
+  m_Statistics.Clear();
+  m_LastStatistics.Clear();
+  m_QueueSize = 0;
+  m_QueueMaxSize = 0;
+  m_QueueCapacity = 0;
+  m_QueueNFull = 0;
+  m_QueueStallTime = 0;
   
   // use hierarchical cleaning
   SetCleanup(kDeepCleanup);
@@ -81,11 +89,14 @@ void MGUIExpoReceiver::Reset()
 
   m_Mutex.Lock();
   m_TimeReceived.Set(0);
-  m_BytesReceived = 0;
-  m_RawFramesParsed = 0;
-  m_ComptonFramesParsed = 0;
-  m_AspectFramesParsed = 0;
-  m_OtherFramesParsed = 0;
+  m_Statistics.Clear();
+  m_LastStatistics.Clear();
+  m_UpdateTimer.Start();
+  m_QueueSize = 0;
+  m_QueueMaxSize = 0;
+  m_QueueCapacity = 0;
+  m_QueueNFull = 0;
+  m_QueueStallTime = 0;
   m_Mutex.UnLock();
 }
 
@@ -93,19 +104,6 @@ void MGUIExpoReceiver::Reset()
 ////////////////////////////////////////////////////////////////////////////////
 
 
-void MGUIExpoReceiver::SetBytesReceived(long Bytes) 
-{ 
-  //! Set the amount of data received
-  
-  m_Mutex.Lock();
-  m_BytesReceived = Bytes; 
-  m_Mutex.UnLock();  
-}
-  
-
-////////////////////////////////////////////////////////////////////////////////
-
-
 void MGUIExpoReceiver::SetTimeReceived(MTime Time) 
 { 
   // Set the time the last event was received
@@ -119,12 +117,16 @@ void MGUIExpoReceiver::SetTimeReceived(MTime Time)
 ////////////////////////////////////////////////////////////////////////////////
 
 
-void MGUIExpoReceiver::SetRawFramesParsed(long Frames)
+void MGUIExpoReceiver::SetStatistics(const MBinaryFlightDataParserStatistics& Statistics)
 {
-  //! Set the number of raw data frames received
+  //! Set the current parser statistics
 
   m_Mutex.Lock();
-  m_RawFramesParsed = Frames;
+  // the parser was re-initialized: restart the rates
+  if (Statistics.GetNBytesReceived() < m_Statistics.GetNBytesReceived()) {
+    m_LastStatistics.Clear();
+  }
+  m_Statistics = Statistics;
   m_Mutex.UnLock();   
 }
 
@@ -132,12 +134,16 @@ void MGUIExpoReceiver::SetRawFramesParsed(long Frames)
 ////////////////////////////////////////////////////////////////////////////////
 
 
-void MGUIExpoReceiver::SetComptonFramesParsed(long Frames)
+void MGUIExpoReceiver::SetReceiveQueue(uint64_t Size, uint64_t MaxSize, uint64_t Capacity, uint64_t NFull, double StallTime)
 {
-  //! Set the number of Compton data frames received
+  //! Set the state of the queue between receive thread and parser
 
   m_Mutex.Lock();
-  m_ComptonFramesParsed = Frames;
+  m_QueueSize = Size;
+  m_QueueMaxSize = MaxSize;
+  m_QueueCapacity = Capacity;
+  m_QueueNFull = NFull;
+  m_QueueStallTime = StallTime;
   m_Mutex.UnLock();   
 }
 
@@ -145,26 +151,16 @@ void MGUIExpoReceiver::SetComptonFramesParsed(long Frames)
 ////////////////////////////////////////////////////////////////////////////////
 
 
-void MGUIExpoReceiver::SetAspectFramesParsed(long Frames)
+TGLabel* MGUIExpoReceiver::CreateRow(TGCompositeFrame* Frame, const MString& Description)
 {
-  //! Set the number of aspect data frames received
+  //! Create one row of the matrix: a description and a label showing the value
 
-  m_Mutex.Lock();
-  m_AspectFramesParsed = Frames;
-  m_Mutex.UnLock();   
-}
+  TGLabel* TextLabel = new TGLabel(Frame, Description);
+  Frame->AddFrame(TextLabel);
+  TGLabel* ValueLabel = new TGLabel(Frame, "                              0                              ");
+  Frame->AddFrame(ValueLabel);
 
-
-////////////////////////////////////////////////////////////////////////////////
-
-
-void MGUIExpoReceiver::SetOtherFramesParsed(long Frames)
-{
-  //! Set thenumber of other data frames received
-
-  m_Mutex.Lock();
-  m_OtherFramesParsed = Frames;
-  m_Mutex.UnLock();   
+  return ValueLabel;
 }
 
 
@@ -187,7 +183,7 @@ void MGUIExpoReceiver::Create()
   AddFrame(ModuleFrame, ModuleFrameLayout);
 
 
-  ModuleFrame->SetLayoutManager(new TGMatrixLayout(ModuleFrame, 6, 2, 5));
+  ModuleFrame->SetLayoutManager(new TGMatrixLayout(ModuleFrame, 16, 2, 5));
   
   TGLabel* TimeTextLabel = new TGLabel(ModuleFrame, "Time last data was received: ");
   ModuleFrame->AddFrame(TimeTextLabel);
@@ -195,36 +191,19 @@ void MGUIExpoReceiver::Create()
   //m_TimeLabel->ChangeOptions(kSunkenFrame);
   ModuleFrame->AddFrame(m_TimeLabel);
 
-  TGLabel* BytesReceivedTextLabel = new TGLabel(ModuleFrame, "Bytes received: ");
-  ModuleFrame->AddFrame(BytesReceivedTextLabel);
-  m_BytesReceivedLabel = new TGLabel(ModuleFrame, "                              0                              ");
-  //m_BytesReceivedLabel->ChangeOptions(kSunkenFrame);
-  ModuleFrame->AddFrame(m_BytesReceivedLabel);
-
-  TGLabel* RawFramesTextLabel = new TGLabel(ModuleFrame, "Raw frames parsed: ");
-  ModuleFrame->AddFrame(RawFramesTextLabel);
-  m_RawFramesLabel = new TGLabel(ModuleFrame, "                              0                              ");
-  //m_RawFramesLabel->ChangeOptions(kSunkenFrame);
-  ModuleFrame->AddFrame(m_RawFramesLabel);
-
-  TGLabel* ComptonFramesTextLabel = new TGLabel(ModuleFrame, "Compton frames parsed: ");
-  ModuleFrame->AddFrame(ComptonFramesTextLabel);
-  m_ComptonFramesLabel = new TGLabel(ModuleFrame, "                              0                              ");
-  //m_ComptonFramesLabel->ChangeOptions(kSunkenFrame);
-  ModuleFrame->AddFrame(m_ComptonFramesLabel);
-
-  TGLabel* AspectFramesTextLabel = new TGLabel(ModuleFrame, "Aspect frames parsed: ");
-  ModuleFrame->AddFrame(AspectFramesTextLabel);
-  m_AspectFramesLabel = new TGLabel(ModuleFrame, "                              0                              ");
-  //m_AspectFramesLabel->ChangeOptions(kSunkenFrame);
-  ModuleFrame->AddFrame(m_AspectFramesLabel);
-
-  TGLabel* OtherFramesTextLabel = new TGLabel(ModuleFrame, "Other frames parsed: ");
-  ModuleFrame->AddFrame(OtherFramesTextLabel);
-  m_OtherFramesLabel = new TGLabel(ModuleFrame, "                              0                              ");
-  //m_OtherFramesLabel->ChangeOptions(kSunkenFrame);
-  ModuleFrame->AddFrame(m_OtherFramesLabel);
+  m_BytesReceivedLabel = CreateRow(ModuleFrame, "Bytes received: ");
+  m_ReceiveQueueLabel = CreateRow(ModuleFrame, "Receive queue (max, full, waited): ");
+  m_LostBytesLabel = CreateRow(ModuleFrame, "Bytes lost (resyncs): ");
+  m_DuplicatesLabel = CreateRow(ModuleFrame, "Duplicate packets: ");
+  m_ParseErrorsLabel = CreateRow(ModuleFrame, "Parse errors: ");
+  m_EventsEmittedLabel = CreateRow(ModuleFrame, "Events emitted: ");
+  m_MergeWindowLabel = CreateRow(ModuleFrame, "Events in merge window (mean, max): ");
+  for (unsigned int t = 0; t < 6; ++t) {
+    m_PacketLabels[t] = CreateRow(ModuleFrame, MBinaryFlightDataParserStatistics::GetTypeName(c_PacketTypes[t]) + " packets parsed: ");
+  }
+  m_OtherPacketsLabel = CreateRow(ModuleFrame, "Other packets parsed: ");
   
+  m_UpdateTimer.Start();
   
   m_IsCreated = true;
 
@@ -244,25 +223,80 @@ void MGUIExpoReceiver::Update()
   if (m_IsCreated == true) {
     m_TimeLabel->SetText(m_TimeReceived.GetUTCString());
 
+    double Elapsed = m_UpdateTimer.GetElapsed();
+    if (Elapsed <= 0) Elapsed = 1;
+
     MString Text;
-    Text += m_BytesReceived;
+    Text += (unsigned long) m_Statistics.GetNBytesReceived();
+    Text += " (";
+    Text += (m_Statistics.GetNBytesReceived() - m_LastStatistics.GetNBytesReceived())/Elapsed/1024;
+    Text += " kB/s)";
     m_BytesReceivedLabel->SetText(Text);
 
     Text.Clear();
-    Text += m_RawFramesParsed;
-    m_RawFramesLabel->SetText(Text);
+    Text += (unsigned long) m_QueueSize;
+    Text += "/";
+    Text += (unsigned long) m_QueueCapacity;
+    Text += " (";
+    Text += (unsigned long) m_QueueMaxSize;
+    Text += ", ";
+    Text += (unsigned long) m_QueueNFull;
+    Text += "x, ";
+    Text += m_QueueStallTime;
+    Text += " s)";
+    m_ReceiveQueueLabel->SetText(Text);
+
+    Text.Clear();
+    Text += (unsigned long) m_Statistics.GetNLostBytes();
+    Text += " (";
+    Text += (unsigned long) m_Statistics.GetNResyncs();
+    Text += ")";
+    m_LostBytesLabel->SetText(Text);
+
+    Text.Clear();
+    Text += (unsigned long) m_Statistics.GetNDuplicates();
+    m_DuplicatesLabel->SetText(Text);
+
+    Text.Clear();
+    Text += (unsigned long) m_Statistics.GetNParseErrors();
+    m_ParseErrorsLabel->SetText(Text);
 
     Text.Clear();
-    Text += m_ComptonFramesParsed;
-    m_ComptonFramesLabel->SetText(Text);
+    Text += (unsigned long) m_Statistics.GetNEventsEmitted();
+    Text += " (";
+    Text += (m_Statistics.GetNEventsEmitted() - m_LastStatistics.GetNEventsEmitted())/Elapsed;
+    Text += " /s)";
+    m_EventsEmittedLabel->SetText(Text);
 
     Text.Clear();
-    Text += m_AspectFramesParsed;
-    m_AspectFramesLabel->SetText(Text);
+    Text += (unsigned long) m_Statistics.GetMergeWindowOccupancy();
+    Text += " (";
+    Text += m_Statistics.GetMeanMergeWindowOccupancy();
+    Text += ", ";
+    Text += (unsigned long) m_Statistics.GetMaxMergeWindowOccupancy();
+    Text += ")";
+    m_MergeWindowLabel->SetText(Text);
+
+    // Count, rate and mean parse time per packet
+    for (unsigned int t = 0; t < 6; ++t) {
+      uint8_t Type = c_PacketTypes[t];
+      uint64_t NPackets = m_Statistics.GetNPackets(Type);
+      Text.Clear();
+      Text += (unsigned long) NPackets;
+      Text += " (";
+      Text += (NPackets - m_LastStatistics.GetNPackets(Type))/Elapsed;
+      Text += " /s, ";
+      Text += (NPackets > 0) ? 1E-3*m_Statistics.GetParseTime(Type)/NPackets : 0.0;
+      Text += " us/packet)";
+      m_PacketLabels[t]->SetText(Text);
+    }
 
     Text.Clear();
-    Text += m_OtherFramesParsed;
-    m_OtherFramesLabel->SetText(Text);    
+    Text += (unsigned long) m_Statistics.GetNOtherPackets();
+    m_OtherPacketsLabel->SetText(Text);
+
+    m_LastStatistics = m_Statistics;
+    m_UpdateTimer.Start();
   }
   
   m_Mutex.UnLock();
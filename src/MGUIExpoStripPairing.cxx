@@ -122,6 +122,23 @@ void MGUIExpoStripPairing::AddEnergies(double pEnergy, double nEnergy)
 ////////////////////////////////////////////////////////////////////////////////
 
 
+void MGUIExpoStripPairing::AddEnergies(const vector<double>& pEnergies, const vector<double>& nEnergies)
+{
+  // Add many energy pairs to the energy histogram with one lock
+
+  m_Mutex.Lock();
+  
+  for (unsigned int i = 0; i < pEnergies.size() && i < nEnergies.size(); ++i) {
+    m_Energies->Fill(pEnergies[i], nEnergies[i]);
+  }
+  
+  m_Mutex.UnLock();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
 void MGUIExpoStripPairing::Create()
 {
   // Add the GUI options here
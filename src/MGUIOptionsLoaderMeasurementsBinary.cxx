@@ -97,6 +97,30 @@ void MGUIOptionsLoaderMeasurementsBinary::Create()
   m_CoincidenceMode->Create();
   m_OptionsFrame->AddFrame(m_CoincidenceMode, LabelLayout);
 
+  m_DecodeThreads = new MGUIEEntry(m_OptionsFrame, "Number of threads decoding dataframes (0: none, decode while parsing):", false,
+    dynamic_cast<MModuleLoaderMeasurementsBinary*>(m_Module)->GetNDecodeThreads(), true, 0l, 64l);
+  m_OptionsFrame->AddFrame(m_DecodeThreads, LabelLayout);
+
+  m_StartTime = new MGUIEEntry(m_OptionsFrame, "Start of the time range to read as Unix time (0: from the beginning):", false,
+    (long) dynamic_cast<MModuleLoaderMeasurementsBinary*>(m_Module)->GetStartTime(), true, 0l);
+  m_OptionsFrame->AddFrame(m_StartTime, LabelLayout);
+
+  m_StopTime = new MGUIEEntry(m_OptionsFrame, "Stop of the time range to read as Unix time (0: to the end):", false,
+    (long) dynamic_cast<MModuleLoaderMeasurementsBinary*>(m_Module)->GetStopTime(), true, 0l);
+  m_OptionsFrame->AddFrame(m_StopTime, LabelLayout);
+
+  m_WarmUpTime = new MGUIEEntry(m_OptionsFrame, "Seconds read before the time range to build up aspect and coincidence state:", false,
+    (long) dynamic_cast<MModuleLoaderMeasurementsBinary*>(m_Module)->GetWarmUpTime(), true, 0l);
+  m_OptionsFrame->AddFrame(m_WarmUpTime, LabelLayout);
+
+  m_ReadFilesConcurrently = new TGCheckButton(m_OptionsFrame, "Read the files of a file list concurrently and merge them by clock", 1);
+  m_ReadFilesConcurrently->SetOn(dynamic_cast<MModuleLoaderMeasurementsBinary*>(m_Module)->GetReadFilesConcurrently());
+  m_OptionsFrame->AddFrame(m_ReadFilesConcurrently, LabelLayout);
+
+  m_BinaryHousekeeping = new TGCheckButton(m_OptionsFrame, "Write the housekeeping as binary columnar file (.hkb) instead of text (.hkp)", 2);
+  m_BinaryHousekeeping->SetOn(dynamic_cast<MModuleLoaderMeasurementsBinary*>(m_Module)->GetBinaryHousekeeping());
+  m_OptionsFrame->AddFrame(m_BinaryHousekeeping, LabelLayout);
+
 
 
   PostCreate();
@@ -169,6 +193,13 @@ bool MGUIOptionsLoaderMeasurementsBinary::OnApply()
 	  dynamic_cast<MModuleLoaderMeasurementsBinary*>(m_Module)->EnableCoincidenceMerging(true);
   }
 
+  dynamic_cast<MModuleLoaderMeasurementsBinary*>(m_Module)->SetNDecodeThreads(m_DecodeThreads->GetAsInt());
+  dynamic_cast<MModuleLoaderMeasurementsBinary*>(m_Module)->SetStartTime(m_StartTime->GetAsInt());
+  dynamic_cast<MModuleLoaderMeasurementsBinary*>(m_Module)->SetStopTime(m_StopTime->GetAsInt());
+  dynamic_cast<MModuleLoaderMeasurementsBinary*>(m_Module)->SetWarmUpTime(m_WarmUpTime->GetAsInt());
+  dynamic_cast<MModuleLoaderMeasurementsBinary*>(m_Module)->SetReadFilesConcurrently(m_ReadFilesConcurrently->IsOn());
+  dynamic_cast<MModuleLoaderMeasurementsBinary*>(m_Module)->SetBinaryHousekeeping(m_BinaryHousekeeping->IsOn());
+
 
 	return true;
 }
@@ -119,6 +119,15 @@ void MGUIOptionsReceiverBalloon::Create()
   m_FileSelector->SetFileType("Read-out file", "*.roa");
   m_OptionsFrame->AddFrame(m_FileSelector, ContentLayout);
 
+  m_MetricsFileSelector = new MGUIEFileSelector(m_OptionsFrame, "If a file is selected, then the parser statistics are periodically written to it:",
+  dynamic_cast<MModuleReceiverBalloon*>(m_Module)->GetMetricsFileName());
+  m_MetricsFileSelector->SetFileType("Metrics file", "*.json");
+  m_OptionsFrame->AddFrame(m_MetricsFileSelector, ContentLayout);
+
+  m_MetricsInterval = new MGUIEEntry(m_OptionsFrame, "Interval between two metrics entries [s]: ", false,
+                              dynamic_cast<MModuleReceiverBalloon*>(m_Module)->GetMetricsInterval());
+  m_OptionsFrame->AddFrame(m_MetricsInterval, ContentLayout);
+
   
   
   PostCreate();
@@ -187,6 +196,8 @@ bool MGUIOptionsReceiverBalloon::OnApply()
   }
   
   dynamic_cast<MModuleReceiverBalloon*>(m_Module)->SetRoaFileName(m_FileSelector->GetFileName());  
+  dynamic_cast<MModuleReceiverBalloon*>(m_Module)->SetMetricsFileName(m_MetricsFileSelector->GetFileName());
+  dynamic_cast<MModuleReceiverBalloon*>(m_Module)->SetMetricsInterval(m_MetricsInterval->GetAsDouble());
   
   return true;
 }
@@ -0,0 +1,215 @@
+/*
+ * MGzipBlockReader.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MGzipBlockReader
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MGzipBlockReader.h"
+
+// Standard libs:
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MStreams.h"
+
+// Nuclearizer libs:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MGzipBlockReader)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+const size_t MGzipBlockReader::c_BlockSize;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MGzipBlockReader::MGzipBlockReader() : m_File(NULL), m_NProduced(0), m_NConsumed(0), m_IsHandedOut(false), m_IsEndOfFile(false), m_HasError(false), m_Stop(false)
+{
+  // Construct an instance of MGzipBlockReader
+
+  m_BlockSizes[0] = 0;
+  m_BlockSizes[1] = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MGzipBlockReader::~MGzipBlockReader()
+{
+  // Delete this instance of MGzipBlockReader
+
+  Close();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MGzipBlockReader::Open(const MString& FileName)
+{
+  //! Open the file and start the inflate thread, return false on error
+
+  Close();
+
+  m_File = gzopen(FileName.Data(), "rb");
+  if (m_File == NULL) return false;
+
+  // A larger internal buffer means fewer, larger reads of the compressed data
+  gzbuffer(m_File, 256*1024);
+
+  for (unsigned int b = 0; b < 2; ++b) {
+    if (m_Blocks[b].size() != c_BlockSize) m_Blocks[b].resize(c_BlockSize);
+    m_BlockSizes[b] = 0;
+  }
+  m_NProduced = 0;
+  m_NConsumed = 0;
+  m_IsHandedOut = false;
+  m_IsEndOfFile = false;
+  m_HasError = false;
+  m_Stop = false;
+
+  m_Thread = thread(&MGzipBlockReader::Inflate, this);
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MGzipBlockReader::Close()
+{
+  //! Stop the inflate thread and close the file
+
+  if (m_Thread.joinable() == true) {
+    {
+      lock_guard<mutex> Lock(m_Mutex);
+      m_Stop = true;
+    }
+    m_Condition.notify_all();
+    m_Thread.join();
+  }
+
+  if (m_File != NULL) {
+    gzclose(m_File);
+    m_File = NULL;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+size_t MGzipBlockReader::Read(const uint8_t*& Data)
+{
+  //! Return the next decompressed block in Data and its size, 0 at the end of the file or on error
+
+  Data = nullptr;
+
+  unique_lock<mutex> Lock(m_Mutex);
+
+  // Give the previous block back to the inflate thread
+  if (m_IsHandedOut == true) {
+    ++m_NConsumed;
+    m_IsHandedOut = false;
+    m_Condition.notify_all();
+  }
+
+  m_Condition.wait(Lock, [this] { return m_NProduced > m_NConsumed || m_IsEndOfFile == true || m_Thread.joinable() == false; });
+  if (m_NProduced == m_NConsumed) return 0;
+
+  unsigned int b = m_NConsumed % 2;
+  m_IsHandedOut = true;
+  Data = m_Blocks[b].data();
+
+  return m_BlockSizes[b];
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MGzipBlockReader::HasError() const
+{
+  //! Return true if decompression failed (e.g. a truncated or corrupt file)
+
+  lock_guard<mutex> Lock(m_Mutex);
+
+  return m_HasError;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MGzipBlockReader::Inflate()
+{
+  //! The inflate thread: fill the free block until the end of the file
+
+  while (true) {
+    unsigned int b = 0;
+    {
+      unique_lock<mutex> Lock(m_Mutex);
+      // Both blocks are in use when the reader holds one and the other one is filled
+      m_Condition.wait(Lock, [this] { return m_NProduced - m_NConsumed < 2 || m_Stop == true; });
+      if (m_Stop == true) break;
+      b = m_NProduced % 2;
+    }
+
+    // This block is neither handed out nor waiting to be read, so we can fill it without the lock
+    int Read = gzread(m_File, m_Blocks[b].data(), c_BlockSize);
+
+    lock_guard<mutex> Lock(m_Mutex);
+    if (Read <= 0) {
+      // A truncated file ends without a negative return value but with Z_BUF_ERROR
+      int ErrorNumber = Z_OK;
+      const char* Error = gzerror(m_File, &ErrorNumber);
+      if (Read < 0 || ErrorNumber != Z_OK) {
+        if (g_Verbosity >= c_Error) cout<<"Gzip block reader: Error: Decompression failed: "<<Error<<endl;
+        m_HasError = true;
+      }
+      m_IsEndOfFile = true;
+      m_Condition.notify_all();
+      break;
+    }
+    m_BlockSizes[b] = Read;
+    ++m_NProduced;
+    m_Condition.notify_all();
+  }
+}
+
+
+// MGzipBlockReader.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
@@ -75,6 +75,15 @@ void MHit::Clear()
   m_Energy = g_DoubleNotDefined;
   m_PositionResolution = g_VectorNotDefined;
   m_EnergyResolution = g_DoubleNotDefined;
+  m_HitQuality = 0;
+
+  m_PossibleCrossTalk = false;
+  m_PossibleChargeLoss = false;
+  m_StripHitMultipleTimesX = false;
+  m_StripHitMultipleTimesY = false;
+  m_ChargeSharing = false;
+  m_NoDepth = false;
+  m_IsNonDominantNeighborStrip = false;
 
   m_StripHits.clear();
   m_Origins.clear();
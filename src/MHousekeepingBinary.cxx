@@ -0,0 +1,144 @@
+/*
+ * MHousekeepingBinary.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MHousekeepingBinary
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MHousekeepingBinary.h"
+
+// Standard libs:
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MTime.h"
+
+// Nuclearizer libs:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MHousekeepingBinary)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+const char MHousekeepingBinary::c_Magic[8] = { 'N', 'H', 'K', 'P', 'B', 'I', 'N', '1' };
+const uint8_t MHousekeepingBinary::c_EndOfGroup;
+const uint8_t MHousekeepingBinary::c_Aspect;
+const uint8_t MHousekeepingBinary::c_Livetime;
+const uint8_t MHousekeepingBinary::c_GCUHousekeeping;
+const unsigned int MHousekeepingBinary::c_BlockHeaderSize;
+const unsigned int MHousekeepingBinary::c_AspectSize;
+const unsigned int MHousekeepingBinary::c_LivetimeSize;
+const unsigned int MHousekeepingBinary::c_GCUHousekeepingSize;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MHousekeepingBinary::MHousekeepingBinary()
+{
+  // Construct an instance of MHousekeepingBinary
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MHousekeepingBinary::~MHousekeepingBinary()
+{
+  // Delete this instance of MHousekeepingBinary
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MHousekeepingBinary::WriteText(ostream& out, const aspect& A)
+{
+  //! Write the record in the text form of the ".hkp" files
+
+  out<<"ASP\nTI "<<MTime((unsigned int) A.Seconds, (unsigned int) A.NanoSeconds)<<"\nMD "<<A.Mode
+     <<"\nGX "<<A.GXLongitude<<" "<<A.GXLatitude<<"\nGZ "<<A.GZLongitude<<" "<<A.GZLatitude
+     <<"\nCO "<<A.Latitude<<" "<<A.Longitude<<" "<<A.Altitude<<"\nGPS "<<A.Heading<<" "<<A.Pitch<<" "<<A.Roll<<"\n\n";
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MHousekeepingBinary::WriteText(ostream& out, const livetime& L)
+{
+  //! Write the record in the text form of the ".hkp" files
+
+  out<<"LT\nTI "<<L.UnixTime<<"\nID "<<L.PacketCounter<<"\nDU 1";
+  for (int i = 0; i < 12; ++i) {
+    if (L.HasLivetime[i] == 1) {
+      out<<"\nCC"<<i<<" "<<(L.Livetime[i])/3051.;
+    } else {
+      out<<"\nCC"<<i<<" -1";
+    }
+  }
+  out<<"\n\n";
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MHousekeepingBinary::WriteText(ostream& out, const gcuhousekeeping& G)
+{
+  //! Write the record in the text form of the ".hkp" files
+
+  out<<"HKP\nTI "<<G.UnixTime<<"\nID "<<G.PacketCounter<<"\nDU 5"<<"\nSR "<<G.ShieldCountRate<<"\n\n";
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+uint64_t MHousekeepingBinary::GetBlockSize(uint8_t Type, uint64_t N)
+{
+  //! Return the number of bytes of N records of the given block type in the file - 0 if the type is unknown
+
+  switch (Type) {
+  case c_Aspect:
+    return N*c_AspectSize;
+  case c_Livetime:
+    return N*c_LivetimeSize;
+  case c_GCUHousekeeping:
+    return N*c_GCUHousekeepingSize;
+  default:
+    return 0;
+  }
+}
+
+
+// MHousekeepingBinary.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,282 @@
+/*
+ * MHousekeepingReader.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MHousekeepingReader
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MHousekeepingReader.h"
+
+// Standard libs:
+#include <cstring>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MStreams.h"
+
+// Nuclearizer libs:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MHousekeepingReader)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+const uint64_t MHousekeepingReader::c_MaxBlockRecords;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MHousekeepingReader::MHousekeepingReader() : m_Position(0), m_HasError(false)
+{
+  // Construct an instance of MHousekeepingReader
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MHousekeepingReader::~MHousekeepingReader()
+{
+  // Delete this instance of MHousekeepingReader
+
+  Close();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MHousekeepingReader::Open(const MString& FileName)
+{
+  //! Open the file and check its magic
+
+  Close();
+
+  m_HasError = false;
+  m_Aspects.clear();
+  m_Livetimes.clear();
+  m_GCUHousekeeping.clear();
+
+  m_In.clear();
+  m_In.open(FileName.Data(), ios::binary);
+  if (m_In.is_open() == false) {
+    if (g_Verbosity >= c_Error) cout<<"Housekeeping reader: Error: Unable to open file "<<FileName<<endl;
+    return false;
+  }
+
+  char Magic[sizeof(c_Magic)];
+  m_In.read(Magic, sizeof(Magic));
+  if (m_In.gcount() != sizeof(Magic) || memcmp(Magic, c_Magic, sizeof(Magic)) != 0) {
+    if (g_Verbosity >= c_Error) cout<<"Housekeeping reader: Error: "<<FileName<<" is not a binary housekeeping file"<<endl;
+    m_In.close();
+    return false;
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MHousekeepingReader::Close()
+{
+  //! Close the file
+
+  if (m_In.is_open() == true) {
+    m_In.close();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MHousekeepingReader::ReadGroup()
+{
+  //! Read the next group of records - returns false at the end of the file or on error
+
+  m_Aspects.clear();
+  m_Livetimes.clear();
+  m_GCUHousekeeping.clear();
+
+  if (m_In.is_open() == false || m_HasError == true) return false;
+
+  bool IsFirstBlock = true;
+  while (true) {
+    uint8_t Header[c_BlockHeaderSize];
+    m_In.read(reinterpret_cast<char*>(Header), c_BlockHeaderSize);
+    if (m_In.gcount() == 0 && IsFirstBlock == true) {
+      return false; // regular end of the file
+    }
+    if (m_In.gcount() != c_BlockHeaderSize) {
+      if (g_Verbosity >= c_Error) cout<<"Housekeeping reader: Error: The file is truncated"<<endl;
+      m_HasError = true;
+      return false;
+    }
+    IsFirstBlock = false;
+
+    uint8_t Type = Header[0];
+    uint64_t N = (uint64_t) Header[1] | ((uint64_t) Header[2] << 8) | ((uint64_t) Header[3] << 16) | ((uint64_t) Header[4] << 24);
+    if (Type == c_EndOfGroup) {
+      return true;
+    }
+
+    if (ReadBlock(Type, N) == false) {
+      m_HasError = true;
+      return false;
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MHousekeepingReader::ReadBlock(uint8_t Type, uint64_t N)
+{
+  //! Read and decode one column block with N records of the given type
+
+  uint64_t Size = GetBlockSize(Type, N);
+  if (Size == 0 || N > c_MaxBlockRecords) {
+    if (g_Verbosity >= c_Error) cout<<"Housekeeping reader: Error: Unknown block type "<<(int) Type<<" or block size "<<N<<endl;
+    return false;
+  }
+
+  m_Bytes.resize(Size);
+  m_In.read(reinterpret_cast<char*>(m_Bytes.data()), Size);
+  if ((uint64_t) m_In.gcount() != Size) {
+    if (g_Verbosity >= c_Error) cout<<"Housekeeping reader: Error: The file is truncated"<<endl;
+    return false;
+  }
+  m_Position = 0;
+
+  if (Type == c_Aspect) {
+    size_t First = m_Aspects.size();
+    m_Aspects.resize(First + N);
+    aspect* A = m_Aspects.data() + First;
+    for (uint64_t r = 0; r < N; ++r) A[r].Sequence = Get(8);
+    for (uint64_t r = 0; r < N; ++r) A[r].Seconds = Get(4);
+    for (uint64_t r = 0; r < N; ++r) A[r].NanoSeconds = Get(4);
+    for (uint64_t r = 0; r < N; ++r) A[r].Mode = (int32_t) Get(4);
+    for (uint64_t r = 0; r < N; ++r) A[r].GXLongitude = GetDouble();
+    for (uint64_t r = 0; r < N; ++r) A[r].GXLatitude = GetDouble();
+    for (uint64_t r = 0; r < N; ++r) A[r].GZLongitude = GetDouble();
+    for (uint64_t r = 0; r < N; ++r) A[r].GZLatitude = GetDouble();
+    for (uint64_t r = 0; r < N; ++r) A[r].Latitude = GetDouble();
+    for (uint64_t r = 0; r < N; ++r) A[r].Longitude = GetDouble();
+    for (uint64_t r = 0; r < N; ++r) A[r].Altitude = GetDouble();
+    for (uint64_t r = 0; r < N; ++r) A[r].Heading = GetDouble();
+    for (uint64_t r = 0; r < N; ++r) A[r].Pitch = GetDouble();
+    for (uint64_t r = 0; r < N; ++r) A[r].Roll = GetDouble();
+  } else if (Type == c_Livetime) {
+    size_t First = m_Livetimes.size();
+    m_Livetimes.resize(First + N);
+    livetime* L = m_Livetimes.data() + First;
+    for (uint64_t r = 0; r < N; ++r) L[r].Sequence = Get(8);
+    for (uint64_t r = 0; r < N; ++r) L[r].UnixTime = Get(4);
+    for (uint64_t r = 0; r < N; ++r) L[r].PacketCounter = Get(2);
+    for (unsigned int i = 0; i < 12; ++i) {
+      for (uint64_t r = 0; r < N; ++r) L[r].HasLivetime[i] = Get(1);
+    }
+    for (unsigned int i = 0; i < 12; ++i) {
+      for (uint64_t r = 0; r < N; ++r) L[r].Livetime[i] = Get(2);
+    }
+  } else if (Type == c_GCUHousekeeping) {
+    size_t First = m_GCUHousekeeping.size();
+    m_GCUHousekeeping.resize(First + N);
+    gcuhousekeeping* G = m_GCUHousekeeping.data() + First;
+    for (uint64_t r = 0; r < N; ++r) G[r].Sequence = Get(8);
+    for (uint64_t r = 0; r < N; ++r) G[r].UnixTime = Get(4);
+    for (uint64_t r = 0; r < N; ++r) G[r].PacketCounter = Get(2);
+    for (uint64_t r = 0; r < N; ++r) G[r].ShieldCountRate = GetDouble();
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+uint64_t MHousekeepingReader::Get(unsigned int NBytes)
+{
+  //! Return the next NBytes bytes of the block buffer as little-endian value
+
+  uint64_t Value = 0;
+  for (unsigned int b = 0; b < NBytes; ++b) {
+    Value |= (uint64_t) m_Bytes[m_Position++] << (8*b);
+  }
+  return Value;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+double MHousekeepingReader::GetDouble()
+{
+  //! Return the next 8 bytes of the block buffer as little-endian double
+
+  uint64_t Bits = Get(8);
+  double Value;
+  memcpy(&Value, &Bits, sizeof(Value));
+  return Value;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MHousekeepingReader::WriteGroupText(ostream& out) const
+{
+  //! Write the records of the current group in their original order in the text form of the ".hkp" files
+
+  // The records of each type are stored in the order they were added, thus merge them by sequence number
+  size_t a = 0, l = 0, g = 0;
+  while (a < m_Aspects.size() || l < m_Livetimes.size() || g < m_GCUHousekeeping.size()) {
+    uint64_t SA = (a < m_Aspects.size()) ? m_Aspects[a].Sequence : UINT64_MAX;
+    uint64_t SL = (l < m_Livetimes.size()) ? m_Livetimes[l].Sequence : UINT64_MAX;
+    uint64_t SG = (g < m_GCUHousekeeping.size()) ? m_GCUHousekeeping[g].Sequence : UINT64_MAX;
+    if (SA <= SL && SA <= SG) {
+      WriteText(out, m_Aspects[a++]);
+    } else if (SL <= SG) {
+      WriteText(out, m_Livetimes[l++]);
+    } else {
+      WriteText(out, m_GCUHousekeeping[g++]);
+    }
+  }
+}
+
+
+// MHousekeepingReader.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,262 @@
+/*
+ * MHousekeepingWriter.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MHousekeepingWriter
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MHousekeepingWriter.h"
+
+// Standard libs:
+#include <cstring>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MStreams.h"
+
+// Nuclearizer libs:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MHousekeepingWriter)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+const unsigned int MHousekeepingWriter::c_GroupSize;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MHousekeepingWriter::MHousekeepingWriter() : m_NRecords(0)
+{
+  // Construct an instance of MHousekeepingWriter
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MHousekeepingWriter::~MHousekeepingWriter()
+{
+  // Delete this instance of MHousekeepingWriter
+
+  Close();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MHousekeepingWriter::Open(const MString& FileName)
+{
+  //! Open the file for writing - an already open file is closed first
+
+  Close();
+
+  m_Out.clear();
+  m_Out.open(FileName.Data(), ios::binary);
+  if (m_Out.is_open() == false) {
+    if (g_Verbosity >= c_Error) cout<<"Housekeeping writer: Error: Unable to open file "<<FileName<<endl;
+    return false;
+  }
+
+  m_Out.write(c_Magic, sizeof(c_Magic));
+  m_NRecords = 0;
+
+  return m_Out.fail() == false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MHousekeepingWriter::Close()
+{
+  //! Write all not yet written records and close the file
+
+  if (m_Out.is_open() == false) return;
+
+  Flush();
+  m_Out.close();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MHousekeepingWriter::Add(const aspect& A)
+{
+  //! Add an aspect record - its sequence number is set by the writer
+
+  m_Aspects.push_back(A);
+  m_Aspects.back().Sequence = m_NRecords++;
+  FlushIfFull();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MHousekeepingWriter::Add(const livetime& L)
+{
+  //! Add a livetime record - its sequence number is set by the writer
+
+  m_Livetimes.push_back(L);
+  m_Livetimes.back().Sequence = m_NRecords++;
+  FlushIfFull();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MHousekeepingWriter::Add(const gcuhousekeeping& G)
+{
+  //! Add a GCU housekeeping record - its sequence number is set by the writer
+
+  m_GCUHousekeeping.push_back(G);
+  m_GCUHousekeeping.back().Sequence = m_NRecords++;
+  FlushIfFull();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MHousekeepingWriter::FlushIfFull()
+{
+  //! Flush if enough records have been collected
+
+  if (m_Aspects.size() + m_Livetimes.size() + m_GCUHousekeeping.size() >= c_GroupSize) {
+    Flush();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MHousekeepingWriter::Put(uint64_t Value, unsigned int NBytes)
+{
+  //! Append the lowest NBytes bytes of the value little-endian to the output buffer
+
+  for (unsigned int b = 0; b < NBytes; ++b) {
+    m_Bytes.push_back((Value >> (8*b)) & 0xff);
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MHousekeepingWriter::PutDouble(double Value)
+{
+  //! Append a double little-endian to the output buffer
+
+  uint64_t Bits;
+  memcpy(&Bits, &Value, sizeof(Bits));
+  Put(Bits, 8);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MHousekeepingWriter::Flush()
+{
+  //! Write all collected records as one group
+
+  if (m_Out.is_open() == false) return false;
+  if (m_Aspects.empty() == true && m_Livetimes.empty() == true && m_GCUHousekeeping.empty() == true) return true;
+
+  m_Bytes.clear();
+
+  if (m_Aspects.empty() == false) {
+    Put(c_Aspect, 1);
+    Put(m_Aspects.size(), 4);
+    for (const aspect& A: m_Aspects) Put(A.Sequence, 8);
+    for (const aspect& A: m_Aspects) Put(A.Seconds, 4);
+    for (const aspect& A: m_Aspects) Put(A.NanoSeconds, 4);
+    for (const aspect& A: m_Aspects) Put((uint32_t) A.Mode, 4);
+    for (const aspect& A: m_Aspects) PutDouble(A.GXLongitude);
+    for (const aspect& A: m_Aspects) PutDouble(A.GXLatitude);
+    for (const aspect& A: m_Aspects) PutDouble(A.GZLongitude);
+    for (const aspect& A: m_Aspects) PutDouble(A.GZLatitude);
+    for (const aspect& A: m_Aspects) PutDouble(A.Latitude);
+    for (const aspect& A: m_Aspects) PutDouble(A.Longitude);
+    for (const aspect& A: m_Aspects) PutDouble(A.Altitude);
+    for (const aspect& A: m_Aspects) PutDouble(A.Heading);
+    for (const aspect& A: m_Aspects) PutDouble(A.Pitch);
+    for (const aspect& A: m_Aspects) PutDouble(A.Roll);
+  }
+
+  if (m_Livetimes.empty() == false) {
+    Put(c_Livetime, 1);
+    Put(m_Livetimes.size(), 4);
+    for (const livetime& L: m_Livetimes) Put(L.Sequence, 8);
+    for (const livetime& L: m_Livetimes) Put(L.UnixTime, 4);
+    for (const livetime& L: m_Livetimes) Put(L.PacketCounter, 2);
+    for (unsigned int i = 0; i < 12; ++i) {
+      for (const livetime& L: m_Livetimes) Put(L.HasLivetime[i], 1);
+    }
+    for (unsigned int i = 0; i < 12; ++i) {
+      for (const livetime& L: m_Livetimes) Put(L.Livetime[i], 2);
+    }
+  }
+
+  if (m_GCUHousekeeping.empty() == false) {
+    Put(c_GCUHousekeeping, 1);
+    Put(m_GCUHousekeeping.size(), 4);
+    for (const gcuhousekeeping& G: m_GCUHousekeeping) Put(G.Sequence, 8);
+    for (const gcuhousekeeping& G: m_GCUHousekeeping) Put(G.UnixTime, 4);
+    for (const gcuhousekeeping& G: m_GCUHousekeeping) Put(G.PacketCounter, 2);
+    for (const gcuhousekeeping& G: m_GCUHousekeeping) PutDouble(G.ShieldCountRate);
+  }
+
+  Put(c_EndOfGroup, 1);
+  Put(0, 4);
+
+  m_Aspects.clear();
+  m_Livetimes.clear();
+  m_GCUHousekeeping.clear();
+
+  m_Out.write(reinterpret_cast<const char*>(m_Bytes.data()), m_Bytes.size());
+  if (m_Out.fail() == true) {
+    if (g_Verbosity >= c_Error) cout<<"Housekeeping writer: Error: Unable to write to the file"<<endl;
+    return false;
+  }
+
+  return true;
+}
+
+
+// MHousekeepingWriter.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
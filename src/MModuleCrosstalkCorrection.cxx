@@ -205,37 +205,12 @@ bool MModuleCrosstalkCorrection::Initialize()
 ////////////////////////////////////////////////////////////////////////////////
 
 
-bool compare_striphits(MStripHit* SH1, MStripHit* SH2)
-{
-  int det1 = SH1->GetDetectorID();
-  int det2 = SH2->GetDetectorID();
-  int side1 = 0, side2 = 0;
-  int strip1 = SH1->GetStripID();
-  int strip2 = SH2->GetStripID();
-  if (not SH1->IsXStrip()) side1 = 1;
-  if (not SH2->IsXStrip()) side2 = 1;
-  if (det1 != det2) return (det1<det2);
-  else if ((det1==det2) && (side1!=side2)) return (side1<side2);
-  else if ((det1==det2) && (side1==side2)) return (strip1<strip2);
-  else
-  {
-    mout << "############# Problem in compare_striphits!" << endl;
-    return false;
-  }
-}
-
-
-////////////////////////////////////////////////////////////////////////////////
-
-
 bool MModuleCrosstalkCorrection::AnalyzeEvent(MReadOutAssembly* Event) 
 {
   // Main data analysis routine, which updates the event to a new level 
 
   
  //for (unsigned int sh=0; sh < Event->GetNHits(); sh++) {
-  unsigned int NStripHits = Event->GetNStripHits();
-  vector<MStripHit*> StripHits;
   bool debug=false;
   
   if (debug)
@@ -244,32 +219,28 @@ bool MModuleCrosstalkCorrection::AnalyzeEvent(MReadOutAssembly* Event)
     mout << "#######################################" << endl;
     mout << "Event " << Event->GetID() << endl;
   }
+  // The strip hits of each side of each detector are a contiguous range in the structure-of-arrays view
+  MStripHitArrays& A = Event->LoadStripHitArrays();
+  bool Corrected = false;
   // Loop over all detectors
   for (int i_det=0; i_det<12; i_det++)
   {
     // Loop over detector sides
     for (unsigned int i_side=0; i_side<=1; i_side++)
     {
-      StripHits.clear();
-      // Extract strip hits from the given side of the given detector
-      for (unsigned int i_sh=0; i_sh<NStripHits; i_sh++)
-      {
-        // Count number of X and Y strips
-        MStripHit *SH = Event->GetStripHit(i_sh);
-        if ((SH->GetDetectorID()==i_det) 
-          && (((SH->IsXStrip()==true) && (i_side==0)) 
-          || ((SH->IsXStrip()==false) && (i_side==1))))
-        {
-          StripHits.push_back(SH);
-        }
-      }
-      if (StripHits.size()>=2)
+      unsigned int Begin = A.GetBegin(i_det, i_side==0);
+      unsigned int End = A.GetEnd(i_det, i_side==0);
+      if (End - Begin >= 2)
       {
         // Perform the cross-talk correction!
-        CorrectCrosstalk(StripHits, i_det, i_side);
+        CorrectCrosstalk(A, Begin, End, i_det, i_side);
+        Corrected = true;
       }
     }
   }
+  if (Corrected == true) {
+    Event->StoreStripHitArrays();
+  }
   
   
   // Remove any strips that have negative energy after the correction FROM the Hits -- we still keep them around
@@ -457,14 +428,18 @@ bool MModuleCrosstalkCorrection::AnalyzeEvent(MReadOutAssembly* Event)
 
 // Method to make the cross-talk correction on a vector of strip hits
 // StripHits is a vector of StripHits from one side of one detector
-void MModuleCrosstalkCorrection::CorrectCrosstalk(vector<MStripHit*> StripHits, 
+void MModuleCrosstalkCorrection::CorrectCrosstalk(MStripHitArrays& A, unsigned int Begin, unsigned int End,
                                                      int det, unsigned int side)
 {
   bool debug=false;
   bool debug_matrices=false;
-  unsigned int N = StripHits.size();
-  // Sort the strip hits
-  sort(StripHits.begin(), StripHits.end(), compare_striphits);
+  unsigned int N = End - Begin;
+  // All elements in [Begin, End) belong to the same detector side, thus sort them by strip ID only
+  const int* StripIDs = A.GetStripIDs();
+  double* StripEnergies = A.GetEnergies();
+  vector<unsigned int> Order(N);
+  for (unsigned int j=0; j<N; j++) Order[j] = Begin + j;
+  sort(Order.begin(), Order.end(), [StripIDs](unsigned int i1, unsigned int i2) { return StripIDs[i1] < StripIDs[i2]; });
   // Cross-talk coefficients
   double a0 = m_CrosstalkCoeffs[det][side][0][0];
   double b0 = m_CrosstalkCoeffs[det][side][0][1];
@@ -474,34 +449,34 @@ void MModuleCrosstalkCorrection::CorrectCrosstalk(vector<MStripHit*> StripHits,
   double b2 = m_CrosstalkCoeffs[det][side][2][1];
   
   // Print out the strips, check their order
-  if (debug && StripHits.size()>0)
+  if (debug && N>0)
   {
     mout << "++++++++++++++++++++++" << endl;
-    for (unsigned int j=0; j<StripHits.size(); j++)
+    for (unsigned int j=0; j<N; j++)
     {
-      mout << StripHits[j]->GetDetectorID() << " "
-      << !StripHits[j]->IsXStrip() << " "
-      << StripHits[j]->GetStripID() << " "
-      << StripHits[j]->GetEnergy() << endl;
+      mout << det << " "
+      << side << " "
+      << StripIDs[Order[j]] << " "
+      << StripEnergies[Order[j]] << endl;
     }
   }
   
   // Make a matrix vector of energies from each strip
   TMatrixD Energies(N,1);
   double Energy_Total = 0.;
-  for (unsigned int j=0; j<StripHits.size(); j++)
+  for (unsigned int j=0; j<N; j++)
   {
-    Energies[j][0] = StripHits[j]->GetEnergy();
-    Energy_Total += StripHits[j]->GetEnergy();
+    Energies[j][0] = StripEnergies[Order[j]];
+    Energy_Total += StripEnergies[Order[j]];
   }
   if (debug_matrices && N>=2) Energies.Print();
   
   // Make a big matrix for the cross-talk corrections
   TMatrixD Matrix(N,N);
   TMatrixD Constant(N,1);
-  for (unsigned int i=0; i<StripHits.size(); i++)
+  for (unsigned int i=0; i<N; i++)
   {
-    for (unsigned int j=i; j<StripHits.size(); j++)
+    for (unsigned int j=i; j<N; j++)
     {
       // Self-contribution
       if (i==j)
@@ -509,7 +484,7 @@ void MModuleCrosstalkCorrection::CorrectCrosstalk(vector<MStripHit*> StripHits,
         Matrix[i][j] += 1.0;
       }
       // Nearest-neighbor contributions
-      if (StripHits[j]->GetStripID()==(StripHits[i]->GetStripID()+1))
+      if (StripIDs[Order[j]]==(StripIDs[Order[i]]+1))
       {
         Matrix[i][j] += b0;
         Matrix[j][i] += b0;
@@ -517,7 +492,7 @@ void MModuleCrosstalkCorrection::CorrectCrosstalk(vector<MStripHit*> StripHits,
         Constant[j] += a0/2.;
       }
       // Skip-1 neighbor contributions
-      if (StripHits[j]->GetStripID()==(StripHits[i]->GetStripID()+2))
+      if (StripIDs[Order[j]]==(StripIDs[Order[i]]+2))
       {
         Matrix[i][j] += b1;
         Matrix[j][i] += b1;
@@ -525,7 +500,7 @@ void MModuleCrosstalkCorrection::CorrectCrosstalk(vector<MStripHit*> StripHits,
         Constant[j] += a1/2.;
       }
       // Skip-2 neighbor contributions
-     // if (StripHits[j]->GetStripID()==(StripHits[i]->GetStripID()+3))
+     // if (StripIDs[Order[j]]==(StripIDs[Order[i]]+3))
      // {
      //   Matrix[i][j] += b2;
      //   Matrix[j][i] += b2;
@@ -541,30 +516,30 @@ void MModuleCrosstalkCorrection::CorrectCrosstalk(vector<MStripHit*> StripHits,
   // Calculate final corrected energies
   TMatrixD FinalEnergies = TMatrixD(Inv,TMatrixD::kMult,Energies+Constant); //ck changed this to Energies + Constant
   if (debug_matrices && N>=2) FinalEnergies.Print();
-  for (unsigned int j=0; j<StripHits.size(); j++)
+  for (unsigned int j=0; j<N; j++)
   {
-    StripHits[j]->SetEnergy(FinalEnergies[j][0]);
+    StripEnergies[Order[j]] = FinalEnergies[j][0];
   }
   
   // Print out the strips again, check their order and energies
-  if (debug && StripHits.size()>0)
+  if (debug && N>0)
   {
     mout << "----------------------" << endl;
-    for (unsigned int j=0; j<StripHits.size(); j++)
+    for (unsigned int j=0; j<N; j++)
     {
-      mout << StripHits[j]->GetDetectorID() << " "
-      << !StripHits[j]->IsXStrip() << " "
-      << StripHits[j]->GetStripID() << " "
-      << StripHits[j]->GetEnergy() << endl;
+      mout << det << " "
+      << side << " "
+      << StripIDs[Order[j]] << " "
+      << StripEnergies[Order[j]] << endl;
     }
     mout << "++++++++++++++++++++++" << endl;
   }
 
 	//CCS: I'm getting a strip hit with negative energy in the depth calibration,
 	// so just check that energies are still positive here
-	for (auto SH: StripHits){
-		if (SH->GetEnergy() < 0){
-			SH->SetEnergy(0);
+	for (unsigned int j=Begin; j<End; j++){
+		if (StripEnergies[j] < 0){
+			StripEnergies[j] = 0;
 		}
 	}
 
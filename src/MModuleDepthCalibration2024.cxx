@@ -88,6 +88,7 @@ MModuleDepthCalibration2024::MModuleDepthCalibration2024() : MModule()
   m_Error3 = 0;
   m_Error4 = 0;
   m_Error5 = 0;
+  m_Error6 = 0;
   m_ErrorSH = 0;
 }
 
@@ -286,8 +287,8 @@ bool MModuleDepthCalibration2024::AnalyzeEvent(MReadOutAssembly* Event)
       // If there are coefficients and timing information is loaded, try calculating the CTD and depth
       else {
 
-        vector<double> ctdvec = GetCTD(DetID, Grade);
-        vector<double> depthvec = GetDepth(DetID);
+        const vector<double>& ctdvec = GetCTD(DetID, Grade);
+        const vector<double>& depthvec = GetDepth(DetID);
 
       	if ( ctdvec.size() == 0){
       	  cout << "Empty CTD vector" << endl;
@@ -535,9 +536,10 @@ std::vector<double>* MModuleDepthCalibration2024::GetPixelCoeffs(int pixel_code)
 
 }
 
-vector<double> MModuleDepthCalibration2024::norm_pdf(vector<double> x, double mu, double sigma)
+vector<double> MModuleDepthCalibration2024::norm_pdf(const vector<double>& x, double mu, double sigma)
 {
   vector<double> result;
+  result.reserve(x.size());
   for( unsigned int i=0; i<x.size(); ++i ){
     double prob = 1.0 / (sigma * sqrt(2.0 * M_PI)) * exp(-(pow((x[i] - mu)/sigma, 2.0)/2.0));
     // cout << "Probability: " << prob << endl;
@@ -761,46 +763,54 @@ bool MModuleDepthCalibration2024::AddDepthCTD(vector<double> depthvec, vector<ve
 }
 
 
-vector<double> MModuleDepthCalibration2024::GetCTD(int DetID, int Grade)
+const vector<double>& MModuleDepthCalibration2024::GetCTD(int DetID, int Grade)
 {
   // Retrieves the appropriate CTD vector given the Detector ID and Event Grade passed
+  // Returns a reference into the CTD map, thus no vector is copied per hit
+
+  static const vector<double> Empty;
 
   if( !m_SplinesFileIsLoaded ){
     cout << "MModuleDepthCalibration2024::GetCTD: cannot return Depth to CTD relation because the file was not loaded." << endl;
-    return vector<double> ();
+    return Empty;
   }
   // If there is a CTD array for the given detector, return it.
   // If the Grade is larger than the number of CTD vectors stored, then just return Grade 0 vector.
-  if( m_CTDMap.count(DetID) > 0 ){
-    if ( ((int)m_CTDMap[DetID].size()) > Grade) {
-      return (m_CTDMap[DetID][Grade]);
+  auto Iter = m_CTDMap.find(DetID);
+  if( Iter != m_CTDMap.end() ){
+    if ( ((int)Iter->second.size()) > Grade) {
+      return Iter->second[Grade];
     }
     else {
       cout << "MModuleDepthCalibration2024::GetCTD: No CTD map is loaded for Grade " << Grade << ". Returning Grade 0 CTD." << endl;
-      return (m_CTDMap[DetID][0]);
+      return Iter->second[0];
     }
   } else {
     cout << "MModuleDepthCalibration2024::GetCTD: No CTD map is loaded for Det " << DetID << "." << endl;
-    return vector<double> ();
+    return Empty;
   }
 }
 
-vector<double> MModuleDepthCalibration2024::GetDepth(int DetID)
+const vector<double>& MModuleDepthCalibration2024::GetDepth(int DetID)
 {
   // Retrieves the appropriate CTD vector given the Detector ID and Event Grade passed
+  // Returns a reference into the depth grid, thus no vector is copied per hit
+
+  static const vector<double> Empty;
 
   if( !m_SplinesFileIsLoaded ){
     cout << "MModuleDepthCalibration2024::GetDepth: cannot return Depth grid because the file was not loaded." << endl;
-    return vector<double> ();
+    return Empty;
   }
 
   // If there is a CTD array for the given detector, return it.
   // If the Grade is larger than the number of CTD vectors stored, then just return Grade 0 vector.
-  if( m_DepthGrid.count(DetID) > 0 ){
-    return m_DepthGrid[DetID];
+  auto Iter = m_DepthGrid.find(DetID);
+  if( Iter != m_DepthGrid.end() ){
+    return Iter->second;
     } else {
       cout << "MModuleDepthCalibration2024::GetDepth: No Depth grid is loaded for Det " << DetID << "." << endl;
-      return vector<double> ();
+      return Empty;
   }
 } 
 
@@ -850,10 +860,35 @@ MXmlNode* MModuleDepthCalibration2024::CreateXmlConfiguration()
   return Node;
 }
 
+void MModuleDepthCalibration2024::MergeReplica(MBatchAnalyzer* Replica)
+{
+  //! Add the hit counters of a replica
+
+  MModuleDepthCalibration2024* R = dynamic_cast<MModuleDepthCalibration2024*>(Replica);
+  if (R == nullptr) return;
+
+  m_NoError += R->m_NoError;
+  m_Error1 += R->m_Error1;
+  m_Error2 += R->m_Error2;
+  m_Error3 += R->m_Error3;
+  m_Error4 += R->m_Error4;
+  m_Error5 += R->m_Error5;
+  m_Error6 += R->m_Error6;
+  m_ErrorSH += R->m_ErrorSH;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
 void MModuleDepthCalibration2024::Finalize()
 {
 
   MModule::Finalize();
+
+  // The counters of a replica are reported by the original
+  if (IsReplica() == true) return;
+
   cout << "###################" << endl;
   cout << "AWL depth cal stats" << endl;
   cout << "###################" << endl;
@@ -344,14 +344,64 @@ bool MModuleEnergyCalibrationUniversal::Initialize()
 bool MModuleEnergyCalibrationUniversal::AnalyzeEvent(MReadOutAssembly* Event) 
 {
   // Main data analysis routine, which updates the event to a new level, i.e. takes the raw ADC value from the .roa file loaded through nuclearizer and converts it into energy units.
+
+  bool Return = Calibrate(Event);
+
+  if (m_ExpoEnergies.size() > 0) {
+    m_ExpoEnergyCalibration->AddEnergies(m_ExpoEnergies);
+    m_ExpoEnergies.clear();
+  }
+
+  return Return;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModuleEnergyCalibrationUniversal::AnalyzeEvents(vector<MReadOutAssembly*>& Events, vector<bool>& Results) 
+{
+  // Analyze a batch of events - the expo is locked only once per batch
+
+  Results.resize(Events.size());
+  for (unsigned int e = 0; e < Events.size(); ++e) {
+    Results[e] = Calibrate(Events[e]);
+  }
+
+  if (m_ExpoEnergies.size() > 0) {
+    m_ExpoEnergyCalibration->AddEnergies(m_ExpoEnergies);
+    m_ExpoEnergies.clear();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MModuleEnergyCalibrationUniversal::Calibrate(MReadOutAssembly* Event) 
+{
+  // Calibrate one event, the energies for the expo are appended to m_ExpoEnergies
   
-  for (unsigned int i = 0; i < Event->GetNStripHits(); ++i) {
-    MStripHit* SH = Event->GetStripHit(i);
-    MReadOutElementDoubleStrip R = *dynamic_cast<MReadOutElementDoubleStrip*>(SH->GetReadOutElement());
+  // Work on the structure-of-arrays view of the strip hits and write the results back at the end
+  MStripHitArrays& A = Event->LoadStripHitArrays();
+  const int* DetectorIDs = A.GetDetectorIDs();
+  const int* StripIDs = A.GetStripIDs();
+  const unsigned char* IsXStrips = A.GetIsXStrips();
+  const double* PreampTemps = A.GetPreampTemps();
+  double* ADCUnits = A.GetADCUnits();
+  double* Energies = A.GetEnergies();
+  double* EnergyResolutions = A.GetEnergyResolutions();
+
+  MReadOutElementDoubleStrip R;
+  for (unsigned int i = 0; i < A.GetSize(); ++i) {
+    R.SetDetectorID(DetectorIDs[i]);
+    R.SetStripID(StripIDs[i]);
+    R.IsPositiveStrip(IsXStrips[i] == 1);
     
-    TF1* Fit = m_Calibration[R];
-    TF1* FitRes = m_ResolutionCalibration[R];
-    double temp, ADCMod, newADC;
+    auto FitIter = m_Calibration.find(R);
+    TF1* Fit = (FitIter != m_Calibration.end()) ? FitIter->second : 0;
+    auto FitResIter = m_ResolutionCalibration.find(R);
+    TF1* FitRes = (FitResIter != m_ResolutionCalibration.end()) ? FitResIter->second : 0;
 
     if (Fit == 0) {
       if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: Energy-fit not found for read-out element "<<R<<endl;
@@ -360,45 +410,42 @@ bool MModuleEnergyCalibrationUniversal::AnalyzeEvent(MReadOutAssembly* Event)
 
       double Energy = 0;
       if (m_TemperatureEnabled) {
-	TF1* FitTemp = m_TemperatureCalibration[R];
-	if (FitTemp == 0) {
-	  if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: temp-fit not found for read-out element "<<R<<endl;
+        auto FitTempIter = m_TemperatureCalibration.find(R);
+        TF1* FitTemp = (FitTempIter != m_TemperatureCalibration.end()) ? FitTempIter->second : 0;
+        if (FitTemp == 0) {
+          if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: temp-fit not found for read-out element "<<R<<endl;
           Event->SetEnergyCalibrationIncomplete_BadStrip(true);
         } else {
-          temp = SH->GetPreampTemp();
-	  ADCMod = FitTemp->Eval(temp);
-          newADC = (SH->GetADCUnits())/ADCMod;
- 	  SH->SetADCUnits(newADC); 
+          ADCUnits[i] /= FitTemp->Eval(PreampTemps[i]);
         }
       } 
        
-      Energy = Fit->Eval(SH->GetADCUnits());
+      Energy = Fit->Eval(ADCUnits[i]);
 
-      if (Energy < 0 && SH->GetADCUnits() > 100) {
+      if (Energy < 0 && ADCUnits[i] > 100) {
         Event->SetEnergyCalibrationIncomplete(true);
         Energy = 0;
       } else if (Energy < 0) {
         Energy = 0;
       }
-     
       
-      SH->SetEnergy(Energy);
+      Energies[i] = Energy;
       if (FitRes == 0) {
         if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: Energy Resolution fit not found for read-out element "<<R<<endl;
         Event->SetEnergyResolutionCalibrationIncomplete(true);
       } else {
-        double EnergyResolution = FitRes->Eval(Energy);
-        SH->SetEnergyResolution(EnergyResolution);
+        EnergyResolutions[i] = FitRes->Eval(Energy);
       }
-      if (R.IsPositiveStrip() == true) {
+      if (IsXStrips[i] == 1) {
         if (HasExpos() == true) {
-          m_ExpoEnergyCalibration->AddEnergy(Energy);
+          m_ExpoEnergies.push_back(Energy);
         }
       }
       
-      if (g_Verbosity >= c_Info) cout<<m_XmlTag<<": Energy: "<<SH->GetADCUnits()<<" adu --> "<<Energy<<" keV"<<endl;
+      if (g_Verbosity >= c_Info) cout<<m_XmlTag<<": Energy: "<<ADCUnits[i]<<" adu --> "<<Energy<<" keV"<<endl;
     } 
   } 
+  Event->StoreStripHitArrays();
   Event->SetAnalysisProgress(MAssembly::c_EnergyCalibration);
   
   return true;
@@ -136,9 +136,11 @@ bool MModuleEventFilter::AnalyzeEvent(MReadOutAssembly* Event)
       FilteredOut = true; 
     }   
   } else if (Event->GetNStripHits() > 0) {
+    const MStripHitArrays& A = Event->LoadStripHitArrays(MStripHitArrays::c_ColumnEnergies);
+    const double* Energies = A.GetEnergies();
     double Total = 0;
-    for (unsigned int h = 0; h < Event->GetNStripHits(); ++h) {
-      Total += Event->GetStripHit(h)->GetEnergy(); 
+    for (unsigned int h = 0; h < A.GetSize(); ++h) {
+      Total += Energies[h]; 
     }
     if (Total < m_MinimumTotalEnergy || Total > m_MaximumTotalEnergy) {
       FilteredOut = true; 
@@ -111,41 +111,44 @@ bool MModuleEventSaver::Initialize()
   m_SubFileStart.Set(0);  
 
   m_InternalFileName = m_FileName;
-  
   m_Zip = false;
-  if (m_InternalFileName.EndsWith(".gz") == true) {
-    m_Zip = true;
-    m_InternalFileName.RemoveInPlace(m_InternalFileName.Length() - 3);
-  }
   
-  MString Suffix = m_InternalFileName;
-  if (Suffix.Last('.') != MString::npos) {
-    Suffix.RemoveInPlace(0, Suffix.Last('.'));
-    if (Suffix == ".dat" || Suffix == ".roa" || Suffix == ".evta") {
-      m_InternalFileName.RemoveInPlace(m_InternalFileName.Last('.'));
+  // The null device is used as it is, e.g. by benchmarks which want the cost of formatting but no file
+  if (m_FileName != "/dev/null") {
+    if (m_InternalFileName.EndsWith(".gz") == true) {
+      m_Zip = true;
+      m_InternalFileName.RemoveInPlace(m_InternalFileName.Length() - 3);
     }
-  }
   
-  if (m_AddTimeTag == true) {
-    MTime Now;
-    m_InternalFileName += ".";
-    m_InternalFileName += Now.GetShortString();
-  }
+    MString Suffix = m_InternalFileName;
+    if (Suffix.Last('.') != MString::npos) {
+      Suffix.RemoveInPlace(0, Suffix.Last('.'));
+      if (Suffix == ".dat" || Suffix == ".roa" || Suffix == ".evta") {
+        m_InternalFileName.RemoveInPlace(m_InternalFileName.Last('.'));
+      }
+    }
+  
+    if (m_AddTimeTag == true) {
+      MTime Now;
+      m_InternalFileName += ".";
+      m_InternalFileName += Now.GetShortString();
+    }
 
-  // Add the right tag
-  if (m_Mode == c_DatFile) {
-    m_InternalFileName += ".dat";
-  } else if (m_Mode == c_EvtaFile) {
-    m_InternalFileName += ".evta";
-  } else if (m_Mode == c_RoaFile) {
-    m_InternalFileName += ".roa";
-  } else {
-    if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Unsupported mode: "<<m_Mode<<endl;
-    return false;
-  }
+    // Add the right tag
+    if (m_Mode == c_DatFile) {
+      m_InternalFileName += ".dat";
+    } else if (m_Mode == c_EvtaFile) {
+      m_InternalFileName += ".evta";
+    } else if (m_Mode == c_RoaFile) {
+      m_InternalFileName += ".roa";
+    } else {
+      if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Unsupported mode: "<<m_Mode<<endl;
+      return false;
+    }
   
-  if (m_Zip == true) {
-    m_InternalFileName += ".gz";
+    if (m_Zip == true) {
+      m_InternalFileName += ".gz";
+    }
   }
   
   
@@ -284,34 +287,59 @@ bool MModuleEventSaver::AnalyzeEvent(MReadOutAssembly* Event)
 {
   // Write the event to disk
  
+  bool Return = StreamEvent(Event);
+  FlushBuffer();
+
+  return Return;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModuleEventSaver::AnalyzeEvents(vector<MReadOutAssembly*>& Events, vector<bool>& Results) 
+{
+  // Write a batch of events to disk with one write
+
+  Results.resize(Events.size());
+  for (unsigned int e = 0; e < Events.size(); ++e) {
+    Results[e] = StreamEvent(Events[e]);
+  }
+  FlushBuffer();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MModuleEventSaver::StreamEvent(MReadOutAssembly* Event) 
+{
+  // Stream one event into the write buffer
+ 
   if (m_SaveBadEvents == false) {
     if (Event->IsBad() == true) return true;
   }
 
-  MFile* Choosen = 0; // Wish C++ would allow unassigned references...
   if (m_SplitFile == true) {
     MTime Current = Event->GetTime();
     if (Current > m_SubFileStart + m_SplitFileTime) {
+      // Everything buffered so far belongs into the old sub-file
+      FlushBuffer();
       m_SubFileStart = Current;
       if (StartSubFile() == false) {
         m_IsOK = false;
         return false;
       }
     }
-    Choosen = &m_SubFileOut;
-  } else {
-    Choosen = &m_Out; 
   }
   
-  ostringstream Out;
   if (m_Mode == c_EvtaFile) {
-    Event->StreamEvta(Out);
+    Event->StreamEvta(m_Buffer);
   } else if (m_Mode == c_DatFile) {
-    Event->StreamDat(Out, 1);    
+    Event->StreamDat(m_Buffer, 1);    
   } else if (m_Mode == c_RoaFile) {
-    Event->StreamRoa(Out);
+    Event->StreamRoa(m_Buffer);
   }
-  Choosen->Write(Out);
   
   Event->SetAnalysisProgress(MAssembly::c_EventSaver);
 
@@ -322,6 +350,26 @@ bool MModuleEventSaver::AnalyzeEvent(MReadOutAssembly* Event)
 ////////////////////////////////////////////////////////////////////////////////
 
 
+void MModuleEventSaver::FlushBuffer() 
+{
+  // Write the content of the write buffer to the current file
+
+  if (m_Buffer.tellp() <= 0) return;
+
+  if (m_SplitFile == true) {
+    m_SubFileOut.Write(m_Buffer);
+  } else {
+    m_Out.Write(m_Buffer);
+  }
+
+  m_Buffer.str("");
+  m_Buffer.clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
 void MModuleEventSaver::ShowOptionsGUI()
 {
   //! Show the options GUI --- has to be overwritten!
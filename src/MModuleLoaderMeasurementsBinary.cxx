@@ -30,15 +30,21 @@
 
 // Standard libs:
 #include <algorithm>
+#include <limits>
 #include <cstdio>
 using namespace std;
 #include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 // ROOT libs:
 #include "TGClient.h"
 
 // MEGAlib libs:
 #include "MGUIOptionsLoaderMeasurementsBinary.h"
+#include "MObjectPool.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -52,6 +58,12 @@ ClassImp(MModuleLoaderMeasurementsBinary)
 ////////////////////////////////////////////////////////////////////////////////
 
 
+const size_t MModuleLoaderMeasurementsBinary::c_ChunkSize;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
 MModuleLoaderMeasurementsBinary::MModuleLoaderMeasurementsBinary() : MModule(), MBinaryFlightDataParser()
 {
 	// Construct an instance of MModuleLoaderMeasurementsBinary
@@ -86,7 +98,22 @@ MModuleLoaderMeasurementsBinary::MModuleLoaderMeasurementsBinary() : MModule(),
 	m_FileIsDone = false;
   
   m_IsZipped = false;
-	m_ZipFile = NULL;
+
+  m_IsMapped = false;
+  m_MappedData = nullptr;
+  m_MappedSize = 0;
+  m_MappedPosition = 0;
+  m_MappedReleased = 0;
+
+  m_ReadBegin = 0;
+  m_ReadEnd = numeric_limits<uint64_t>::max();
+  m_ReadPosition = 0;
+
+  m_StartTime = 0;
+  m_StopTime = 0;
+  m_WarmUpTime = 60;
+
+  m_ReadFilesConcurrently = false;
 
   m_ExpoAspectViewer = nullptr;
 }
@@ -98,6 +125,9 @@ MModuleLoaderMeasurementsBinary::MModuleLoaderMeasurementsBinary() : MModule(),
 MModuleLoaderMeasurementsBinary::~MModuleLoaderMeasurementsBinary()
 {
 	// Delete this instance of MModuleLoaderMeasurementsBinary
+
+  UnmapFile();
+  CloseAllFiles();
 }
 
 
@@ -129,30 +159,381 @@ bool MModuleLoaderMeasurementsBinary::OpenNextFile()
 
   m_IsZipped = m_BinaryFileNames[m_OpenFileID].EndsWith(".gz");
   
+  UnmapFile();
+  m_ZipReader.Close();
+  
   if (m_IsZipped == false) {
     if (m_In.is_open()) m_In.close();
     m_In.clear();
   
-    m_In.open(m_BinaryFileNames[m_OpenFileID], ios::binary);
-    if (m_In.is_open() == false) {
-      if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: unable to open file \""<<m_BinaryFileNames[m_OpenFileID]<<"\""<<endl;
-      return false;
+    // Uncompressed files are memory-mapped, the stream is only the fall back
+    if (MapFile(m_BinaryFileNames[m_OpenFileID]) == false) {
+      m_In.open(m_BinaryFileNames[m_OpenFileID], ios::binary);
+      if (m_In.is_open() == false) {
+        if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: unable to open file \""<<m_BinaryFileNames[m_OpenFileID]<<"\""<<endl;
+        return false;
+      }
     }
   } else {
-    if (m_ZipFile != NULL) gzclose(m_ZipFile);
-    
-    m_ZipFile = gzopen(m_BinaryFileNames[m_OpenFileID], "rb");
-    if (m_ZipFile == NULL) {
+    // Decompression runs on its own thread and overlaps with the parsing
+    if (m_ZipReader.Open(m_BinaryFileNames[m_OpenFileID]) == false) {
       if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: unable to open file \""<<m_BinaryFileNames[m_OpenFileID]<<"\""<<endl;
       return false;
     }
   }
   
-  if (g_Verbosity >= c_Info) cout<<m_XmlTag<<": Opened file \""<<m_BinaryFileNames[m_OpenFileID]<<"\""<<endl;
+  if (g_Verbosity >= c_Info) cout<<m_XmlTag<<": Opened file \""<<m_BinaryFileNames[m_OpenFileID]<<"\""<<(m_IsMapped == true ? " (memory-mapped)" : "")<<endl;
+  
+  m_ReadBegin = 0;
+  m_ReadEnd = numeric_limits<uint64_t>::max();
+  m_ReadPosition = 0;
+  if (HasTimeRange() == true && SeekTimeRange() == false) {
+    if (g_Verbosity >= c_Info) cout<<m_XmlTag<<": File \""<<m_BinaryFileNames[m_OpenFileID]<<"\" has no data within the time range - skipping it"<<endl;
+    return OpenNextFile();
+  }
   
   return true;
 }
 
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MModuleLoaderMeasurementsBinary::OpenAllFiles()
+{
+  //! Open all files at once, each with its own reading thread, return false on error
+
+  CloseAllFiles();
+
+  for (const MString& FileName: m_BinaryFileNames) {
+    uint64_t Begin = 0;
+    uint64_t End = numeric_limits<uint64_t>::max();
+    if (HasTimeRange() == true && FindReadRegion(FileName, Begin, End) == false) {
+      if (g_Verbosity >= c_Info) cout<<m_XmlTag<<": File \""<<FileName<<"\" has no data within the time range - skipping it"<<endl;
+      continue;
+    }
+
+    MBinaryFlightDataFileReader* Reader = new MBinaryFlightDataFileReader();
+    if (Reader->Open(FileName, Begin, End) == false) {
+      if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: unable to open file \""<<FileName<<"\""<<endl;
+      delete Reader;
+      CloseAllFiles();
+      return false;
+    }
+    m_FileReaders.push_back(Reader);
+
+    if (g_Verbosity >= c_Info) cout<<m_XmlTag<<": Opened file \""<<FileName<<"\" (read concurrently)"<<endl;
+  }
+
+  if (m_FileReaders.size() == 0) return false;
+
+  // The readers frame their first packets in parallel
+  for (auto Reader: m_FileReaders) {
+    Reader->Next();
+  }
+
+  m_MergedPackets.reserve(c_ChunkSize);
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+size_t MModuleLoaderMeasurementsBinary::ReadMergedChunk(const uint8_t*& Data)
+{
+  //! Return the next chunk of packets of all files, merged by clock, in Data, and its size (0 if all files are exhausted)
+
+  m_MergedPackets.clear();
+
+  // Always take the packet with the oldest clock - for the few files a linear search is all we need
+  // The event buffer of the parser sorts out the remaining small disorder between the card cages
+  while (m_MergedPackets.size() + MBinaryFlightDataFileReader::c_MaxPacketLength <= c_ChunkSize) {
+    MBinaryFlightDataFileReader* Oldest = nullptr;
+    for (auto Reader: m_FileReaders) {
+      if (Reader->HasPacket() == true && (Oldest == nullptr || Reader->GetClock() < Oldest->GetClock())) {
+        Oldest = Reader;
+      }
+    }
+    if (Oldest == nullptr) break;
+
+    m_MergedPackets.insert(m_MergedPackets.end(), Oldest->GetPacket(), Oldest->GetPacket() + Oldest->GetLength());
+    Oldest->Next();
+  }
+
+  Data = (m_MergedPackets.size() > 0) ? m_MergedPackets.data() : nullptr;
+
+  return m_MergedPackets.size();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModuleLoaderMeasurementsBinary::CloseAllFiles()
+{
+  //! Close all files opened with OpenAllFiles()
+
+  for (auto Reader: m_FileReaders) {
+    if (Reader->HasError() == true) {
+      if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: unable to read one of the files completely"<<endl;
+    }
+    Reader->Close();
+    delete Reader;
+  }
+  m_FileReaders.clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MModuleLoaderMeasurementsBinary::SeekTimeRange()
+{
+  //! Restrict the read region of the currently open file to the time range (plus warm-up) using the packet index
+  //! Return false if the file has no data within the time range
+
+  uint64_t Begin = 0;
+  uint64_t End = 0;
+  if (FindReadRegion(m_BinaryFileNames[m_OpenFileID], Begin, End) == false) {
+    return false;
+  }
+
+  m_ReadBegin = Begin;
+  m_ReadEnd = End;
+
+  if (m_IsMapped == true) {
+    // Jump directly to the region, nothing before it is ever touched
+    m_MappedPosition = min<uint64_t>(Begin, m_MappedSize);
+    m_MappedReleased = (m_MappedPosition / sysconf(_SC_PAGESIZE)) * sysconf(_SC_PAGESIZE);
+    m_ReadPosition = m_MappedPosition;
+  } else if (m_IsZipped == false) {
+    m_In.seekg(Begin);
+    m_ReadPosition = Begin;
+  } else {
+    // A gzip'ed stream cannot be seeked - the part before the region is decompressed and skipped without parsing it
+    m_ReadPosition = 0;
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MModuleLoaderMeasurementsBinary::FindReadRegion(const MString& FileName, uint64_t& Begin, uint64_t& End)
+{
+  //! Find the byte region [Begin, End) of the file with the data of the time range (plus warm-up) using the packet index
+  //! Return false if the file has no data within the time range
+
+  Begin = 0;
+  End = numeric_limits<uint64_t>::max();
+
+  MBinaryFlightDataIndex Index;
+  if (Index.Load(FileName) == false) {
+    if (g_Verbosity >= c_Warning) cout<<m_XmlTag<<": Warning: Unable to index file \""<<FileName<<"\" - reading all of it"<<endl;
+    return true;
+  }
+
+  unsigned int Stop = (m_StopTime > 0) ? m_StopTime : numeric_limits<unsigned int>::max();
+  if (Index.FindRegion(m_StartTime, Stop, Begin, End) == false) {
+    return false;
+  }
+
+  // Start earlier, so that the aspect reconstruction and the event buffer are in the same state as when reading the whole file
+  // The events of the warm-up period are not passed on
+  unsigned int WarmUpStart = (m_StartTime > m_WarmUpTime) ? m_StartTime - m_WarmUpTime : 0;
+  uint64_t WarmUpBegin = 0;
+  uint64_t WarmUpEnd = 0;
+  if (Index.FindRegion(WarmUpStart, Stop, WarmUpBegin, WarmUpEnd) == true) {
+    Begin = min(Begin, WarmUpBegin);
+  }
+
+  if (g_Verbosity >= c_Info) cout<<m_XmlTag<<": Reading bytes "<<Begin<<" to "<<End<<" of file \""<<FileName<<"\" for the time range"<<endl;
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MModuleLoaderMeasurementsBinary::IsInTimeRange(unsigned long long TI) const
+{
+  //! Return true if the Unix time of an event (only the lower 24 bits, as in the packet headers) is within the time range
+  //! A start or stop time of 0 means that there is no bound on this side
+
+  uint32_t Lower = TI & 0xffffff;
+
+  // Once a GCU housekeeping packet delivered the upper byte, we can compare the full times
+  if (HasUnixTimeMSB() == true) {
+    uint32_t Time = ((uint32_t) GetUnixTimeMSB() << 24) | Lower;
+    if (m_StartTime > 0 && Time < m_StartTime) return false;
+    if (m_StopTime > 0 && Time > m_StopTime) return false;
+    return true;
+  }
+
+  // With the lower 24 bits alone, the position relative to the range is only unambiguous
+  // if both bounds are known and less than 2^23 s (97 days) apart - otherwise keep the event
+  if (m_StartTime == 0 || m_StopTime == 0 || m_StopTime < m_StartTime || m_StopTime - m_StartTime >= 0x800000) {
+    return true;
+  }
+
+  // The seconds since the start of the time range, wrapped into [-2^23, 2^23)
+  int32_t SinceStart = (int32_t) ((uint32_t) (Lower - m_StartTime) << 8) >> 8;
+
+  return SinceStart >= 0 && SinceStart <= (int32_t) (m_StopTime - m_StartTime);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MModuleLoaderMeasurementsBinary::MapFile(const MString& FileName)
+{
+  //! Memory-map the given uncompressed file, return false if this is not possible
+
+  int Descriptor = open(FileName.Data(), O_RDONLY);
+  if (Descriptor < 0) return false;
+
+  struct stat Status;
+  if (fstat(Descriptor, &Status) != 0 || S_ISREG(Status.st_mode) == false) {
+    close(Descriptor);
+    return false;
+  }
+
+  m_MappedSize = Status.st_size;
+  m_MappedPosition = 0;
+  m_MappedReleased = 0;
+  m_MappedData = nullptr;
+
+  // An empty file cannot be mapped but is just a file without chunks
+  if (m_MappedSize > 0) {
+    void* Mapping = mmap(nullptr, m_MappedSize, PROT_READ, MAP_PRIVATE, Descriptor, 0);
+    if (Mapping == MAP_FAILED) {
+      close(Descriptor);
+      m_MappedSize = 0;
+      if (g_Verbosity >= c_Warning) cout<<m_XmlTag<<": Warning: unable to memory-map file \""<<FileName<<"\" - reading it as stream"<<endl;
+      return false;
+    }
+    // We read front to back exactly once, so let the kernel read ahead aggressively
+    madvise(Mapping, m_MappedSize, MADV_SEQUENTIAL);
+    m_MappedData = static_cast<const uint8_t*>(Mapping);
+  }
+
+  // The mapping stays valid after closing the descriptor
+  close(Descriptor);
+
+  m_IsMapped = true;
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModuleLoaderMeasurementsBinary::UnmapFile()
+{
+  //! Release the memory mapping of the current file (if there is any)
+
+  if (m_MappedData != nullptr) {
+    munmap(const_cast<uint8_t*>(m_MappedData), m_MappedSize);
+  }
+  m_IsMapped = false;
+  m_MappedData = nullptr;
+  m_MappedSize = 0;
+  m_MappedPosition = 0;
+  m_MappedReleased = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+size_t MModuleLoaderMeasurementsBinary::ReadNextChunk(const uint8_t*& Data)
+{
+  //! Return the next chunk of the currently open file in Data, and its size (0 if the file is exhausted)
+  //! Only the part of the file within the read region is returned
+
+  Data = nullptr;
+
+  while (m_ReadPosition < m_ReadEnd) {
+    size_t Size = ReadChunk(Data);
+    if (Size == 0) return 0;
+
+    uint64_t ChunkBegin = m_ReadPosition;
+    m_ReadPosition += Size;
+
+    // Only gzip'ed files are read from the beginning
+    if (m_ReadPosition <= m_ReadBegin) continue;
+
+    if (ChunkBegin < m_ReadBegin) {
+      Data += m_ReadBegin - ChunkBegin;
+      Size -= m_ReadBegin - ChunkBegin;
+    }
+    if (m_ReadPosition > m_ReadEnd) {
+      Size -= m_ReadPosition - m_ReadEnd;
+    }
+    return Size;
+  }
+
+  Data = nullptr;
+  return 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+size_t MModuleLoaderMeasurementsBinary::ReadChunk(const uint8_t*& Data)
+{
+  //! Return the next chunk of the currently open file like ReadNextChunk(), but ignoring the read region
+
+  Data = nullptr;
+
+  if (m_IsMapped == true) {
+    // Drop the pages of the previous chunks, the parser has its own copy of the unused bytes
+    // This keeps the resident memory bounded for multi-GB files
+    size_t PageSize = sysconf(_SC_PAGESIZE);
+    size_t Release = (m_MappedPosition / PageSize) * PageSize;
+    if (Release > m_MappedReleased) {
+      madvise(const_cast<uint8_t*>(m_MappedData) + m_MappedReleased, Release - m_MappedReleased, MADV_DONTNEED);
+      m_MappedReleased = Release;
+    }
+
+    size_t Size = min(c_ChunkSize, m_MappedSize - m_MappedPosition);
+    if (Size > 0) {
+      Data = m_MappedData + m_MappedPosition;
+      m_MappedPosition += Size;
+    }
+    return Size;
+  }
+
+  if (m_IsZipped == true) {
+    size_t Size = m_ZipReader.Read(Data);
+    if (Size == 0) {
+      if (m_ZipReader.HasError() == true) {
+        if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: unable to decompress file \""<<m_BinaryFileNames[m_OpenFileID]<<"\" completely"<<endl;
+      }
+      m_ZipReader.Close();
+    }
+    return Size;
+  }
+
+  if (m_In.is_open() == false) return 0;
+  if (m_ReadBuffer.size() != c_ChunkSize) m_ReadBuffer.resize(c_ChunkSize);
+
+  m_In.read(reinterpret_cast<char*>(m_ReadBuffer.data()), c_ChunkSize);
+  size_t Size = m_In.gcount();
+  if (Size > 0) Data = m_ReadBuffer.data();
+
+  return Size;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 
 
@@ -162,6 +543,12 @@ bool MModuleLoaderMeasurementsBinary::Initialize()
 
 	m_FileIsDone = false;
   m_BinaryFileNames.clear();
+
+  // A start time of 0 reads from the beginning, a stop time of 0 to the end
+  if (m_StartTime > 0 && m_StopTime > 0 && m_StopTime < m_StartTime) {
+    if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: The stop time ("<<m_StopTime<<") is before the start time ("<<m_StartTime<<")"<<endl;
+    return false;
+  }
   m_OpenFileID = -1;
 
 	if (m_In.is_open()) m_In.close();
@@ -209,8 +596,18 @@ bool MModuleLoaderMeasurementsBinary::Initialize()
     m_BinaryFileNames.push_back(m_FileName);
   }
   
-  if (OpenNextFile() == false) {
-    if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: unable to open the file \""<<m_BinaryFileNames[m_OpenFileID]<<"\""<<endl;
+  CloseAllFiles();
+  if (m_ReadFilesConcurrently == true && m_BinaryFileNames.size() > 1) {
+    if (OpenAllFiles() == false) {
+      if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: unable to open the files, or none of them has data within the time range"<<endl;
+      return false;
+    }
+  } else if (OpenNextFile() == false) {
+    if (m_OpenFileID >= (int) m_BinaryFileNames.size()) {
+      if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: none of the files has data within the time range"<<endl;
+    } else {
+      if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: unable to open the file \""<<m_BinaryFileNames[m_OpenFileID]<<"\""<<endl;
+    }
     return false;
   }
 
@@ -219,7 +616,7 @@ bool MModuleLoaderMeasurementsBinary::Initialize()
   if (m_HousekeepingFileName.Last('.') != string::npos) {
     m_HousekeepingFileName.RemoveInPlace(m_HousekeepingFileName.Last('.'), m_HousekeepingFileName.Length() - m_HousekeepingFileName.Last('.'));
   }
-  m_HousekeepingFileName += ".hkp";
+  m_HousekeepingFileName += (GetBinaryHousekeeping() == true) ? ".hkb" : ".hkp";
 
 	if (MBinaryFlightDataParser::Initialize() == false) {
     if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: Unable to initilize flight data parser"<<endl;
@@ -236,6 +633,14 @@ bool MModuleLoaderMeasurementsBinary::Initialize()
 
 bool MModuleLoaderMeasurementsBinary::IsReady() 
 {
+	// Drop the events of the warm-up period and those after the time range
+	if (HasTimeRange() == true) {
+		while (m_Events.size() > 0 && IsInTimeRange(m_Events[0]->GetTI()) == false) {
+			MObjectPool<MReadOutAssembly>::Release(m_Events[0]);
+			m_Events.pop_front();
+		}
+	}
+
 	if (m_Events.size() > 0) {
 		if (GetAspectMode() == MBinaryFlightDataParserAspectModes::c_Neither) {
 			return true;
@@ -247,91 +652,38 @@ bool MModuleLoaderMeasurementsBinary::IsReady()
 		}
 	}
 
-	//unsigned int Size = 1000000; // We have to do a large chunk here or the main thread is going to sleep...
-	//vector<char> Stream(Size);
-	// Check if we reached the end of the file, if yes, truncate, and set the OK flag to false
-	// when the end of the file is reached, we want to 
-
-	//AWL restructured this so that we don't allocate/fill a 1MB array when there is nothing to read.  
+	// Uncompressed files are memory-mapped and the parser gets views into the mapping,
+	// all other files are read chunk by chunk into a reused buffer
 
-	vector<char> Stream;
-	unsigned int Size = 1000000;
-	streamsize Read;
-	if (m_FileIsDone == true) {
-		Read = 0;
-	} else {
-		Stream.reserve(Size);
-    if (m_IsZipped == false) {
-      m_In.read(&Stream[0], Size);
-      Read = m_In.gcount();
-    } else {
-      Read = 0;
-      for (unsigned int i = 0; i < Size; ++i) {
-        int c = gzgetc(m_ZipFile);
-        if (c == -1) {
-          break;
-        }
-        Stream[i] = (char) c;
-        Read = i+1;
-      }
-    }
+	const uint8_t* Data = nullptr;
+	size_t Read = 0;
+	if (m_FileIsDone == false) {
+		if (m_FileReaders.size() > 0) {
+			Read = ReadMergedChunk(Data);
+		} else {
+			Read = ReadNextChunk(Data);
+		}
 	}
 
 	// If we do not read anything, try again with the next file
-  if (Read == 0) {
+  if (Read == 0 && m_FileIsDone == false && m_FileReaders.size() == 0) {
     if (OpenNextFile() == true) {
-      Stream.reserve(Size);
-      if (m_IsZipped == false) {
-        m_In.read(&Stream[0], Size);
-        Read = m_In.gcount();
-      } else {
-        Read = 0;
-        for (unsigned int i = 0; i < Size; ++i) {
-          int c = gzgetc(m_ZipFile);
-          if (c == -1) {
-            break;
-          }
-          Stream[i] = (char) c;
-          Read = i+1;
-        }
-      }  
+      Read = ReadNextChunk(Data);
     }
   }
 
-	/*
-		if (Read < Size) {
-		m_IsOK = false;
-		}
-	 */
-
-	/*
-	if (Read < Size) {
-		m_FileIsDone = true;
-		SetIsDone(true);
-	}
-	*/
-
 	if (Read == 0) {
 		m_FileIsDone = true;
 		SetIsDone(true);
 	}
 
 
-	if (m_FileIsDone  == true && m_EventsBuf.size() == 0) {
+	if (m_FileIsDone  == true && m_EventsBuf.IsEmpty() == true) {
 		//m_IsOK = false;
 		m_IsFinished = true;
 	}
 
-	vector<uint8_t> Received(Read);
-	for (unsigned int i = 0; i < Read; ++i) {
-		// cout << "char: " << Received[i] << endl;
-		//	 printf("char:%02X\n",(uint8_t)Stream[i]);
-		Received[i] = (uint8_t) Stream[i];
-	}
-
-	//cout<<"Received: "<<Received.size()<<endl;
-	
-	return ParseData(Received);
+	return ParseData(Data, Read);
 }
 
 
@@ -391,21 +743,18 @@ bool MModuleLoaderMeasurementsBinary::AnalyzeEvent(MReadOutAssembly* Event)
 
 	// This checks if the event's aspect data was within the range of the retrieved aspect info
 	if (NewEvent->GetAspect() != 0 && NewEvent->GetAspect()->GetOutOfRange()) {
-		delete NewEvent;
+		MObjectPool<MReadOutAssembly>::Release(NewEvent);
 		return false;
 	}
 
 	//transfer over strip hits that have ADC
-	while (NewEvent->GetNStripHits() > 0) {
-		Event->AddStripHit( NewEvent->GetStripHit(0) );
-		NewEvent->RemoveStripHit(0);
-	}
+	Event->TakeStripHits(NewEvent);
 
 	//transfer over strip hits that have timing and no ADC
-	while (NewEvent->GetNStripHitsTOnly() > 0){
-		Event->AddStripHitTOnly( NewEvent->GetStripHitTOnly(0));
-		NewEvent->RemoveStripHitTOnly(0);
-	}
+	Event->TakeStripHitsTOnly(NewEvent);
+
+	//transfer over guard ring hits
+	Event->TakeGuardringHits(NewEvent);
 
 
 	Event->SetID( NewEvent->GetID() );
@@ -440,7 +789,7 @@ bool MModuleLoaderMeasurementsBinary::AnalyzeEvent(MReadOutAssembly* Event)
 		Event->SetTimeIncomplete(true);
 	}
 
-	delete NewEvent;
+	MObjectPool<MReadOutAssembly>::Release(NewEvent);
 
 	return true;
 }
@@ -458,6 +807,17 @@ void MModuleLoaderMeasurementsBinary::Finalize()
 
 	m_In.close();
 	m_In.clear();
+	UnmapFile();
+	m_ZipReader.Close();
+	CloseAllFiles();
+
+	if (g_Verbosity >= c_Info) {
+		cout<<m_XmlTag<<": Objects held in pool: "
+		    <<MObjectPool<MReadOutAssembly>::GetNObjects()<<" read-out assemblies, "
+		    <<MObjectPool<MStripHit>::GetNObjects()<<" strip hits (allocated: "
+		    <<MObjectPool<MStripHit>::GetNAllocations()<<", recycled: "
+		    <<MObjectPool<MStripHit>::GetNRecycled()<<")"<<endl;
+	}
 
 	return;
 }
@@ -503,6 +863,36 @@ bool MModuleLoaderMeasurementsBinary::ReadXmlConfiguration(MXmlNode* Node)
 		m_CoincidenceEnabled = (bool) CoincidenceMergingNode->GetValueAsInt();
 	}
 
+	MXmlNode* DecodeThreadsNode = Node->GetNode("DecodeThreads");
+	if( DecodeThreadsNode != NULL ){
+		SetNDecodeThreads(DecodeThreadsNode->GetValueAsUnsignedInt());
+	}
+
+	MXmlNode* StartTimeNode = Node->GetNode("StartTime");
+	if( StartTimeNode != NULL ){
+		m_StartTime = StartTimeNode->GetValueAsUnsignedInt();
+	}
+
+	MXmlNode* StopTimeNode = Node->GetNode("StopTime");
+	if( StopTimeNode != NULL ){
+		m_StopTime = StopTimeNode->GetValueAsUnsignedInt();
+	}
+
+	MXmlNode* WarmUpTimeNode = Node->GetNode("WarmUpTime");
+	if( WarmUpTimeNode != NULL ){
+		m_WarmUpTime = WarmUpTimeNode->GetValueAsUnsignedInt();
+	}
+
+	MXmlNode* ReadFilesConcurrentlyNode = Node->GetNode("ReadFilesConcurrently");
+	if( ReadFilesConcurrentlyNode != NULL ){
+		m_ReadFilesConcurrently = ReadFilesConcurrentlyNode->GetValueAsBoolean();
+	}
+
+	MXmlNode* BinaryHousekeepingNode = Node->GetNode("BinaryHousekeeping");
+	if( BinaryHousekeepingNode != NULL ){
+		SetBinaryHousekeeping(BinaryHousekeepingNode->GetValueAsBoolean());
+	}
+
 
 	return true;
 }
@@ -520,6 +910,12 @@ MXmlNode* MModuleLoaderMeasurementsBinary::CreateXmlConfiguration()
 	new MXmlNode(Node, "DataSelectionMode", (unsigned int) m_DataSelectionMode);
 	new MXmlNode(Node, "AspectSelectionMode", (unsigned int) m_AspectMode);
 	new MXmlNode(Node, "CoincidenceMerging",(unsigned int) m_CoincidenceEnabled);
+	new MXmlNode(Node, "DecodeThreads", GetNDecodeThreads());
+	new MXmlNode(Node, "StartTime", m_StartTime);
+	new MXmlNode(Node, "StopTime", m_StopTime);
+	new MXmlNode(Node, "WarmUpTime", m_WarmUpTime);
+	new MXmlNode(Node, "ReadFilesConcurrently", m_ReadFilesConcurrently);
+	new MXmlNode(Node, "BinaryHousekeeping", GetBinaryHousekeeping());
 
 	return Node;
 }
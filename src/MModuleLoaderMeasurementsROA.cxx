@@ -40,6 +40,9 @@
 #include "MReadOutDataTiming.h"
 #include "MReadOutDataOrigins.h"
 
+// Nuclearizer libs:
+#include "MObjectPool.h"
+
 ////////////////////////////////////////////////////////////////////////////////
 
 
@@ -138,6 +141,10 @@ void MModuleLoaderMeasurementsROA::Finalize()
   cout<<"MModuleLoaderMeasurementsROA: "<<endl;
   cout<<"  * all events on file: "<<m_NEventsInFile<<endl;
   cout<<"  * good events on file: "<<m_NGoodEventsInFile<<endl;
+  if (g_Verbosity >= c_Info) {
+    cout<<"  * strip hits held in pool: "<<MObjectPool<MStripHit>::GetNObjects()
+        <<" (allocated: "<<MObjectPool<MStripHit>::GetNAllocations()<<", recycled: "<<MObjectPool<MStripHit>::GetNRecycled()<<")"<<endl;
+  }
 
   m_ROAFile.Close();  
 }
@@ -189,7 +196,7 @@ bool MModuleLoaderMeasurementsROA::ReadNextEvent(MReadOutAssembly* Event)
       dynamic_cast<const MReadOutDataOrigins*>(RO.GetReadOutData().Get(MReadOutDataOrigins::m_TypeID));
     
     
-    MStripHit* SH = new MStripHit();
+    MStripHit* SH = MObjectPool<MStripHit>::Get();
     SH->SetDetectorID(Strip->GetDetectorID());
     SH->IsXStrip(Strip->IsPositiveStrip());
     SH->SetStripID(Strip->GetStripID());
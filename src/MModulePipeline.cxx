@@ -0,0 +1,348 @@
+/*
+ * MModulePipeline.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MModulePipeline
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MModulePipeline.h"
+
+// Standard libs:
+#include <thread>
+#include <chrono>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MStreams.h"
+#include "MXmlNode.h"
+#include "MDGeometryQuest.h"
+
+// Nuclearizer libs:
+#include "MBatchAnalyzer.h"
+#include "MObjectPool.h"
+#include "MModulePipelineStage.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MModulePipeline)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MModulePipeline::MModulePipeline() : m_BatchSize(64), m_NReplicas(0), m_ReorderSize(8), m_Geometry(nullptr), m_Interrupt(false), m_NLoadedEvents(0), m_NAnalyzedEvents(0)
+{
+  // Construct an instance of MModulePipeline
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MModulePipeline::~MModulePipeline()
+{
+  // Delete this instance of MModulePipeline - the modules are owned by the supervisor
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MModulePipeline::Analyze()
+{
+  //! Initialize all modules, run the analysis until the loader is finished, and finalize all modules
+
+  if (m_Modules.size() == 0) {
+    if (g_Verbosity >= c_Error) cout<<"Pipeline: Error: No modules"<<endl;
+    return false;
+  }
+
+  if (m_Geometry != nullptr) {
+    for (MModule* M: m_Modules) {
+      M->SetGeometry(m_Geometry);
+    }
+  }
+
+  for (MModule* M: m_Modules) {
+    if (M->Initialize() == false) {
+      if (g_Verbosity >= c_Error) cout<<"Pipeline: Error: Unable to initialize module "<<M->GetName()<<endl;
+      return false;
+    }
+  }
+
+  m_NLoadedEvents = 0;
+  m_NAnalyzedEvents = 0;
+
+  vector<MString> Names;
+  for (MModule* M: m_Modules) {
+    Names.push_back(M->GetName());
+  }
+  m_Statistics.Initialize(Names);
+  m_LocalStatistics.assign(m_Modules.size(), MModuleStatistics());
+  m_LastMerges.assign(m_Modules.size(), chrono::steady_clock::now());
+
+  bool Return = true;
+  if (m_NReplicas > 0 && m_Modules.size() > 1) {
+    Return = AnalyzeParallel();
+  } else {
+    AnalyzeSequential();
+  }
+
+  for (unsigned int m = 0; m < m_Modules.size(); ++m) {
+    m_Statistics.Merge(m, m_LocalStatistics[m]);
+  }
+  m_Statistics.Stop();
+
+  for (MModule* M: m_Modules) {
+    M->Finalize();
+  }
+
+  if (m_StatisticsFileName != "") {
+    if (m_Statistics.WriteSummary(m_StatisticsFileName) == true) {
+      if (g_Verbosity >= c_Info) cout<<"Pipeline: Statistics written to "<<m_StatisticsFileName<<endl;
+    }
+  }
+
+  if (g_Verbosity >= c_Info) {
+    cout<<"Pipeline: "<<m_NLoadedEvents<<" events loaded, "<<m_NAnalyzedEvents<<" passed all modules (batch size: "<<m_BatchSize<<", replicas: "<<m_NReplicas<<")"<<endl;
+  }
+
+  return Return;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModulePipeline::AnalyzeSequential()
+{
+  //! Run the loop with all modules in the calling thread
+
+  vector<MReadOutAssembly*> Batch;
+  Batch.reserve(m_BatchSize);
+
+  bool LoaderIsFinished = false;
+  while (m_Interrupt == false && LoaderIsFinished == false) {
+    LoaderIsFinished = !LoadBatch(Batch);
+
+    for (unsigned int m = 1; m < m_Modules.size() && Batch.size() > 0; ++m) {
+      AnalyzeBatch(m, Batch);
+    }
+
+    m_NAnalyzedEvents += Batch.size();
+    for (MReadOutAssembly* E: Batch) {
+      MObjectPool<MReadOutAssembly>::Release(E);
+    }
+    Batch.clear();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MModulePipeline::AnalyzeParallel()
+{
+  //! Run the loop with one stage thread per module and clones of the replicable modules
+  //! The loader stays in the calling thread and numbers the batches
+
+  bool Return = true;
+
+  // Create the stages - the loader and all stateful modules (e.g. the event saver) stay single-instance
+  vector<MModulePipelineStage*> Stages;
+  for (unsigned int m = 1; m < m_Modules.size(); ++m) {
+    vector<MModule*> Instances;
+    Instances.push_back(m_Modules[m]);
+    if (MBatchAnalyzer::IsReplicable(m_Modules[m]) == true) {
+      for (unsigned int r = 1; r < m_NReplicas; ++r) {
+        MModule* Replica = CreateReplica(m_Modules[m]);
+        if (Replica == nullptr) {
+          Return = false;
+          break;
+        }
+        Instances.push_back(Replica);
+      }
+    }
+    if (g_Verbosity >= c_Info) cout<<"Pipeline: Running "<<Instances.size()<<" instance(s) of module "<<m_Modules[m]->GetName()<<endl;
+    m_Statistics.SetNInstances(m, Instances.size());
+    Stages.push_back(new MModulePipelineStage(Instances, 2*m_NReplicas, m_ReorderSize));
+    Stages.back()->SetStatistics(&m_Statistics, m);
+  }
+
+  if (Return == true) {
+    for (unsigned int s = 0; s + 1 < Stages.size(); ++s) {
+      Stages[s]->SetNext(Stages[s+1]);
+    }
+    for (MModulePipelineStage* S: Stages) {
+      S->Start();
+    }
+
+    unsigned long Number = 0;
+    bool LoaderIsFinished = false;
+    while (m_Interrupt == false && LoaderIsFinished == false) {
+      vector<MReadOutAssembly*>* Batch = new vector<MReadOutAssembly*>();
+      Batch->reserve(m_BatchSize);
+      LoaderIsFinished = !LoadBatch(*Batch);
+      if (Batch->size() > 0) {
+        Stages.front()->Push(Number++, Batch);
+      } else {
+        delete Batch;
+      }
+    }
+
+    // Closing the first stage drains the whole chain
+    Stages.front()->Close();
+    for (MModulePipelineStage* S: Stages) {
+      S->Join();
+    }
+    m_NAnalyzedEvents = Stages.back()->GetNPassedEvents();
+  }
+
+  for (MModulePipelineStage* S: Stages) {
+    delete S;
+  }
+
+  // The originals are finalized afterwards, thus they report the counters of all instances
+  for (unsigned int r = 0; r < m_Replicas.size(); ++r) {
+    MBatchAnalyzer::MergeReplica(m_ReplicaOriginals[r], m_Replicas[r]);
+    m_Replicas[r]->Finalize();
+    delete m_Replicas[r];
+  }
+  m_Replicas.clear();
+  m_ReplicaOriginals.clear();
+
+  return Return;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MModule* MModulePipeline::CreateReplica(MModule* Module)
+{
+  //! Create a clone of the module with the same configuration
+
+  MModule* Replica = Module->Clone();
+  MBatchAnalyzer::SetIsReplica(Replica);
+  MXmlNode* Configuration = Module->CreateXmlConfiguration();
+  bool IsConfigured = Replica->ReadXmlConfiguration(Configuration);
+  delete Configuration;
+
+  if (m_Geometry != nullptr) {
+    Replica->SetGeometry(m_Geometry);
+  }
+
+  if (IsConfigured == false || Replica->Initialize() == false) {
+    if (g_Verbosity >= c_Error) cout<<"Pipeline: Error: Unable to create a replica of module "<<Module->GetName()<<endl;
+    delete Replica;
+    return nullptr;
+  }
+
+  m_Replicas.push_back(Replica);
+  m_ReplicaOriginals.push_back(Module);
+
+  return Replica;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MModulePipeline::LoadBatch(vector<MReadOutAssembly*>& Batch)
+{
+  //! Fill the batch from the loader - returns false if the loader is finished
+  //! If the loader has no data yet, a partial batch is handed on to keep the latency low
+
+  MModule* Loader = m_Modules[0];
+  MModuleStatistics& Statistics = m_LocalStatistics[0];
+
+  // The time in IsReady() counts as blocked time: loaders such as the receiver do their
+  // reading and parsing there, and without data it is where the loader waits
+  bool IsFinished = false;
+  while (Batch.size() < m_BatchSize && m_Interrupt == false) {
+    chrono::steady_clock::time_point ReadyStart = chrono::steady_clock::now();
+    bool IsReady = Loader->IsReady();
+    Statistics.AddBlockedTime(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - ReadyStart).count());
+    if (IsReady == true) {
+      MReadOutAssembly* E = MObjectPool<MReadOutAssembly>::Get();
+      chrono::steady_clock::time_point Start = chrono::steady_clock::now();
+      bool IsAccepted = Loader->AnalyzeEvent(E);
+      Statistics.AddCall(1, IsAccepted ? 1 : 0, chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - Start).count());
+      if (IsAccepted == true) {
+        Batch.push_back(E);
+        ++m_NLoadedEvents;
+      } else {
+        MObjectPool<MReadOutAssembly>::Release(E);
+      }
+    } else if (Loader->IsFinished() == true) {
+      IsFinished = true;
+      break;
+    } else if (Batch.size() > 0) {
+      break;
+    } else {
+      chrono::steady_clock::time_point Start = chrono::steady_clock::now();
+      this_thread::sleep_for(chrono::milliseconds(1));
+      Statistics.AddBlockedTime(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - Start).count());
+    }
+  }
+
+  m_Statistics.MergeIfDue(0, Statistics, m_LastMerges[0]);
+
+  return !IsFinished;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModulePipeline::AnalyzeBatch(unsigned int m, vector<MReadOutAssembly*>& Batch)
+{
+  //! Pass the batch through module m, dropping the events the module rejects
+
+  chrono::steady_clock::time_point Start = chrono::steady_clock::now();
+  MBatchAnalyzer::AnalyzeEvents(m_Modules[m], Batch, m_Results);
+  uint64_t Time = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - Start).count();
+
+  unsigned int Kept = 0;
+  for (unsigned int e = 0; e < Batch.size(); ++e) {
+    if (m_Results[e] == true) {
+      Batch[Kept++] = Batch[e];
+    } else {
+      MObjectPool<MReadOutAssembly>::Release(Batch[e]);
+    }
+  }
+
+  m_LocalStatistics[m].AddCall(Batch.size(), Kept, Time);
+  m_Statistics.MergeIfDue(m, m_LocalStatistics[m], m_LastMerges[m]);
+
+  Batch.resize(Kept);
+}
+
+
+// MModulePipeline.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,240 @@
+/*
+ * MModulePipelineStage.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MModulePipelineStage
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MModulePipelineStage.h"
+
+// Standard libs:
+#include <chrono>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MStreams.h"
+
+// Nuclearizer libs:
+#include "MBatchAnalyzer.h"
+#include "MObjectPool.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MModulePipelineStage)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MModulePipelineStage::MModulePipelineStage(const vector<MModule*>& Instances, unsigned int QueueSize, unsigned int ReorderSize)
+  : m_Instances(Instances), m_Next(nullptr), m_IsClosed(false), m_NextNumber(0), m_NReordered(0), m_Statistics(nullptr), m_ModuleIndex(0), m_NRunning(0), m_NPassedEvents(0)
+{
+  // Construct an instance of MModulePipelineStage
+
+  m_QueueSize = (QueueSize > 0) ? QueueSize : 1;
+  // An instance must always be able to work on the next batch to deliver
+  m_ReorderSize = (ReorderSize > m_Instances.size()) ? ReorderSize : m_Instances.size();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MModulePipelineStage::~MModulePipelineStage()
+{
+  // Delete this instance of MModulePipelineStage - the modules are not owned
+
+  Join();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModulePipelineStage::Start()
+{
+  //! Start the threads of all instances
+
+  m_NRunning = m_Instances.size();
+  for (unsigned int i = 0; i < m_Instances.size(); ++i) {
+    m_Threads.push_back(new thread(&MModulePipelineStage::Run, this, i));
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModulePipelineStage::Join()
+{
+  //! Wait until all threads have ended
+
+  for (thread* T: m_Threads) {
+    T->join();
+    delete T;
+  }
+  m_Threads.clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModulePipelineStage::Push(unsigned long Number, vector<MReadOutAssembly*>* Batch)
+{
+  //! Add the batch with the given number - blocks while the input queue is full
+
+  unique_lock<mutex> Lock(m_QueueMutex);
+  m_QueueCondition.wait(Lock, [this] { return m_Queue.size() < m_QueueSize; });
+  m_Queue.push_back(make_pair(Number, Batch));
+  Lock.unlock();
+
+  m_QueueCondition.notify_all();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModulePipelineStage::Close()
+{
+  //! Signal that no more batches will arrive
+
+  {
+    lock_guard<mutex> Lock(m_QueueMutex);
+    m_IsClosed = true;
+  }
+  m_QueueCondition.notify_all();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModulePipelineStage::Run(unsigned int i)
+{
+  //! The loop of the thread of instance i
+
+  MModule* Module = m_Instances[i];
+  vector<bool> Results;
+
+  // Each thread counts on its own and merges from time to time
+  MModuleStatistics Statistics;
+  chrono::steady_clock::time_point LastMerge = chrono::steady_clock::now();
+
+  while (true) {
+    unique_lock<mutex> Lock(m_QueueMutex);
+    // Wait for a batch, but do not run further ahead of the delivery than the reorder buffer allows
+    m_QueueCondition.wait(Lock, [this] {
+      return (m_Queue.empty() == false && m_Queue.front().first < m_NextNumber + m_ReorderSize) ||
+             (m_Queue.empty() == true && m_IsClosed == true);
+    });
+    if (m_Queue.empty() == true) break;
+
+    Statistics.AddQueueOccupancy(m_Queue.size(), m_NReordered);
+    unsigned long Number = m_Queue.front().first;
+    vector<MReadOutAssembly*>* Batch = m_Queue.front().second;
+    m_Queue.pop_front();
+    Lock.unlock();
+    m_QueueCondition.notify_all();
+
+    if (Batch->size() > 0) {
+      chrono::steady_clock::time_point Start = chrono::steady_clock::now();
+      MBatchAnalyzer::AnalyzeEvents(Module, *Batch, Results);
+      uint64_t Time = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - Start).count();
+
+      unsigned int Kept = 0;
+      for (unsigned int e = 0; e < Batch->size(); ++e) {
+        if (Results[e] == true) {
+          (*Batch)[Kept++] = (*Batch)[e];
+        } else {
+          MObjectPool<MReadOutAssembly>::Release((*Batch)[e]);
+        }
+      }
+      Statistics.AddCall(Batch->size(), Kept, Time);
+      Batch->resize(Kept);
+    }
+
+    Deliver(Number, Batch);
+
+    if (m_Statistics != nullptr) {
+      m_Statistics->MergeIfDue(m_ModuleIndex, Statistics, LastMerge);
+    }
+  }
+
+  if (m_Statistics != nullptr) {
+    m_Statistics->Merge(m_ModuleIndex, Statistics);
+  }
+
+  // The last instance to end closes the next stage
+  if (--m_NRunning == 0 && m_Next != nullptr) {
+    m_Next->Close();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModulePipelineStage::Deliver(unsigned long Number, vector<MReadOutAssembly*>* Batch)
+{
+  //! Put an analyzed batch into the reorder buffer and hand on all batches which are next in line
+  //! The whole delivery happens under the reorder mutex, thus the order is kept even with several instances
+
+  {
+    lock_guard<mutex> Lock(m_ReorderMutex);
+    m_Reorder[Number] = Batch;
+    ++m_NReordered;
+
+    while (m_Reorder.empty() == false && m_Reorder.begin()->first == m_NextNumber) {
+      vector<MReadOutAssembly*>* Next = m_Reorder.begin()->second;
+      m_Reorder.erase(m_Reorder.begin());
+      --m_NReordered;
+
+      if (m_Next != nullptr) {
+        m_Next->Push(m_NextNumber, Next);
+      } else {
+        m_NPassedEvents += Next->size();
+        for (MReadOutAssembly* E: *Next) {
+          MObjectPool<MReadOutAssembly>::Release(E);
+        }
+        delete Next;
+      }
+      ++m_NextNumber;
+    }
+  }
+
+  // Instances waiting for the reorder window to advance can continue
+  // (passing through the queue mutex avoids a lost wake-up between their check and their wait)
+  { lock_guard<mutex> Lock(m_QueueMutex); }
+  m_QueueCondition.notify_all();
+}
+
+
+// MModulePipelineStage.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
@@ -31,6 +31,7 @@
 // Standard libs:
 #include <algorithm>
 #include <cstdio>
+#include <chrono>
 using namespace std;
 #include <time.h>
 
@@ -40,6 +41,7 @@ using namespace std;
 // MEGAlib libs:
 #include "MGUIOptionsReceiverBalloon.h"
 #include "MGUIExpoReceiver.h"
+#include "MObjectPool.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -53,7 +55,7 @@ ClassImp(MModuleReceiverBalloon)
 ////////////////////////////////////////////////////////////////////////////////
 
 
-MModuleReceiverBalloon::MModuleReceiverBalloon() : MModule(), MBinaryFlightDataParser()
+MModuleReceiverBalloon::MModuleReceiverBalloon() : MModule(), MBinaryFlightDataParser(), m_ReceiveQueue(c_ReceiveQueueSize)
 {
   // Construct an instance of MModuleReceiverBalloon
 
@@ -87,6 +89,9 @@ MModuleReceiverBalloon::MModuleReceiverBalloon() : MModule(), MBinaryFlightDataP
   
   m_Receiver = 0;
   m_ReceivedData = 0;
+  m_ReceiveThread = nullptr;
+  m_StopReceiving = false;
+  m_ReceiveStallTime = 0;
   
   // Allow the use of multiple threads and instances
   m_AllowMultiThreading = true;
@@ -105,6 +110,8 @@ MModuleReceiverBalloon::MModuleReceiverBalloon() : MModule(), MBinaryFlightDataP
 MModuleReceiverBalloon::~MModuleReceiverBalloon()
 {
   // Delete this instance of MModuleReceiverBalloon
+
+  StopReceiving();
 }
 
 
@@ -257,6 +264,7 @@ bool MModuleReceiverBalloon::RequestConnection()
   
   cout<<"Handshake: Connecting to receiver "<<m_LocalReceivingHostName<<":"<<m_LocalReceivingPort<<endl;
   // Set up the transceiver and connect:
+  StopReceiving();
   delete m_Receiver;
   m_Receiver = new MTransceiverTcpIpBinary("Final receiver", m_LocalReceivingHostName, m_LocalReceivingPort);
   m_Receiver->SetVerbosity(3);
@@ -264,6 +272,8 @@ bool MModuleReceiverBalloon::RequestConnection()
   m_Receiver->RequestClient(true);
   m_Receiver->Connect(true, 10);
   
+  StartReceiving();
+  
   return true;
 }
 
@@ -274,6 +284,7 @@ bool MModuleReceiverBalloon::RequestConnection()
 bool MModuleReceiverBalloon::EndConnection()
 {
   // First kill the receiver
+  StopReceiving();
   if (m_Receiver != 0) {
     m_Receiver->Disconnect();
     delete m_Receiver;
@@ -359,6 +370,10 @@ bool MModuleReceiverBalloon::Initialize()
 {
   // Initialize the module 
 
+  StopReceiving();
+  m_ReceiveQueue.Clear();
+  m_ReceiveStallTime = 0;
+
   // Do handshake and open transceiver
   if (RequestConnection() == false) {
     if (m_Interrupt == true) return false;
@@ -414,31 +429,93 @@ bool MModuleReceiverBalloon::IsReady()
   }
   
   double Timeout = 60; // seconds
-  if (m_Receiver->GetNPacketsToReceive() == 0 && 
+  if (m_ReceiveQueue.GetSize() == 0 &&
+      m_Receiver->GetNPacketsToReceive() == 0 && 
       m_Receiver->GetTimeSinceLastIO().GetElapsed() > Timeout) {
     mout<<"No more packets in receiver, last IO was "<<m_Receiver->GetTimeSinceLastIO().GetElapsed()<<" seconds ago. Assuming broken connection. Redoing handshake..."<<endl;
     EndConnection();
     if (RequestConnection() == false) return false;
   }
   
-  vector<uint8_t> Received ;
-  m_Receiver->Receive(Received);
+  // Collect the blocks queued by the receive thread - at most one queue length per call,
+  // so that a continuous stream cannot keep us from handing on the events - and parse them at once
+  m_ParseBuffer.clear();
+  unsigned int NParsed = 0;
+  while (NParsed < c_ReceiveQueueSize && m_ReceiveQueue.TryPop(m_Block) == true) {
+    if (g_Verbosity >= c_Info) cout<<"Received: "<<m_Block.size()<<" bytes"<<endl;
+    m_ReceivedData += m_Block.size();
+    m_ParseBuffer.insert(m_ParseBuffer.end(), m_Block.begin(), m_Block.end());
+    ++NParsed;
+  }
+  bool Ready = ParseData(m_ParseBuffer);
   
-  if (Received.size() != 0) {
-    if (g_Verbosity >= c_Info) cout<<"Received: "<<Received.size()<<" bytes"<<endl;
-    
-    m_ReceivedData += Received.size();
-    if (HasExpos() == true) {
-      m_ExpoReceiver->SetTimeReceived(MTime());
-      m_ExpoReceiver->SetBytesReceived(m_ReceivedData);
-      m_ExpoReceiver->SetRawFramesParsed(m_NumRawDataframes);
-      m_ExpoReceiver->SetComptonFramesParsed(m_NumComptonDataframes);
-      m_ExpoReceiver->SetAspectFramesParsed(m_NumAspectPackets);
-      m_ExpoReceiver->SetOtherFramesParsed(m_NumOtherPackets);
-    }
+  if (NParsed > 0 && HasExpos() == true) {
+    m_ExpoReceiver->SetTimeReceived(MTime());
+    m_ExpoReceiver->SetStatistics(GetStatistics());
+    m_ExpoReceiver->SetReceiveQueue(m_ReceiveQueue.GetSize(), m_ReceiveQueue.GetMaxSize(), m_ReceiveQueue.GetCapacity(), m_ReceiveQueue.GetNFull(), 1E-9*m_ReceiveStallTime);
   }
   
-  return ParseData(Received);
+  return Ready;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModuleReceiverBalloon::StartReceiving()
+{
+  // Start the receive thread
+
+  if (m_ReceiveThread != nullptr || m_Receiver == 0) return;
+
+  m_StopReceiving = false;
+  m_ReceiveThread = new thread(&MModuleReceiverBalloon::ReceiveLoop, this);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModuleReceiverBalloon::StopReceiving()
+{
+  // Stop the receive thread - the blocks already in the queue stay there
+
+  if (m_ReceiveThread == nullptr) return;
+
+  m_StopReceiving = true;
+  m_ReceiveThread->join();
+  delete m_ReceiveThread;
+  m_ReceiveThread = nullptr;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModuleReceiverBalloon::ReceiveLoop()
+{
+  // The loop of the receive thread: drain the transceiver and queue the received blocks for the parser
+  // Network jitter thus no longer stalls the parser, and a slow parser no longer stops draining the socket
+
+  vector<uint8_t> Block;
+  while (m_StopReceiving == false) {
+    Block.clear();
+    m_Receiver->Receive(Block);
+    if (Block.size() == 0) {
+      this_thread::sleep_for(chrono::milliseconds(1));
+      continue;
+    }
+
+    // Backpressure: the parser is behind - wait for a free slot instead of dropping data
+    if (m_ReceiveQueue.TryPush(Block) == false) {
+      m_ReceiveQueue.AddFull();
+      chrono::steady_clock::time_point Start = chrono::steady_clock::now();
+      while (m_StopReceiving == false && m_ReceiveQueue.TryPush(Block) == false) {
+        this_thread::sleep_for(chrono::microseconds(100));
+      }
+      m_ReceiveStallTime += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - Start).count();
+    }
+  }
 }
 
 
@@ -466,10 +543,7 @@ bool MModuleReceiverBalloon::AnalyzeEvent(MReadOutAssembly* Event)
     Event->SetAspectIncomplete(true);
   }
 
-  while( NewEvent->GetNStripHits() > 0 ){
-    Event->AddStripHit( NewEvent->GetStripHit(0) );
-    NewEvent->RemoveStripHit(0);
-  }
+  Event->TakeStripHits(NewEvent);
 
   Event->SetID( NewEvent->GetID() );
   Event->SetFC( NewEvent->GetFC() );
@@ -505,7 +579,7 @@ bool MModuleReceiverBalloon::AnalyzeEvent(MReadOutAssembly* Event)
     Event->StreamRoa(m_Out);
   }
   
-  delete NewEvent;
+  MObjectPool<MReadOutAssembly>::Release(NewEvent);
   
 
   // TODO: Just *copy* the data from the OLDEST event in the list to this event  
@@ -528,6 +602,11 @@ void MModuleReceiverBalloon::Finalize()
   MModule::Finalize();
   MBinaryFlightDataParser::Finalize();
   
+  if (g_Verbosity >= c_Info) {
+    cout<<"ReceiverBalloon: Received blocks: "<<m_ReceiveQueue.GetNPushed()<<", largest queue occupancy: "<<m_ReceiveQueue.GetMaxSize()<<" of "<<m_ReceiveQueue.GetCapacity()
+        <<", queue full: "<<m_ReceiveQueue.GetNFull()<<" times, waited "<<1E-9*m_ReceiveStallTime<<" sec for the parser"<<endl;
+  }
+  
   if (m_RoaFileName != "") {
     m_Out.close();
   }
@@ -596,6 +675,15 @@ bool MModuleReceiverBalloon::ReadXmlConfiguration(MXmlNode* Node)
     m_RoaFileName = RoaFileNameNode->GetValueAsString();
   }
 
+  MXmlNode* MetricsFileNameNode = Node->GetNode("MetricsFileName");
+  if (MetricsFileNameNode != 0) {
+    m_MetricsFileName = MetricsFileNameNode->GetValueAsString();
+  }
+  MXmlNode* MetricsIntervalNode = Node->GetNode("MetricsInterval");
+  if (MetricsIntervalNode != 0) {
+    m_MetricsInterval = MetricsIntervalNode->GetValueAsDouble();
+  }
+
   return true;
 }
 
@@ -620,6 +708,8 @@ MXmlNode* MModuleReceiverBalloon::CreateXmlConfiguration()
   new MXmlNode(Node, "AspectMode", (unsigned int) m_AspectMode);
 
   new MXmlNode(Node, "RoaFileName", m_RoaFileName);
+  new MXmlNode(Node, "MetricsFileName", m_MetricsFileName);
+  new MXmlNode(Node, "MetricsInterval", m_MetricsInterval);
   
   return Node;
 }
@@ -0,0 +1,157 @@
+/*
+ * MModuleStatistics.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MModuleStatistics
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MModuleStatistics.h"
+
+// Standard libs:
+#include <algorithm>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+
+// Nuclearizer libs:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MModuleStatistics)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MModuleStatistics::MModuleStatistics() : m_NInstances(1)
+{
+  // Construct an instance of MModuleStatistics
+
+  Clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MModuleStatistics::~MModuleStatistics()
+{
+  // Delete this instance of MModuleStatistics
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModuleStatistics::Clear()
+{
+  //! Reset all counters - the name is kept
+
+  m_NCalls = 0;
+  m_NEventsIn = 0;
+  m_NEventsOut = 0;
+  m_ProcessingTime = 0;
+  m_BlockedTime = 0;
+  for (unsigned int b = 0; b < c_NHistogramBins; ++b) {
+    m_Histogram[b] = 0;
+  }
+
+  m_NQueueSamples = 0;
+  m_InputQueueSum = 0;
+  m_InputQueueMax = 0;
+  m_OutputQueueSum = 0;
+  m_OutputQueueMax = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModuleStatistics::AddCall(unsigned int NIn, unsigned int NOut, uint64_t Nanoseconds)
+{
+  //! Add one call of the module with NIn events in, NOut events out, which took the given time
+  //! For a batch all events are entered into the histogram with the mean time per event
+
+  ++m_NCalls;
+  m_NEventsIn += NIn;
+  m_NEventsOut += NOut;
+  m_ProcessingTime += Nanoseconds;
+
+  if (NIn == 0) return;
+
+  uint64_t PerEvent = Nanoseconds / NIn;
+  unsigned int Bin = 0;
+  while (PerEvent > 1 && Bin < c_NHistogramBins - 1) {
+    PerEvent >>= 1;
+    ++Bin;
+  }
+  m_Histogram[Bin] += NIn;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModuleStatistics::AddQueueOccupancy(unsigned int InputQueue, unsigned int OutputQueue)
+{
+  //! Add one sample of the queue occupancies (in batches) seen when a batch was taken
+
+  ++m_NQueueSamples;
+  m_InputQueueSum += InputQueue;
+  m_InputQueueMax = max(m_InputQueueMax, InputQueue);
+  m_OutputQueueSum += OutputQueue;
+  m_OutputQueueMax = max(m_OutputQueueMax, OutputQueue);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModuleStatistics::Merge(const MModuleStatistics& Other)
+{
+  //! Add all counters of Other to this one
+
+  m_NCalls += Other.m_NCalls;
+  m_NEventsIn += Other.m_NEventsIn;
+  m_NEventsOut += Other.m_NEventsOut;
+  m_ProcessingTime += Other.m_ProcessingTime;
+  m_BlockedTime += Other.m_BlockedTime;
+  for (unsigned int b = 0; b < c_NHistogramBins; ++b) {
+    m_Histogram[b] += Other.m_Histogram[b];
+  }
+
+  m_NQueueSamples += Other.m_NQueueSamples;
+  m_InputQueueSum += Other.m_InputQueueSum;
+  m_InputQueueMax = max(m_InputQueueMax, Other.m_InputQueueMax);
+  m_OutputQueueSum += Other.m_OutputQueueSum;
+  m_OutputQueueMax = max(m_OutputQueueMax, Other.m_OutputQueueMax);
+}
+
+
+// MModuleStatistics.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
@@ -34,6 +34,7 @@
 // MEGAlib libs:
 //#include "MMath.h"
 #include "MGUIOptionsStripPairing.h"
+#include "MObjectPool.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -82,6 +83,10 @@ MModuleStripPairingGreedy::MModuleStripPairingGreedy() : MModule()
   m_NMatches = 0;
   m_TotalMatches = 0;
   
+  m_ReasonBadNumberOfStripHits = MReadOutAssembly::InternQualityReason("bad number of strip hits");
+  m_ReasonMultipleHitsPerStrip = MReadOutAssembly::InternQualityReason("multiple hits per strip");
+  m_ReasonBadPairing = MReadOutAssembly::InternQualityReason("bad pairing");
+  
   // Allow the use of multiple threads and instances
   m_AllowMultiThreading = true;
   m_AllowMultipleInstances = true;
@@ -134,6 +139,48 @@ bool MModuleStripPairingGreedy::Initialize()
 //main data analysis routine, which updates the event to a new level
 bool MModuleStripPairingGreedy::AnalyzeEvent(MReadOutAssembly* Event){
 
+  bool Return = PairStrips(Event);
+  FlushExpo();
+
+  return Return;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModuleStripPairingGreedy::AnalyzeEvents(vector<MReadOutAssembly*>& Events, vector<bool>& Results)
+{
+  // Analyze a batch of events - the expo is locked only once per batch
+
+  Results.resize(Events.size());
+  for (unsigned int e = 0; e < Events.size(); ++e) {
+    Results[e] = PairStrips(Events[e]);
+  }
+  FlushExpo();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModuleStripPairingGreedy::FlushExpo()
+{
+  // Hand the collected energies to the expo
+
+  if (m_ExpoPEnergies.size() > 0) {
+    m_ExpoStripPairing->AddEnergies(m_ExpoPEnergies, m_ExpoNEnergies);
+    m_ExpoPEnergies.clear();
+    m_ExpoNEnergies.clear();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MModuleStripPairingGreedy::PairStrips(MReadOutAssembly* Event){
+
 //	usleep(100);
 
   const int nDetectors = 12;
@@ -325,7 +372,7 @@ bool MModuleStripPairingGreedy::AnalyzeEvent(MReadOutAssembly* Event){
 	//flag hits without enough strips
 	for (int det=0; det<12; det++){
 		if (notEnoughStrips[det] == 1 || notEnoughStrips[det] == 2){
-			Event->SetStripPairingIncomplete(true,"bad number of strip hits");
+			Event->SetStripPairingIncomplete(true, m_ReasonBadNumberOfStripHits);
 			break;
 		}
 	}
@@ -333,7 +380,7 @@ bool MModuleStripPairingGreedy::AnalyzeEvent(MReadOutAssembly* Event){
 
 	for (unsigned int h = 0; h < Event->GetNHits(); h++){
 		if (Event->GetHit(h)->GetStripHitMultipleTimesX() == true || Event->GetHit(h)->GetStripHitMultipleTimesY() == true){
-			Event->SetStripPairingIncomplete(true,"multiple hits per strip");
+			Event->SetStripPairingIncomplete(true, m_ReasonMultipleHitsPerStrip);
 		}
 /*
 		if (Event->GetHit(h)->GetChargeSharing() == true){
@@ -374,7 +421,8 @@ bool MModuleStripPairingGreedy::AnalyzeEvent(MReadOutAssembly* Event){
     if (pNStrips > 0 && nNStrips > 0) { // Just a place holder atthe moment...
 			if (Event->GetHit(h)->GetStripHitMultipleTimesX() == false && Event->GetHit(h)->GetStripHitMultipleTimesY() == false) {
         if (HasExpos() == true) {
-          m_ExpoStripPairing->AddEnergies(pEnergy, nEnergy);
+          m_ExpoPEnergies.push_back(pEnergy);
+          m_ExpoNEnergies.push_back(nEnergy);
         }
 			}
     }
@@ -396,7 +444,7 @@ bool MModuleStripPairingGreedy::AnalyzeEvent(MReadOutAssembly* Event){
 
     if (Difference > 2*pUncertainty + 2*nUncertainty + 20) {
 			if (Event->GetHit(h)->GetStripHitMultipleTimesX() == false && Event->GetHit(h)->GetStripHitMultipleTimesY() == false){
-		  	Event->SetStripPairingIncomplete(true,"bad pairing");
+		  	Event->SetStripPairingIncomplete(true, m_ReasonBadPairing);
 			}
 /*			if (nHits[0] != 0 && nHits[1] != 0){
 				PrintXYStripsHitOrig();
@@ -483,17 +531,8 @@ int MModuleStripPairingGreedy::GetEventInfo(MReadOutAssembly* Event, int detecto
   int n_y = 0;
   
   //Find the number of hits per side for this detector
-  for (unsigned int i = 0; i < Event->GetNStripHits(); i++){
-    if (detector == Event->GetStripHit(i)->GetDetectorID()){
-      if (Event->GetStripHit(i)->IsXStrip() == true){
-        n_x += 1;
-      }
-      else {
-        n_y += 1;
-      }
-      
-    }
-  }
+  n_x = Event->GetNStripHits(detector, true);
+  n_y = Event->GetNStripHits(detector, false);
  
 	//no strip hits in detector: different return value
 	// (don't want to flag as bad if there weren't any strip hits...)
@@ -516,48 +555,40 @@ int MModuleStripPairingGreedy::GetEventInfo(MReadOutAssembly* Event, int detecto
  		float xTotalUnc = 0;
 		float yTotalUnc = 0;
 
-    for (unsigned int i=0; i<Event->GetNStripHits(); i++){
-      if (detector == Event->GetStripHit(i)->GetDetectorID()){
-        if (Event->GetStripHit(i)->IsXStrip() == true){
-          xTotalEnergy += Event->GetStripHit(i)->GetEnergy();
-					xTotalUnc += pow(Event->GetStripHit(i)->GetEnergyResolution(),2);
-        }    
-        else {
-			    yTotalEnergy += Event->GetStripHit(i)->GetEnergy();
-					yTotalUnc += pow(Event->GetStripHit(i)->GetEnergyResolution(),2);
-        }
-			}
+    for (auto SH = Event->BeginStripHits(detector, true); SH != Event->EndStripHits(detector, true); ++SH){
+      xTotalEnergy += (*SH)->GetEnergy();
+			xTotalUnc += pow((*SH)->GetEnergyResolution(),2);
+		}
+    for (auto SH = Event->BeginStripHits(detector, false); SH != Event->EndStripHits(detector, false); ++SH){
+			yTotalEnergy += (*SH)->GetEnergy();
+			yTotalUnc += pow((*SH)->GetEnergyResolution(),2);
 		}
 
 		//check if initial n and p energy difference is high
 		xTotalUnc = sqrt(xTotalUnc);
 		yTotalUnc = sqrt(yTotalUnc);
 
-    for (unsigned int i=0; i<Event->GetNStripHits(); i++){
-      if (detector == Event->GetStripHit(i)->GetDetectorID()){
-        if (Event->GetStripHit(i)->IsXStrip() == true){
-          stripID = Event->GetStripHit(i)->GetStripID();
-          stripEnergy = Event->GetStripHit(i)->GetEnergy();
-          stripSigma = Event->GetStripHit(i)->GetEnergyResolution();
-          //make sure energy and error are NOT inf, 0, nan
-          if (stripEnergy!=0 && stripEnergy!=inf && !isnan(stripEnergy) && stripSigma!=0 && stripSigma!=inf && !isnan(stripSigma)){
-            xStripsHit.push_back(stripID);
-            xEnergy.push_back(stripEnergy);
-            xSigma.push_back(stripSigma);
-          }
-        }
-        else {
-          stripID = Event->GetStripHit(i)->GetStripID();
-          stripEnergy = Event->GetStripHit(i)->GetEnergy();
-          stripSigma = Event->GetStripHit(i)->GetEnergyResolution();
-          if (stripEnergy!=0 && stripEnergy!=inf && !isnan(stripEnergy) && stripSigma!=0 && stripSigma!=inf && !isnan(stripSigma)){
-            yStripsHit.push_back(stripID);
-            yEnergy.push_back(stripEnergy);
-            ySigma.push_back(stripSigma);
-        }
-        }
+    for (auto SH = Event->BeginStripHits(detector, true); SH != Event->EndStripHits(detector, true); ++SH){
+      stripID = (*SH)->GetStripID();
+      stripEnergy = (*SH)->GetEnergy();
+      stripSigma = (*SH)->GetEnergyResolution();
+      //make sure energy and error are NOT inf, 0, nan
+      if (stripEnergy!=0 && stripEnergy!=inf && !isnan(stripEnergy) && stripSigma!=0 && stripSigma!=inf && !isnan(stripSigma)){
+        xStripsHit.push_back(stripID);
+        xEnergy.push_back(stripEnergy);
+        xSigma.push_back(stripSigma);
       }
-    }	
+    }
+    for (auto SH = Event->BeginStripHits(detector, false); SH != Event->EndStripHits(detector, false); ++SH){
+      stripID = (*SH)->GetStripID();
+      stripEnergy = (*SH)->GetEnergy();
+      stripSigma = (*SH)->GetEnergyResolution();
+      if (stripEnergy!=0 && stripEnergy!=inf && !isnan(stripEnergy) && stripSigma!=0 && stripSigma!=inf && !isnan(stripSigma)){
+        yStripsHit.push_back(stripID);
+        yEnergy.push_back(stripEnergy);
+        ySigma.push_back(stripSigma);
+      }
+    }
 
     stripsHit.push_back(xStripsHit);
     stripsHit.push_back(yStripsHit);
@@ -676,7 +707,7 @@ void MModuleStripPairingGreedy::WriteHits(MReadOutAssembly* Event, int detector)
 
 	for (unsigned int pair=0; pair<decodedFinalPairs.size(); pair++) {
     addHit = false;
-		MHit* Hit = new MHit();
+		MHit* Hit = MObjectPool<MHit>::Get();
 		//x side
 		for (unsigned int strip=0; strip<decodedFinalPairs.at(pair)[0].size(); strip++){
 			for (unsigned int n = 0; n<Event->GetNStripHits(); n++){
@@ -729,7 +760,7 @@ void MModuleStripPairingGreedy::WriteHits(MReadOutAssembly* Event, int detector)
         Hit->SetChargeSharing(false);
       }
     } else {
-      delete Hit; 
+      MObjectPool<MHit>::Release(Hit);
     }
 
 
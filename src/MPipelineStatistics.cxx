@@ -0,0 +1,295 @@
+/*
+ * MPipelineStatistics.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MPipelineStatistics
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MPipelineStatistics.h"
+
+// Standard libs:
+#include <fstream>
+#include <iomanip>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MStreams.h"
+
+// Nuclearizer libs:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MPipelineStatistics)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+const unsigned int MPipelineStatistics::c_MergeIntervalMilliseconds;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MPipelineStatistics::MPipelineStatistics() : m_IsStopped(false)
+{
+  // Construct an instance of MPipelineStatistics
+
+  m_Start = chrono::steady_clock::now();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MPipelineStatistics::~MPipelineStatistics()
+{
+  // Delete this instance of MPipelineStatistics
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MPipelineStatistics::Initialize(const vector<MString>& Names)
+{
+  //! Reset everything and set up the module names - starts the wall clock
+
+  lock_guard<mutex> Lock(m_Mutex);
+
+  m_Modules.clear();
+  m_Modules.resize(Names.size());
+  for (unsigned int m = 0; m < Names.size(); ++m) {
+    m_Modules[m].SetName(Names[m]);
+  }
+
+  m_Start = chrono::steady_clock::now();
+  m_IsStopped = false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MPipelineStatistics::Stop()
+{
+  //! Stop the wall clock
+
+  lock_guard<mutex> Lock(m_Mutex);
+
+  m_Stop = chrono::steady_clock::now();
+  m_IsStopped = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MPipelineStatistics::SetNInstances(unsigned int m, unsigned int NInstances)
+{
+  //! Set the number of instances of module m
+
+  lock_guard<mutex> Lock(m_Mutex);
+
+  if (m < m_Modules.size()) {
+    m_Modules[m].SetNInstances(NInstances);
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MPipelineStatistics::Merge(unsigned int m, MModuleStatistics& Local)
+{
+  //! Merge the local counters of module m into the shared ones and clear them
+
+  if (Local.IsEmpty() == true) return;
+
+  {
+    lock_guard<mutex> Lock(m_Mutex);
+    if (m < m_Modules.size()) {
+      m_Modules[m].Merge(Local);
+    }
+  }
+  Local.Clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MPipelineStatistics::MergeIfDue(unsigned int m, MModuleStatistics& Local, chrono::steady_clock::time_point& LastMerge)
+{
+  //! Merge the local counters if the last merge (LastMerge, updated) is long enough ago
+
+  chrono::steady_clock::time_point Now = chrono::steady_clock::now();
+  if (Now - LastMerge >= chrono::milliseconds(c_MergeIntervalMilliseconds)) {
+    Merge(m, Local);
+    LastMerge = Now;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+vector<MModuleStatistics> MPipelineStatistics::GetSnapshot() const
+{
+  //! Return a copy of the current statistics of all modules
+
+  lock_guard<mutex> Lock(m_Mutex);
+
+  return m_Modules;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+double MPipelineStatistics::GetWallTime() const
+{
+  //! Return the wall-clock time since Initialize() (until Stop()) in seconds
+
+  lock_guard<mutex> Lock(m_Mutex);
+
+  chrono::steady_clock::time_point End = (m_IsStopped == true) ? m_Stop : chrono::steady_clock::now();
+  return chrono::duration<double>(End - m_Start).count();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MPipelineStatistics::WriteSummary(const MString& FileName) const
+{
+  //! Write the summary as JSON file
+
+  ofstream out;
+  out.open(FileName.Data());
+  if (out.is_open() == false) {
+    if (g_Verbosity >= c_Error) cout<<"Pipeline statistics: Error: Unable to open file "<<FileName<<endl;
+    return false;
+  }
+
+  out<<setprecision(9);
+  out<<"{"<<endl;
+  out<<"  \"WallTime\": "<<GetWallTime()<<","<<endl;
+  StreamModules(out, "  ");
+  out<<endl;
+  out<<"}"<<endl;
+
+  out.close();
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MPipelineStatistics::StreamModules(ostream& out, const MString& Indent) const
+{
+  //! Stream the "Modules" array of the JSON summary - without a final new line
+
+  vector<MModuleStatistics> Modules = GetSnapshot();
+  double WallTime = GetWallTime();
+
+  out<<Indent<<"\"Modules\": ["<<endl;
+  for (unsigned int m = 0; m < Modules.size(); ++m) {
+    const MModuleStatistics& S = Modules[m];
+
+    // Module names may contain quotes
+    MString Name = S.GetName();
+    Name.ReplaceAll("\\", "\\\\");
+    Name.ReplaceAll("\"", "\\\"");
+
+    out<<Indent<<"  {"<<endl;
+    out<<Indent<<"    \"Name\": \""<<Name<<"\","<<endl;
+    out<<Indent<<"    \"Instances\": "<<S.GetNInstances()<<","<<endl;
+    out<<Indent<<"    \"Calls\": "<<S.GetNCalls()<<","<<endl;
+    out<<Indent<<"    \"EventsIn\": "<<S.GetNEventsIn()<<","<<endl;
+    out<<Indent<<"    \"EventsOut\": "<<S.GetNEventsOut()<<","<<endl;
+    out<<Indent<<"    \"EventsPerSecond\": "<<((WallTime > 0) ? S.GetNEventsIn()/WallTime : 0.0)<<","<<endl;
+    out<<Indent<<"    \"ProcessingTime\": "<<1E-9*S.GetProcessingTime()<<","<<endl;
+    out<<Indent<<"    \"MeanTimePerEvent\": "<<1E-9*S.GetMeanTimePerEvent()<<","<<endl;
+    out<<Indent<<"    \"BlockedInIsReady\": "<<1E-9*S.GetBlockedTime()<<","<<endl;
+    out<<Indent<<"    \"InputQueueMean\": "<<S.GetMeanInputQueue()<<","<<endl;
+    out<<Indent<<"    \"InputQueueMax\": "<<S.GetMaxInputQueue()<<","<<endl;
+    out<<Indent<<"    \"ReorderBufferMean\": "<<S.GetMeanOutputQueue()<<","<<endl;
+    out<<Indent<<"    \"ReorderBufferMax\": "<<S.GetMaxOutputQueue()<<","<<endl;
+    out<<Indent<<"    \"TimePerEventHistogram\": {\"BinEdgesNanoseconds\": \"2^b\", \"Counts\": [";
+    for (unsigned int b = 0; b < MModuleStatistics::GetNHistogramBins(); ++b) {
+      if (b > 0) out<<", ";
+      out<<S.GetHistogramBin(b);
+    }
+    out<<"]}"<<endl;
+    out<<Indent<<"  }"<<((m + 1 < Modules.size()) ? "," : "")<<endl;
+  }
+  out<<Indent<<"]";
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MPipelineStatistics::StreamTable(ostream& out) const
+{
+  //! Stream a human-readable table with one line per module
+
+  vector<MModuleStatistics> Modules = GetSnapshot();
+  double WallTime = GetWallTime();
+
+  uint64_t TotalTime = 0;
+  for (const MModuleStatistics& S: Modules) {
+    TotalTime += S.GetProcessingTime();
+  }
+
+  ios_base::fmtflags Flags = out.flags();
+  streamsize Precision = out.precision();
+
+  out<<fixed<<setprecision(1);
+  out<<setw(40)<<left<<"Module"<<right<<setw(6)<<"Inst."<<setw(12)<<"Events in"<<setw(12)<<"Events/s"
+     <<setw(12)<<"us/event"<<setw(8)<<"Time %"<<setw(12)<<"Blocked s"<<setw(10)<<"Queue max"<<endl;
+  for (const MModuleStatistics& S: Modules) {
+    out<<setw(40)<<left<<S.GetName()<<right<<setw(6)<<S.GetNInstances()<<setw(12)<<S.GetNEventsIn()
+       <<setw(12)<<((WallTime > 0) ? S.GetNEventsIn()/WallTime : 0.0)
+       <<setw(12)<<1E-3*S.GetMeanTimePerEvent()
+       <<setw(8)<<((TotalTime > 0) ? 100.0*S.GetProcessingTime()/TotalTime : 0.0)
+       <<setw(12)<<setprecision(3)<<1E-9*S.GetBlockedTime()<<setprecision(1)
+       <<setw(10)<<S.GetMaxInputQueue()<<endl;
+  }
+  out<<setprecision(3)<<"Wall time: "<<WallTime<<" s"<<endl;
+
+  out.flags(Flags);
+  out.precision(Precision);
+}
+
+
+// MPipelineStatistics.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
@@ -28,12 +28,17 @@
 
 // Standard libs:
 #include <iomanip>
+#include <atomic>
+#include <mutex>
 using namespace std;
 
 // ROOT libs:
 
 // MEGAlib libs:
 
+// Nuclearizer libs:
+#include "MObjectPool.h"
+
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -63,36 +68,8 @@ MReadOutAssembly::MReadOutAssembly() : MReadOutSequence(), m_EventTimeUTC(0)
 
 MReadOutAssembly::~MReadOutAssembly()
 {
-  // Delete all strip hits
-  for (unsigned int h = 0; h < m_StripHits.size(); ++h) {
-    delete m_StripHits[h];
-  }
-  m_StripHits.clear();
-
-  // Delete all TOnly strip hits
-  for (unsigned int h = 0; h < m_StripHitsTOnly.size(); ++h) {
-    delete m_StripHitsTOnly[h];
-  }
-  m_StripHitsTOnly.clear();
-
-  // Delete all hits
-  for (unsigned int h = 0; h < m_Hits.size(); ++h) {
-    delete m_Hits[h];
-  }
-  m_Hits.clear();
-
-  // Delete all hits from simulation
-  for (unsigned int h = 0; h < m_HitsSim.size(); ++h) {
-    delete m_HitsSim[h];
-  }
-  m_HitsSim.clear();
-
-
-  // Delete all guardring hits
-  for (unsigned int h = 0; h < m_GuardringHits.size(); ++h) {
-    delete m_GuardringHits[h];
-  }
-  m_GuardringHits.clear();
+  // Hand all hits back to their pools
+  ReleaseHits();
 
   // Delete this instance of MReadOutAssembly
   delete m_PhysicalEvent;
@@ -120,80 +97,77 @@ void MReadOutAssembly::Clear()
   m_MJD = 0.0;
 
   m_Veto = false;
+  m_VetoGR0 = false;
+  m_VetoGR1 = false;
+  m_VetoShield = false;
   m_Trigger = true;
+  m_AspectGood = false;
+  m_EventQuality = 0;
+  m_AnalysisProgress = 0;
+  m_HasSimAspectInfo = false;
 
   for (int DetectorID = 0; DetectorID <= 11; DetectorID++) {
     m_InDetector[DetectorID] = false;
   }
 
-  // Delete all strip hits
+  // Hand all hits back to their pools
+  ReleaseHits();
+
+  m_QualityFlags = 0;
+
+  delete m_PhysicalEvent;
+  m_PhysicalEvent = 0;
+  
+  delete m_Aspect;
+  m_Aspect = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MReadOutAssembly::DeleteHits()
+{
+  for (unsigned int h = 0; h < m_Hits.size(); ++h) {
+    MObjectPool<MHit>::Release(m_Hits[h]);
+  }
+  m_Hits.clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MReadOutAssembly::ReleaseHits()
+{
+  //! Hand all strip hits, hits and guard ring hits back to their pools
+  // The vectors keep their capacity, thus a recycled event does not reallocate them
+
   for (unsigned int h = 0; h < m_StripHits.size(); ++h) {
-    delete m_StripHits[h];
+    MObjectPool<MStripHit>::Release(m_StripHits[h]);
   }
   m_StripHits.clear();
+  InvalidateStripHitIndex();
 
   for (unsigned int h = 0; h < m_StripHitsTOnly.size(); ++h) {
-    delete m_StripHitsTOnly[h];
+    MObjectPool<MStripHit>::Release(m_StripHitsTOnly[h]);
   }
   m_StripHitsTOnly.clear();
 
-  // Delete all hits
   for (unsigned int h = 0; h < m_Hits.size(); ++h) {
-    delete m_Hits[h];
+    MObjectPool<MHit>::Release(m_Hits[h]);
   }
   m_Hits.clear();
 
- // Delete all hits from simulation
   for (unsigned int h = 0; h < m_HitsSim.size(); ++h) {
-    delete m_HitsSim[h];
+    MObjectPool<MHit>::Release(m_HitsSim[h]);
   }
   m_HitsSim.clear();
 
-  // Delete all guardring hits
   for (unsigned int h = 0; h < m_GuardringHits.size(); ++h) {
-    delete m_GuardringHits[h];
+    MObjectPool<MGuardringHit>::Release(m_GuardringHits[h]);
   }
   m_GuardringHits.clear();
-
-  m_AspectIncomplete = false;
-  m_AspectIncompleteString = "";
-  m_TimeIncomplete = false;
-  m_TimeIncompleteString = "";
-  m_EnergyCalibrationIncomplete_BadStrip = false;
-  m_EnergyCalibrationIncomplete_BadStripString = "";
-  m_EnergyCalibrationIncomplete = false;
-  m_EnergyCalibrationIncompleteString = "";
-  m_EnergyResolutionCalibrationIncomplete = false;
-  m_EnergyResolutionCalibrationIncompleteString = "";
-  m_StripPairingIncomplete = false;
-  m_StripPairingIncompleteString = "";
-  m_LLDEvent = false;
-  m_LLDEventString = "";
-  m_DepthCalibrationIncomplete = false;
-  m_DepthCalibrationIncompleteString = "";
-  m_DepthCalibration_OutofRange = false;
-  m_DepthCalibration_OutofRangeString = ""; 
-
-  
-  m_FilteredOut = false;
-
-  delete m_PhysicalEvent;
-  m_PhysicalEvent = 0;
-  
-  delete m_Aspect;
-  m_Aspect = 0;
-}
-
-
-////////////////////////////////////////////////////////////////////////////////
-
-
-void MReadOutAssembly::DeleteHits()
-{
-  for (unsigned int h = 0; h < m_Hits.size(); ++h) {
-    delete m_Hits[h];
-  }
-  m_Hits.clear();
 }
 
 
@@ -252,6 +226,7 @@ void MReadOutAssembly::AddStripHit(MStripHit* StripHit)
     m_InDetector[DetectorID]=true;
   }
   m_StripHits.push_back(StripHit);
+  InvalidateStripHitIndex();
 }
 
 
@@ -265,7 +240,193 @@ void MReadOutAssembly::RemoveStripHit(unsigned int i)
     vector<MStripHit*>::iterator it;
     it = m_StripHits.begin()+i;
     m_StripHits.erase(it);
+    InvalidateStripHitIndex();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MReadOutAssembly::AddStripHits(vector<MStripHit*>::const_iterator Begin, vector<MStripHit*>::const_iterator End)
+{
+  //! Append a range of strip hits - this event takes over the ownership
+
+  for (vector<MStripHit*>::const_iterator I = Begin; I != End; ++I) {
+    int DetectorID = (*I)->GetDetectorID();
+    if ( (DetectorID>=0) && (DetectorID<=11) ) {
+      m_InDetector[DetectorID] = true;
+    }
+  }
+  m_StripHits.insert(m_StripHits.end(), Begin, End);
+  InvalidateStripHitIndex();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MReadOutAssembly::TakeStripHits(MReadOutAssembly* Other)
+{
+  //! Move all strip hits of the other event to the end of this event's list
+
+  if (Other == this || Other->m_StripHits.size() == 0) return;
+
+  if (m_StripHits.size() == 0) {
+    // Nothing to append to: just exchange the buffers
+    m_StripHits.swap(Other->m_StripHits);
+    for (int DetectorID = 0; DetectorID <= 11; ++DetectorID) {
+      m_InDetector[DetectorID] = Other->m_InDetector[DetectorID];
+    }
+  } else {
+    AddStripHits(Other->m_StripHits.begin(), Other->m_StripHits.end());
+  }
+
+  Other->m_StripHits.clear();
+  for (int DetectorID = 0; DetectorID <= 11; ++DetectorID) {
+    Other->m_InDetector[DetectorID] = false;
+  }
+  InvalidateStripHitIndex();
+  Other->InvalidateStripHitIndex();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MReadOutAssembly::SwapStripHits(MReadOutAssembly* Other)
+{
+  //! Swap the strip hit lists (and the detector occupancy) with the other event
+
+  m_StripHits.swap(Other->m_StripHits);
+  for (int DetectorID = 0; DetectorID <= 11; ++DetectorID) {
+    bool InDetector = m_InDetector[DetectorID];
+    m_InDetector[DetectorID] = Other->m_InDetector[DetectorID];
+    Other->m_InDetector[DetectorID] = InDetector;
+  }
+  InvalidateStripHitIndex();
+  Other->InvalidateStripHitIndex();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MReadOutAssembly::BuildStripHitIndex() const
+{
+  //! Build the (detector, side) strip hit index with one counting pass and one filling pass
+  //! Strip hits with a detector ID outside 0..11 end up in the last slot
+
+  if (m_StripHitIndexValid == true) return;
+
+  const unsigned int OtherSlot = c_NStripHitIndexSlots - 1;
+
+  unsigned int Counts[c_NStripHitIndexSlots];
+  for (unsigned int s = 0; s < c_NStripHitIndexSlots; ++s) Counts[s] = 0;
+
+  for (MStripHit* SH: m_StripHits) {
+    int DetectorID = SH->GetDetectorID();
+    if (DetectorID < 0 || DetectorID > 11) {
+      ++Counts[OtherSlot];
+    } else {
+      ++Counts[2*DetectorID + (SH->IsXStrip() == true ? 0 : 1)];
+    }
+  }
+
+  unsigned int Start = 0;
+  for (unsigned int s = 0; s < c_NStripHitIndexSlots; ++s) {
+    m_StripHitIndexStart[s] = Start;
+    Start += Counts[s];
+    Counts[s] = m_StripHitIndexStart[s];
+  }
+  m_StripHitIndexStart[c_NStripHitIndexSlots] = Start;
+
+  m_StripHitIndex.resize(m_StripHits.size());
+  for (MStripHit* SH: m_StripHits) {
+    int DetectorID = SH->GetDetectorID();
+    if (DetectorID < 0 || DetectorID > 11) {
+      m_StripHitIndex[Counts[OtherSlot]++] = SH;
+    } else {
+      m_StripHitIndex[Counts[2*DetectorID + (SH->IsXStrip() == true ? 0 : 1)]++] = SH;
+    }
+  }
+
+  m_StripHitIndexValid = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MStripHitArrays& MReadOutAssembly::LoadStripHitArrays(unsigned int Columns)
+{
+  //! Gather the given columns of the strip hits into the structure-of-arrays view and return it
+
+  BuildStripHitIndex();
+  m_StripHitArrays.Load(m_StripHitIndex, m_StripHitIndexStart, c_NStripHitIndexSlots, Columns);
+
+  return m_StripHitArrays;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+unsigned int MReadOutAssembly::GetNStripHits(int DetectorID, bool IsXStrip) const
+{
+  //! Return the number of strip hits on one side of a detector
+
+  if (DetectorID < 0 || DetectorID > 11) return 0;
+
+  BuildStripHitIndex();
+  unsigned int Slot = 2*DetectorID + (IsXStrip == true ? 0 : 1);
+
+  return m_StripHitIndexStart[Slot+1] - m_StripHitIndexStart[Slot];
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MStripHit* MReadOutAssembly::GetStripHit(int DetectorID, bool IsXStrip, unsigned int i) const
+{
+  //! Return strip hit i on one side of a detector
+
+  if (i < GetNStripHits(DetectorID, IsXStrip)) {
+    return m_StripHitIndex[m_StripHitIndexStart[2*DetectorID + (IsXStrip == true ? 0 : 1)] + i];
   }
+
+  merr<<"Index out of bounds!"<<show;
+
+  return 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+vector<MStripHit*>::const_iterator MReadOutAssembly::BeginStripHits(int DetectorID, bool IsXStrip) const
+{
+  //! Return the begin of the strip hits on one side of a detector
+
+  BuildStripHitIndex();
+  if (DetectorID < 0 || DetectorID > 11) return m_StripHitIndex.end();
+
+  return m_StripHitIndex.begin() + m_StripHitIndexStart[2*DetectorID + (IsXStrip == true ? 0 : 1)];
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+vector<MStripHit*>::const_iterator MReadOutAssembly::EndStripHits(int DetectorID, bool IsXStrip) const
+{
+  //! Return the end of the strip hits on one side of a detector
+
+  BuildStripHitIndex();
+  if (DetectorID < 0 || DetectorID > 11) return m_StripHitIndex.end();
+
+  return m_StripHitIndex.begin() + m_StripHitIndexStart[2*DetectorID + (IsXStrip == true ? 0 : 1) + 1];
 }
 
 
@@ -318,6 +479,59 @@ void MReadOutAssembly::RemoveStripHitTOnly(unsigned int i)
 ////////////////////////////////////////////////////////////////////////////////
 
 
+void MReadOutAssembly::TakeStripHitsTOnly(MReadOutAssembly* Other)
+{
+  //! Move all T Only strip hits of the other event to the end of this event's list
+
+  if (Other == this || Other->m_StripHitsTOnly.size() == 0) return;
+
+  if (m_StripHitsTOnly.size() == 0) {
+    m_StripHitsTOnly.swap(Other->m_StripHitsTOnly);
+  } else {
+    m_StripHitsTOnly.insert(m_StripHitsTOnly.end(), Other->m_StripHitsTOnly.begin(), Other->m_StripHitsTOnly.end());
+  }
+  Other->m_StripHitsTOnly.clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MGuardringHit* MReadOutAssembly::GetGuardringHit(unsigned int i) 
+{ 
+  //! Return guardring hit i
+
+  if (i < m_GuardringHits.size()) {
+    return m_GuardringHits[i];
+  }
+
+  merr<<"Index out of bounds!"<<show;
+
+  return 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MReadOutAssembly::TakeGuardringHits(MReadOutAssembly* Other)
+{
+  //! Move all guardring hits of the other event to the end of this event's list
+
+  if (Other == this || Other->m_GuardringHits.size() == 0) return;
+
+  if (m_GuardringHits.size() == 0) {
+    m_GuardringHits.swap(Other->m_GuardringHits);
+  } else {
+    m_GuardringHits.insert(m_GuardringHits.end(), Other->m_GuardringHits.begin(), Other->m_GuardringHits.end());
+  }
+  Other->m_GuardringHits.clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
 MHit* MReadOutAssembly::GetHit(unsigned int i) 
 { 
   //! Return hit i
@@ -361,11 +575,12 @@ bool MReadOutAssembly::Parse(MString& Line, int Version)
   */
   // skipping aspect for now
   if (Line.BeginsWith("HT")) {
-    MHit* h = new MHit();
+    MHit* h = MObjectPool<MHit>::Get();
     if( h->Parse(Line,1) ){
       AddHit(h);
       return true;
     } else {
+      MObjectPool<MHit>::Release(h);
       return false;
     }
   }
@@ -388,7 +603,7 @@ bool MReadOutAssembly::Parse(MString& Line, int Version)
   if (Line.BeginsWith("BD")) {
     // set a bad flag
     // too lazy RN to go thru each flag.  the following should do::
-    m_FilteredOut = true;
+    SetFilteredOut(true);
     return true;
   }
 
@@ -426,11 +641,11 @@ bool MReadOutAssembly::GetNextFromDatFile(MFile &F){
 			T.Set(Line);
 			SetTime( T );
 		} else if( Line.BeginsWith("HT") ){
-			MHit* h = new MHit();
+			MHit* h = MObjectPool<MHit>::Get();
 			h->Parse(Line);
 			AddHit(h);
 		} else if( Line.BeginsWith("SH") ){
-			MStripHit* sh = new MStripHit();
+			MStripHit* sh = MObjectPool<MStripHit>::Get();
 			sh->Parse(Line);
 			AddStripHit(sh);
 			if( m_Hits.size() > 0 ){
@@ -489,51 +704,7 @@ bool MReadOutAssembly::StreamDat(ostream& S, int Version)
     }
   }
 
-  if (m_AspectIncomplete == true) {
-    S<<"BD AspectIncomplete";
-    if (m_AspectIncompleteString != "") S<<" ("<<m_AspectIncompleteString<<")";
-    S<<endl;
-  }
-  if (m_TimeIncomplete == true) {
-    S<<"BD TimeIncomplete";
-    if (m_TimeIncompleteString != "") S<<" ("<<m_TimeIncompleteString<<")";
-    S<<endl;
-  }
-  if (m_EnergyCalibrationIncomplete_BadStrip == true) {
-    S<<"BD EnergyCalibrationIncomplete_BadStrip";
-    if (m_EnergyCalibrationIncomplete_BadStripString != "") S<<" ("<<m_EnergyCalibrationIncomplete_BadStripString<<")";
-    S<<endl;
-  }
-  if (m_EnergyCalibrationIncomplete == true) {
-    S<<"BD EnergyCalibrationIncomplete";
-    if (m_EnergyCalibrationIncompleteString != "") S<<" ("<<m_EnergyCalibrationIncompleteString<<")";
-    S<<endl;
-  }
-  if (m_EnergyResolutionCalibrationIncomplete == true) {
-    S<<"BD EnergyResolutionCalibrationIncomplete";
-    if (m_EnergyResolutionCalibrationIncompleteString != "") S<<" ("<<m_EnergyResolutionCalibrationIncompleteString<<")";
-    S<<endl;
-  }
-  if (m_StripPairingIncomplete == true) {
-    S<<"BD StripPairingIncomplete";
-    if (m_StripPairingIncompleteString != "") S<<" ("<<m_StripPairingIncompleteString<<")";
-    S<<endl;
-  }
-  if (m_LLDEvent == true) {
-    S<<"BD LLDEvent";
-    if (m_LLDEventString != "") S<<" ("<<m_LLDEventString<<")";
-    S<<endl;
-  }
-  if (m_DepthCalibrationIncomplete == true) {
-    S<<"BD DepthCalibrationIncomplete";
-    if (m_DepthCalibrationIncompleteString != "") S<<" ("<<m_DepthCalibrationIncompleteString<<")";
-    S<<endl;
-  }
-  if (m_DepthCalibration_OutofRange == true) {
-    S<<"BD DepthCalibration_OutofRange";
-    if (m_DepthCalibration_OutofRangeString != "") S<<" ("<<m_DepthCalibration_OutofRangeString<<")";
-    S<<endl;
-  }
+  StreamQualityFlags(S, c_QualityBad);
 
 
   
@@ -572,51 +743,7 @@ void MReadOutAssembly::StreamEvta(ostream& S)
   
   S<<"CC NStripHits "<<m_StripHits.size()<<endl;
   
-  if (m_AspectIncomplete == true) {
-    S<<"BD AspectIncomplete";
-    if (m_AspectIncompleteString != "") S<<" ("<<m_AspectIncompleteString<<")";
-    S<<endl;
-  }
-  if (m_TimeIncomplete == true) {
-    S<<"BD TimeIncomplete";
-    if (m_TimeIncompleteString != "") S<<" ("<<m_TimeIncompleteString<<")";
-    S<<endl;
-  }
-  if (m_EnergyCalibrationIncomplete_BadStrip == true) {
-    S<<"BD EnergyCalibrationIncomplete_BadStrip";
-    if (m_EnergyCalibrationIncomplete_BadStripString != "") S<<" ("<<m_EnergyCalibrationIncomplete_BadStripString<<")";
-    S<<endl;
-  }
-  if (m_EnergyCalibrationIncomplete == true) {
-    S<<"BD EnergyCalibrationIncomplete";
-    if (m_EnergyCalibrationIncompleteString != "") S<<" ("<<m_EnergyCalibrationIncompleteString<<")";
-    S<<endl;
-  }
-  if (m_EnergyResolutionCalibrationIncomplete == true) {
-    S<<"BD EnergyResolutionCalibrationIncomplete";
-    if (m_EnergyResolutionCalibrationIncompleteString != "") S<<" ("<<m_EnergyResolutionCalibrationIncompleteString<<")";
-    S<<endl;
-  }
-  if (m_StripPairingIncomplete == true) {
-    S<<"BD StripPairingIncomplete";
-    if (m_StripPairingIncompleteString != "") S<<" ("<<m_StripPairingIncompleteString<<")";
-    S<<endl;
-  }
-  if (m_LLDEvent == true) {
-    S<<"BD LLDEvent";
-    if (m_LLDEventString != "") S<<" ("<<m_LLDEventString<<")";
-    S<<endl;
-  }
-  if (m_DepthCalibrationIncomplete == true) {
-    S<<"BD DepthCalibrationIncomplete";
-    if (m_DepthCalibrationIncompleteString != "") S<<" ("<<m_DepthCalibrationIncompleteString<<")";
-    S<<endl;
-  }
-  if (m_DepthCalibration_OutofRange == true) { 
-    S<<"BD DepthCalibration_OutofRange";
-    if (m_DepthCalibration_OutofRangeString != "") S<<" ("<<m_DepthCalibration_OutofRangeString<<")";
-    S<<endl;
-  }
+  StreamQualityFlags(S, c_QualityBad);
 }
 
 
@@ -645,63 +772,167 @@ void MReadOutAssembly::StreamRoa(ostream& S, bool)
   }
   
   // Those are the only BD's relevant for the roa format
-  if (m_AspectIncomplete == true) {
-    S<<"BD AspectIncomplete";
-    if (m_AspectIncompleteString != "") S<<" ("<<m_AspectIncompleteString<<")";
-    S<<endl;
+  StreamQualityFlags(S, c_QualityAspectIncomplete | c_QualityTimeIncomplete);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MReadOutAssembly::SetQualityFlag(uint64_t Flag, bool Set, const MString& Text)
+{
+  //! Set or unset a quality flag and store the reason
+  //! This interns the text under a lock - per-event callers should intern once and use the code version
+
+  SetQualityFlag(Flag, Set, (Set == true) ? InternQualityReason(Text) : uint16_t(0));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MReadOutAssembly::SetQualityFlag(uint64_t Flag, bool Set, uint16_t ReasonCode)
+{
+  //! Set or unset a quality flag and store the interned reason code
+
+  if (Set == true) {
+    m_QualityFlags |= Flag;
+    for (unsigned int i = 0; i < c_NQualityFlags; ++i) {
+      if ((Flag & (uint64_t(1) << i)) != 0) {
+        m_QualityReasons[i] = ReasonCode;
+      }
+    }
+  } else {
+    m_QualityFlags &= ~Flag;
   }
-  if (m_TimeIncomplete == true) {
-    S<<"BD TimeIncomplete";
-    if (m_TimeIncompleteString != "") S<<" ("<<m_TimeIncompleteString<<")";
-    S<<endl;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MString MReadOutAssembly::GetQualityReason(uint64_t Flag) const
+{
+  //! Return the reason given for the flag (empty if none was given)
+
+  for (unsigned int i = 0; i < c_NQualityFlags; ++i) {
+    if ((Flag & (uint64_t(1) << i)) != 0 && (m_QualityFlags & (uint64_t(1) << i)) != 0) {
+      return GetQualityReasonText(m_QualityReasons[i]);
+    }
   }
+
+  return "";
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////
 
 
-bool MReadOutAssembly::IsGood() const
+//! The maximum number of different interned quality reasons
+static const unsigned int c_MaxQualityReasons = 1024;
+
+//! The interned quality reason texts - the code is the index, 0 is the empty text
+//! Entries are written once before they are published via the count, thus reading needs no lock
+static MString* QualityReasonTexts()
 {
-  //! Returns true if none of the "bad" or "incomplete" falgs has been set
+  static MString* Texts = new MString[c_MaxQualityReasons];
+  return Texts;
+}
 
-  if (m_AspectIncomplete == true) return false;
-  if (m_TimeIncomplete == true) return false;
-  if (m_EnergyCalibrationIncomplete_BadStrip == true) return false;
-  if (m_EnergyCalibrationIncomplete == true) return false;
-  if (m_EnergyResolutionCalibrationIncomplete == true) return false;
-  if (m_StripPairingIncomplete == true) return false;
-  if (m_LLDEvent == true) return false;
-  if (m_DepthCalibrationIncomplete == true) return false;
-  if (m_DepthCalibration_OutofRange == true) return false;
+//! The number of published quality reason texts
+static atomic<unsigned int>& QualityReasonCount()
+{
+  static atomic<unsigned int>* Count = new atomic<unsigned int>(1);
+  return *Count;
+}
 
+//! The mutex serializing the interning of new quality reasons
+static mutex& QualityReasonMutex()
+{
+  static mutex* Mutex = new mutex();
+  return *Mutex;
+}
 
-  if (m_FilteredOut == true) return false;
-  
-  return true;
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+uint16_t MReadOutAssembly::InternQualityReason(const MString& Text)
+{
+  //! Return the code of an interned quality reason text
+  //! The reasons are a handful of static strings, thus the table stays tiny
+  //! Modules should call this once at construction and store the code
+
+  if (Text.Length() == 0) return 0;
+
+  lock_guard<mutex> Lock(QualityReasonMutex());
+  MString* Texts = QualityReasonTexts();
+  unsigned int Count = QualityReasonCount().load(memory_order_relaxed);
+  for (unsigned int c = 1; c < Count; ++c) {
+    if (Texts[c] == Text) return c;
+  }
+
+  if (Count >= c_MaxQualityReasons) {
+    merr<<"Too many different quality reasons - ignoring: "<<Text<<show;
+    return 0;
+  }
+  Texts[Count] = Text;
+  QualityReasonCount().store(Count + 1, memory_order_release);
+
+  return Count;
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////
 
 
-bool MReadOutAssembly::IsBad() const
+MString MReadOutAssembly::GetQualityReasonText(uint16_t Code)
 {
-  //! Returns true if none of the "bad" or "incomplete" falgs has been set
+  //! Return the text belonging to an interned quality reason code - lock-free
 
-  if (m_AspectIncomplete == true) return true;
-  if (m_TimeIncomplete == true) return true;
-  if (m_EnergyCalibrationIncomplete_BadStrip == true) return true;
-  if (m_EnergyCalibrationIncomplete == true) return true;
-  if (m_EnergyResolutionCalibrationIncomplete == true) return true;
-  if (m_StripPairingIncomplete == true) return true;
-  if (m_LLDEvent == true) return true;
-  if (m_DepthCalibrationIncomplete == true) return true;
-  if (m_DepthCalibration_OutofRange == true) return true;
+  if (Code == 0) return "";
+  if (Code >= QualityReasonCount().load(memory_order_acquire)) return "";
 
-  return false;
+  return QualityReasonTexts()[Code];
 }
-  
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MReadOutAssembly::StreamQualityFlags(ostream& S, uint64_t Mask) const
+{
+  //! Stream the "BD" lines of all set quality flags contained in the mask
+
+  static const char* Names[c_NQualityFlags] = {
+    "AspectIncomplete",
+    "TimeIncomplete",
+    "EnergyCalibrationIncomplete_BadStrip",
+    "EnergyCalibrationIncomplete",
+    "EnergyResolutionCalibrationIncomplete",
+    "StripPairingIncomplete",
+    "LLDEvent",
+    "DepthCalibrationIncomplete",
+    "DepthCalibration_OutofRange",
+    "FilteredOut"
+  };
+
+  uint64_t Flags = m_QualityFlags & Mask;
+  if (Flags == 0) return;
+
+  for (unsigned int i = 0; i < c_NQualityFlags; ++i) {
+    if ((Flags & (uint64_t(1) << i)) != 0) {
+      S<<"BD "<<Names[i];
+      if (m_QualityReasons[i] != 0) S<<" ("<<GetQualityReasonText(m_QualityReasons[i])<<")";
+      S<<endl;
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
 bool MReadOutAssembly::ComputeAbsoluteTime()
 {
 
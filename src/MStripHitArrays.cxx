@@ -0,0 +1,199 @@
+/*
+ * MStripHitArrays.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MStripHitArrays
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MStripHitArrays.h"
+
+// Standard libs:
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MStreams.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MStripHitArrays)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MStripHitArrays::MStripHitArrays()
+{
+  // Construct an instance of MStripHitArrays
+
+  Clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MStripHitArrays::~MStripHitArrays()
+{
+  // Delete this instance of MStripHitArrays - the strip hits are not owned
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripHitArrays::Clear()
+{
+  //! Reset all data - the arrays keep their capacity
+
+  m_StripHits.clear();
+  m_SlotStart.clear();
+  m_Columns = 0;
+
+  m_DetectorIDs.clear();
+  m_StripIDs.clear();
+  m_IsXStrips.clear();
+  m_ADCUnits.clear();
+  m_Timings.clear();
+  m_Energies.clear();
+  m_EnergyResolutions.clear();
+  m_PreampTemps.clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripHitArrays::Load(const vector<MStripHit*>& StripHits, const unsigned int* SlotStart, unsigned int NSlots, unsigned int Columns)
+{
+  //! Gather the given columns from the strip hits - one pass per column
+
+  m_StripHits.assign(StripHits.begin(), StripHits.end());
+  m_SlotStart.assign(SlotStart, SlotStart + NSlots + 1);
+  m_Columns = Columns;
+
+  unsigned int N = m_StripHits.size();
+  m_DetectorIDs.resize((Columns & c_ColumnIDs) != 0 ? N : 0);
+  m_StripIDs.resize((Columns & c_ColumnIDs) != 0 ? N : 0);
+  m_IsXStrips.resize((Columns & c_ColumnIDs) != 0 ? N : 0);
+  m_ADCUnits.resize((Columns & c_ColumnADCUnits) != 0 ? N : 0);
+  m_Timings.resize((Columns & c_ColumnTimings) != 0 ? N : 0);
+  m_Energies.resize((Columns & c_ColumnEnergies) != 0 ? N : 0);
+  m_EnergyResolutions.resize((Columns & c_ColumnEnergyResolutions) != 0 ? N : 0);
+  m_PreampTemps.resize((Columns & c_ColumnPreampTemps) != 0 ? N : 0);
+
+  if ((Columns & c_ColumnIDs) != 0) {
+    for (unsigned int i = 0; i < N; ++i) {
+      const MStripHit* SH = m_StripHits[i];
+      m_DetectorIDs[i] = SH->GetDetectorID();
+      m_StripIDs[i] = SH->GetStripID();
+      m_IsXStrips[i] = (SH->IsXStrip() == true) ? 1 : 0;
+    }
+  }
+  if ((Columns & c_ColumnADCUnits) != 0) {
+    for (unsigned int i = 0; i < N; ++i) m_ADCUnits[i] = m_StripHits[i]->GetADCUnits();
+  }
+  if ((Columns & c_ColumnTimings) != 0) {
+    for (unsigned int i = 0; i < N; ++i) m_Timings[i] = m_StripHits[i]->GetTiming();
+  }
+  if ((Columns & c_ColumnEnergies) != 0) {
+    for (unsigned int i = 0; i < N; ++i) m_Energies[i] = m_StripHits[i]->GetEnergy();
+  }
+  if ((Columns & c_ColumnEnergyResolutions) != 0) {
+    for (unsigned int i = 0; i < N; ++i) m_EnergyResolutions[i] = m_StripHits[i]->GetEnergyResolution();
+  }
+  if ((Columns & c_ColumnPreampTemps) != 0) {
+    for (unsigned int i = 0; i < N; ++i) m_PreampTemps[i] = m_StripHits[i]->GetPreampTemp();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripHitArrays::Store() const
+{
+  //! Write the loaded modifiable values back to the strip hits
+
+  unsigned int N = m_StripHits.size();
+  if ((m_Columns & c_ColumnADCUnits) != 0) {
+    for (unsigned int i = 0; i < N; ++i) m_StripHits[i]->SetADCUnits(m_ADCUnits[i]);
+  }
+  if ((m_Columns & c_ColumnTimings) != 0) {
+    for (unsigned int i = 0; i < N; ++i) m_StripHits[i]->SetTiming(m_Timings[i]);
+  }
+  if ((m_Columns & c_ColumnEnergies) != 0) {
+    for (unsigned int i = 0; i < N; ++i) m_StripHits[i]->SetEnergy(m_Energies[i]);
+  }
+  if ((m_Columns & c_ColumnEnergyResolutions) != 0) {
+    for (unsigned int i = 0; i < N; ++i) m_StripHits[i]->SetEnergyResolution(m_EnergyResolutions[i]);
+  }
+  if ((m_Columns & c_ColumnPreampTemps) != 0) {
+    for (unsigned int i = 0; i < N; ++i) m_StripHits[i]->SetPreampTemp(m_PreampTemps[i]);
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+unsigned int MStripHitArrays::GetSlot(int DetectorID, bool IsXStrip) const
+{
+  //! Return the slot of one side of a detector - the layout is the one of the MReadOutAssembly strip hit index
+
+  return 2*DetectorID + (IsXStrip == true ? 0 : 1);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+unsigned int MStripHitArrays::GetBegin(int DetectorID, bool IsXStrip) const
+{
+  //! Return the first element of one side of a detector
+
+  if (DetectorID < 0 || DetectorID > 11 || GetSlot(DetectorID, IsXStrip) + 1 >= m_SlotStart.size()) return GetSize();
+
+  return m_SlotStart[GetSlot(DetectorID, IsXStrip)];
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+unsigned int MStripHitArrays::GetEnd(int DetectorID, bool IsXStrip) const
+{
+  //! Return the element after the last one of one side of a detector
+
+  if (DetectorID < 0 || DetectorID > 11 || GetSlot(DetectorID, IsXStrip) + 1 >= m_SlotStart.size()) return GetSize();
+
+  return m_SlotStart[GetSlot(DetectorID, IsXStrip) + 1];
+}
+
+
+// MStripHitArrays.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
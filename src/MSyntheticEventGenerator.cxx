@@ -0,0 +1,189 @@
+/*
+ * MSyntheticEventGenerator.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MSyntheticEventGenerator
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MSyntheticEventGenerator.h"
+
+// Standard libs:
+#include <cmath>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MTime.h"
+
+// Nuclearizer libs:
+#include "MStripHit.h"
+#include "MObjectPool.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MSyntheticEventGenerator)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MSyntheticEventGenerator::MSyntheticEventGenerator() : m_Random(20170912)
+{
+  // Construct an instance of MSyntheticEventGenerator
+
+  m_Multiplicity = 2;
+  m_ChargeSharingProbability = 0.1;
+  for (int d = 0; d < 12; ++d) {
+    m_Detectors.push_back(d);
+  }
+  m_NStrips = 37;
+
+  m_EventRate = 1000.0;
+  m_DriftTime = 300.0;
+  m_TimingNoise = 10.0;
+
+  m_LineEnergy = 662.0;
+  m_LineFraction = 0.3;
+  m_ContinuumMin = 50.0;
+  m_ContinuumMax = 2000.0;
+  m_EnergyResolution = 1.5;
+
+  m_ADCOffset = 100.0;
+  m_ADCGain = 4.0;
+
+  m_NextID = 1;
+  m_Time = 0.0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MSyntheticEventGenerator::~MSyntheticEventGenerator()
+{
+  // Delete this instance of MSyntheticEventGenerator
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MSyntheticEventGenerator::SetSpectrum(double LineEnergy, double LineFraction, double ContinuumMin, double ContinuumMax)
+{
+  //! Set the line energy, the fraction of events in the line, and the continuum range (all energies in keV)
+
+  m_LineEnergy = LineEnergy;
+  m_LineFraction = LineFraction;
+  m_ContinuumMin = ContinuumMin;
+  m_ContinuumMax = (ContinuumMax > ContinuumMin) ? ContinuumMax : ContinuumMin + 1.0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MSyntheticEventGenerator::Generate(MReadOutAssembly* Event)
+{
+  //! Fill the (cleared) event with the next synthetic event
+
+  Event->SetID(m_NextID++);
+
+  m_Time += m_Random.Exp(1.0/m_EventRate);
+  double Seconds = floor(m_Time);
+  MTime Time((long int) Seconds, (long int) (1E9*(m_Time - Seconds)));
+  Event->SetTime(Time);
+
+  // The total energy is split randomly among the interactions
+  double TotalEnergy = (m_Random.Rndm() < m_LineFraction) ? m_LineEnergy : m_Random.Uniform(m_ContinuumMin, m_ContinuumMax);
+
+  vector<double> Fractions(m_Multiplicity);
+  double Sum = 0.0;
+  for (unsigned int i = 0; i < m_Multiplicity; ++i) {
+    Fractions[i] = m_Random.Uniform(0.1, 1.0);
+    Sum += Fractions[i];
+  }
+
+  for (unsigned int i = 0; i < m_Multiplicity; ++i) {
+    double Energy = TotalEnergy*Fractions[i]/Sum;
+
+    int DetectorID = m_Detectors[m_Random.Integer(m_Detectors.size())];
+    // Strip IDs start at 1
+    int XStrip = 1 + m_Random.Integer(m_NStrips);
+    int YStrip = 1 + m_Random.Integer(m_NStrips);
+
+    // Linear drift model: the electrons and holes drift to opposite sides
+    double Depth = m_Random.Rndm();
+    double XTiming = 200.0 + Depth*m_DriftTime + m_Random.Gaus(0, m_TimingNoise);
+    double YTiming = 200.0 + (1.0 - Depth)*m_DriftTime + m_Random.Gaus(0, m_TimingNoise);
+
+    for (unsigned int s = 0; s <= 1; ++s) {
+      bool IsXStrip = (s == 0);
+      int StripID = IsXStrip ? XStrip : YStrip;
+      double Timing = IsXStrip ? XTiming : YTiming;
+      double StripEnergy = Energy;
+
+      if (m_Random.Rndm() < m_ChargeSharingProbability) {
+        int Neighbor = (StripID == 1 || (StripID < int(m_NStrips) && m_Random.Rndm() < 0.5)) ? StripID + 1 : StripID - 1;
+        double Shared = StripEnergy*m_Random.Uniform(0.05, 0.5);
+        StripEnergy -= Shared;
+        AddStripHit(Event, DetectorID, Neighbor, IsXStrip, Shared, Timing + m_Random.Gaus(0, m_TimingNoise));
+      }
+
+      AddStripHit(Event, DetectorID, StripID, IsXStrip, StripEnergy, Timing);
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MSyntheticEventGenerator::AddStripHit(MReadOutAssembly* Event, int DetectorID, int StripID, bool IsXStrip, double Energy, double Timing)
+{
+  //! Add one strip hit to the event
+
+  double MeasuredEnergy = Energy + m_Random.Gaus(0, m_EnergyResolution);
+  if (MeasuredEnergy < 0) MeasuredEnergy = 0;
+
+  MStripHit* SH = MObjectPool<MStripHit>::Get();
+  SH->SetDetectorID(DetectorID);
+  SH->SetStripID(StripID);
+  SH->IsXStrip(IsXStrip);
+  SH->HasTriggered(true);
+  SH->SetADCUnits(floor(m_ADCOffset + m_ADCGain*MeasuredEnergy));
+  SH->SetEnergy(MeasuredEnergy);
+  SH->SetEnergyResolution(m_EnergyResolution);
+  // The timing is digitized in steps of 5 ns
+  SH->SetTiming(5.0*floor((Timing > 0 ? Timing : 0)/5.0));
+  SH->SetPreampTemp(20);
+
+  Event->AddStripHit(SH);
+}
+
+
+// MSyntheticEventGenerator.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////